@@ -1,18 +1,35 @@
 #pragma once
 #include "pass_bits/problem.hpp"
 #include "pass_bits/optimiser.hpp"
+#include "pass_bits/optimiser/parallel_swarm_search.hpp"
+#include <vector> // std::vector
 
 namespace pass
 {
 /**
  * Search the best parameters for the parallel swarm search algorithm
- * and saves the parameters in a file which can be than loaded.
+ * and stores them in the parameter registry of this host, from where they
+ * are loaded by `parallel_swarm_search::load_profile`. Nothing is done if
+ * the problem was already tuned in this dimension.
  *
- * Following parameter of the parallel swarm search are investigated:
+ * Following parameter of the parallel swarm search are tuned jointly:
  * - Swarm Size
  * - Neighbourhood Probability
  * - Inertia
- * - Cognitive Acceleration = Social Acceleration
+ * - Cognitive Acceleration
+ * - Social Acceleration
+ *
+ * Steps:
+ * 1. Evaluate the default, the prediction from other dimensions (see
+ *    `parameter_registry::predict`) and random configurations, 10 in total
+ * 2. Fit a Gaussian process to the results (scored with `compare_segments`)
+ *    and evaluate the batch of configurations with the highest expected
+ *    improvement, until 40 configurations are evaluated
+ * 3. Race the 4 best configurations against the default (see `race_parameters`)
+ *
+ * Configurations are evaluated in parallel (see `parameter_evaluate`). The
+ * search stops early once `pass::parameter_setting_maximal_duration` is
+ * exceeded.
  *
  * @parameters
  * - problem: the given problem
@@ -29,6 +46,45 @@ void search_parameters(const pass::problem &problem, const bool benchmark);
  */
 arma::mat parameter_evaluate(pass::optimiser &optimiser, const pass::problem &problems);
 
+/**
+ * Evaluates each of the `configurations` `runs` times, in the format of
+ * `parameter_evaluate` above.
+ *
+ * The runs are distributed over all MPI ranks and threads, each run
+ * optimising on its own (single thread, no migrations) for at most
+ * `maximal_duration`.
+ *
+ * Must be called by all MPI ranks with the same configurations.
+ */
+std::vector<arma::mat> parameter_evaluate(const std::vector<pass::parallel_swarm_search> &configurations,
+                                          const pass::problem &problem,
+                                          const arma::uword runs,
+                                          const std::chrono::nanoseconds maximal_duration);
+
+/**
+ * Races the `configurations` against each other (F-Race) and returns the
+ * index of the best one.
+ *
+ * In every round, each remaining configuration is run a few more times (see
+ * `parameter_evaluate`). After 5 runs, configurations that
+ * are significantly worse than the best one according to the Friedman test
+ * are dropped. Runs are ranked by success, then evaluations, then fitness
+ * value.
+ *
+ * The race ends when one configuration is left, the remaining ones have
+ * been run `pass::parameter_setting_number_of_runs` times or
+ * `maximal_duration` is exceeded.
+ *
+ * `runtimes` is set to the runs of each configuration, in the format of
+ * `parameter_evaluate`. Dropped configurations have fewer runs.
+ *
+ * Must be called by all MPI ranks with the same configurations.
+ */
+arma::uword race_parameters(const std::vector<pass::parallel_swarm_search> &configurations,
+                            const pass::problem &problem,
+                            const std::chrono::nanoseconds maximal_duration,
+                            std::vector<arma::mat> &runtimes);
+
 /**
  * Compare the two segments with each other.
  *
@@ -0,0 +1,52 @@
+#pragma once
+#include "pass_bits/problem.hpp"
+
+namespace pass
+{
+/**
+ * Evaluation times and objective differences of `problem::evaluate` and
+ * `problem::evaluate_low_fidelity`, as returned by `pass::fidelity_comparison`.
+ */
+struct fidelity_comparison_result
+{
+  /**
+   * The mean evaluation time of `evaluate`, in nanoseconds.
+   */
+  double high_fidelity_time;
+
+  /**
+   * The mean evaluation time of `evaluate_low_fidelity`, in nanoseconds.
+   */
+  double low_fidelity_time;
+
+  /**
+   * The largest difference of the objective values over all agents where
+   * both are finite, relative to the absolute value of `evaluate`, but at
+   * least 1.
+   */
+  double maximal_difference;
+
+  /**
+   * Like `maximal_difference`, but only over the 10% of agents with the best
+   * objective values of `evaluate`.
+   */
+  double maximal_best_difference;
+
+  /**
+   * The number of agents with a finite objective value at only one fidelity.
+   */
+  arma::uword finiteness_mismatches;
+};
+
+/**
+ * Evaluates `number_of_agents` random agents with both fidelities of
+ * `problem` (see `problem::has_low_fidelity`). The times are the fastest of
+ * 9 passes over all agents, so that they are less affected by other
+ * processes than `pass::problem_evaluation_time`.
+ *
+ * See `pass::low_fidelity` for the results on the space missions.
+ */
+fidelity_comparison_result fidelity_comparison(const pass::problem &problem,
+                                               const arma::uword number_of_agents = 40000);
+
+} // namespace pass
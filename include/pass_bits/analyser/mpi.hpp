@@ -0,0 +1,86 @@
+#pragma once
+#include "pass_bits/problem.hpp"
+
+namespace pass
+{
+/**
+ * Recommended MPI setup of the parallel swarm search for a problem on this
+ * machine, as returned by `pass::enable_mpi`.
+ */
+struct mpi_recommendation
+{
+  /**
+   * The recommended `parallel_swarm_search::migration_stall`, i.e. the number
+   * of additional iterations between two migrations.
+   */
+  arma::uword migration_stall;
+
+  /**
+   * The recommended number of islands (MPI ranks) in total.
+   */
+  int number_of_islands;
+
+  /**
+   * The recommended number of MPI ranks per node.
+   */
+  int ranks_per_node;
+
+  /**
+   * The recommended number of OpenMP threads per MPI rank.
+   */
+  int threads_per_rank;
+
+  /**
+   * The measured duration of one migration (collective communication) in
+   * nanoseconds, scaled to `number_of_islands`.
+   */
+  double migration_time;
+
+  /**
+   * The predicted duration of one iteration in nanoseconds, using
+   * `threads_per_rank` threads.
+   */
+  double iteration_time;
+
+  /**
+   * The predicted fraction of the runtime spent on migrations.
+   */
+  double communication_fraction;
+};
+
+/**
+ * Analyses how the parallel swarm search should be distributed with MPI.
+ * Outputs are given through all the analyse process.
+ *
+ * Steps:
+ * 1. Estimate the evaluation time of your problem
+ * 2. Measure the duration of one migration between the current MPI ranks
+ * 3. Predict the duration of one iteration with the OpenMP model
+ * 4. Recommend the migration stall, the number of islands and the ratio of
+ *    MPI ranks to OpenMP threads, so that the migrations take at most
+ *    `maximal_communication_fraction` of the runtime.
+ *
+ * Must be called by all MPI ranks. The recommendation is saved in the
+ * per-host profile next to the OpenMP model (see `pass::profile_path`).
+ */
+mpi_recommendation enable_mpi(const pass::problem &problem, const double maximal_communication_fraction = 0.05);
+
+/**
+ * Returns the median duration in nanoseconds of one migration of the parallel
+ * swarm search between all MPI ranks, for agents with `dimension` elements.
+ * A migration consists of an `MPI_Allreduce` to find the best island and an
+ * `MPI_Bcast` of its agent.
+ *
+ * Must be called by all MPI ranks. Returns 0 if MPI is not supported.
+ */
+double migration_time(const arma::uword dimension);
+
+/**
+ * Returns the smallest migration stall such that migrations of
+ * `migration_time` nanoseconds take at most `maximal_communication_fraction`
+ * of the runtime, if an iteration takes `iteration_time` nanoseconds.
+ */
+arma::uword optimal_migration_stall(const double migration_time, const double iteration_time,
+                                    const double maximal_communication_fraction);
+
+} // namespace pass
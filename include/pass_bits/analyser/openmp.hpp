@@ -9,30 +9,83 @@ namespace pass
  *
  * Steps:
  * 1. Estimate the evaluation time of your problem
- * 2. Generate trainingsdata
- * 3. Test linear model if it fits
- * 4. Test polynomial model if it fitst
- * 5. Predict the speedup for your model
- * 6. Give suggestions if to activate openMP or not
+ * 2. Load the speedup model of this machine (calibrate it if it does not exist)
+ * 3. Predict the speedup for every number of threads
+ * 4. Give suggestions if to activate openMP and with how many threads
  *
  */
 bool enable_openmp(const pass::problem &problem);
 
+/**
+ * Returns the number of threads with the shortest predicted iteration time
+ * for a swarm of `swarm_size` particles on `problem`.
+ *
+ * Returns 1 if openMP is not supported or only one thread is available.
+ */
+int optimal_number_of_threads(const pass::problem &problem, const arma::uword swarm_size);
+
+/**
+ * Returns the speedup model of this machine.
+ *
+ * The model is loaded from the per-host profile (see `pass::profile_path`). If
+ * it does not exist, the machine is calibrated first and the model is saved.
+ */
+arma::rowvec openmp_model();
+
 /**
  * Machine Learning - Step 1.
  *
- * Collects trainingdata for the model.
- * Default: 120 trainingspoint are collected
- * The more data you collect (better data), the better the model performs.
+ * Collects trainingdata for the model by timing one iteration of a swarm of
+ * synthetic problems with different evaluation times and numbers of threads.
+ * `examples` is the number of different evaluation times, spread
+ * logarithmically between a few nanoseconds and a few hundred microseconds.
+ *
+ * Each column is one measurement:
+ * - first row -> evaluation time of the problem (ns)
+ * - second row -> number of threads
+ * - third row -> duration of one iteration (ns)
+ * - fourth row -> number of evaluations per iteration (swarm size)
  */
 arma::mat train(const int &examples);
 
 /**
  * Machine Learning - Step 2.
  *
- * Builds the model from the trainingdata.
- * Tests two models: linear and polynomial.
+ * Fits an Amdahl-style model to the trainingdata: The duration of one
+ * iteration with `t` threads is modeled as
+ *
+ *   T(t) = serial_overhead + ceil(swarm_size / t) * evaluation_time + thread_overhead * (t - 1)
+ *
+ * @return a rowvec
+ * first element -> thread_overhead (ns)
+ * second element -> serial_overhead (ns)
+ * third element -> r^2 of the fit
+ *
+ * The model is saved in the per-host profile.
  */
 arma::rowvec build_model(const arma::mat &training_points);
 
+/**
+ * Predicts the duration in nanoseconds of one iteration with `swarm_size`
+ * evaluations of `evaluation_time` nanoseconds each, using `threads` threads.
+ */
+double predict_iteration_time(const arma::rowvec &model, const double evaluation_time,
+                              const arma::uword swarm_size, const int threads);
+
+/**
+ * Predicts the speedup of `threads` threads compared to one thread.
+ */
+double predict_speedup(const arma::rowvec &model, const double evaluation_time,
+                       const arma::uword swarm_size, const int threads);
+
+/**
+ * Returns the number of threads in [1, `maximal_threads`] with the shortest
+ * predicted iteration time, up to a hysteresis of 5%: The threads are
+ * increased one by one, and a number of threads is only chosen if it is
+ * predicted to be more than 5% faster than the fewest threads chosen so far.
+ * This prefers fewer threads when more threads don't pay off noticeably.
+ */
+int optimal_number_of_threads(const arma::rowvec &model, const double evaluation_time,
+                              const arma::uword swarm_size, const int maximal_threads);
+
 } // namespace pass
@@ -5,6 +5,8 @@
 #define ARMA_USE_CXX11
 #include <armadillo>
 
+#include <chrono> // std::chrono
+
 // MPI support must be added via CMake, to ensure that we also link against it.
 // Therefore, CMake will decide whether SUPPORT_MPI is to be defined or not.
 #cmakedefine SUPPORT_MPI
@@ -49,6 +51,12 @@ namespace pass
   * Is initialized to `10`.
   */
   extern arma::uword parameter_setting_number_of_runs;
+  /**
+  * Global variables used for evaluations
+  * @parameter_setting_maximal_duration: wall-clock budget of a parameter search
+  * Is initialized to the maximal representable duration, i.e. no limit.
+  */
+  extern std::chrono::nanoseconds parameter_setting_maximal_duration;
 
   int thread_number();
   int number_of_threads();
@@ -19,16 +19,25 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// The functions templated on the scalar type are instantiated for double and
+// pass::gradient_dual (see pass_bits/helper/dual.hpp), so that the MGA and
+// MGA-DSM problems can be differentiated with dual numbers
+
 // Conversion from Mean Anomaly to Eccentric Anomaly via Kepler's equation
-double Mean2Eccentric(const double, const double);
+template <typename Scalar>
+Scalar Mean2Eccentric(const Scalar, const Scalar);
 
-void Conversion(const double *, double *, double *, const double);
+template <typename Scalar>
+void Conversion(const Scalar *, Scalar *, Scalar *, const double);
 
-double norm(const double *, const double *);
+template <typename Scalar>
+Scalar norm(const Scalar *, const Scalar *);
 
-double norm2(const double *);
+template <typename Scalar>
+Scalar norm2(const Scalar *);
 
-void vett(const double *, const double *, double *);
+template <typename Scalar>
+void vett(const Scalar *, const Scalar *, Scalar *);
 
 double asinh(double);
 
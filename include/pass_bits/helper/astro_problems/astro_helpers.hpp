@@ -1,6 +1,8 @@
 #pragma once
 
+#include "pass_bits/helper/dual.hpp"
 #include <array>   //std::array
+#include <cstddef> // std::size_t
 #include <utility> // std::pair
 
 namespace pass
@@ -13,11 +15,12 @@ typedef struct lambert_solution
 } lambert_solution;
 
 /**
- * This function is an adapted version of function `LambertI` in file
- * `./lambert.h`. For more details and documentation, please take a look at
- * the original file.
+ * Solves Lambert's problem with `pass::solve_lambert`; `lw` = 1 selects the
+ * long way. Prefer `pass::solve_lambert` in performance critical code, as it
+ * reports errors as codes.
  *
- * Throws `std::invalid_argument` if `t` is negative or zero.
+ * Throws `std::invalid_argument` if `t` is negative or zero. For other
+ * failures (e.g. collinear positions), the velocities are NaN.
  */
 lambert_solution lambert(std::array<double, 3> r1_in,
                          std::array<double, 3> r2_in, double t, const double mu,
@@ -42,8 +45,28 @@ std::pair<std::array<double, 3>, std::array<double, 3>> conversion(
     const std::array<double, 6> &E, const double mu);
 
 /**
- * This function is an adapted version of function `Mean2Eccentric` in file
- * `./astro_functions.h`.
+ * Solves Kepler's equation for the mean anomaly `m` and eccentricity `e`, like
+ * function `Mean2Eccentric` in file `./astro_functions.h`:
+ * - For `e` < 1, returns the eccentric anomaly E with `E - e sin(E) = m`.
+ * - For `e` >= 1, returns `atan(sinh(H))` with `e sinh(H) - H = m`.
+ *
+ * Instead of iterating until convergence, a close starting value is refined
+ * by a fixed number of fourth-order Householder steps (one for elliptic, two
+ * for hyperbolic orbits), which is accurate to a few ulps.
  */
 double mean_to_eccentric(const double m, const double e);
+
+/**
+ * Solves Kepler's equation for `n` pairs of mean anomalies `m` and
+ * eccentricities `e` (see above), writing the results to `eccentric_anomaly`.
+ */
+void mean_to_eccentric(const double *m, const double *e,
+                       double *eccentric_anomaly, const std::size_t n);
+
+/**
+ * Solves Kepler's equation like above, and computes the derivatives of the
+ * result by implicit differentiation of Kepler's equation at the solution, so
+ * the dual numbers don't pass through the Householder steps.
+ */
+gradient_dual mean_to_eccentric(const gradient_dual &m, const gradient_dual &e);
 } // namespace pass
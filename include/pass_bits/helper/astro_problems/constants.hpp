@@ -19,6 +19,11 @@ struct celestial_body
     static const celestial_body URANUS;
     static const celestial_body NEPTUNE;
 
+    /**
+     * Number of the body as used by `Planet_Ephemerides_Analytical`:
+     * 0 = sun, 1 = mercury, ..., 8 = neptune.
+     */
+    int id;
     double mu;
     double penalty;
     double penalty_coefficient;
@@ -30,7 +35,7 @@ struct celestial_body
         const double mjd2000) const;
 
   private:
-    celestial_body(double mu, double penalty,
+    celestial_body(int id, double mu, double penalty,
                    double penalty_coefficient) noexcept;
 };
 
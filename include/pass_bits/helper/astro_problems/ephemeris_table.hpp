@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>      // std::array
+#include <cstddef>    // std::size_t
+#include <functional> // std::function
+#include <utility>    // std::pair
+#include <vector>     // std::vector
+
+namespace pass
+{
+/**
+ * Precomputed ephemeris of one celestial object.
+ *
+ * The time span `[start, end]` (in MJD2000) is split into segments of equal
+ * length. Within each segment, position and velocity are interpolated by
+ * Chebyshev polynomials, fitted once to the analytical ephemeris at the
+ * Chebyshev nodes of the segment. Evaluating the table costs a lookup and a
+ * few multiply-adds, instead of solving Kepler's equation.
+ *
+ * The segments are halved until the interpolation matches the analytical
+ * ephemeris within `tolerance` (relative to the norm of position and velocity)
+ * between the nodes. Outside of `[start, end]`, the analytical ephemeris is
+ * called directly, so the results are always valid.
+ */
+class ephemeris_table
+{
+public:
+  /**
+   * Writes position (km) and velocity (km/s) at the given MJD2000 into the
+   * last two arguments.
+   */
+  typedef std::function<void(const double, double *, double *)> analytical_ephemeris;
+
+  /**
+   * The degree of the Chebyshev polynomials.
+   */
+  static constexpr std::size_t degree = 12;
+
+  /**
+   * Fits the table to `ephemeris` on `[start, end]`.
+   *
+   * Throws `std::invalid_argument` if `start` is greater than `end` or
+   * `tolerance` is not positive.
+   */
+  ephemeris_table(const analytical_ephemeris &ephemeris, const double start,
+                  const double end, const double tolerance = 1e-11);
+
+  /**
+   * Writes position (km) and velocity (km/s) at `mjd2000` into `r` and `v`.
+   */
+  void evaluate(const double mjd2000, double *r, double *v) const;
+
+  /**
+   * Returns a tuple (position, velocity).
+   */
+  std::pair<std::array<double, 3>, std::array<double, 3>> ephemeris(
+      const double mjd2000) const;
+
+  /**
+   * Returns the length of the segments in days.
+   */
+  double segment_length() const;
+
+private:
+  static constexpr std::size_t coefficients_per_segment = 6 * (degree + 1);
+
+  /**
+   * Fits all segments for the current `length` and returns the largest
+   * relative interpolation error between the nodes.
+   */
+  double fit();
+
+  analytical_ephemeris fallback;
+  double start;
+  double end;
+  double length;
+  double inverse_length;
+  std::size_t number_of_segments;
+
+  /**
+   * Coefficient-major per segment: `(degree + 1)` blocks of the 6 components
+   * (position, velocity), so that all components are evaluated together.
+   */
+  std::vector<double> coefficients;
+};
+} // namespace pass
@@ -0,0 +1,78 @@
+#pragma once
+
+namespace pass
+{
+/**
+ * Accuracy level of the astrodynamics kernels, selected at run time by the
+ * MGA and MGA-DSM problems (see `mgaproblem::fidelity`).
+ */
+enum class fidelity
+{
+  /**
+   * Loose tolerances and capped iterations, e.g. for early exploration of the
+   * search space. The MGA-DSM problems also propagate their arcs with the
+   * universal variables then (see `mgadsmproblem::fidelity`).
+   */
+  low,
+  /**
+   * The reference accuracy of the kernels.
+   */
+  high
+};
+
+/**
+ * Fidelity policies: The tolerances of the iterative kernels, passed as
+ * compile-time template parameter (e.g. `solve_lambert<low_fidelity>`), so
+ * that they are constants within the kernels.
+ *
+ * - `lambert_tolerance` and `lambert_iterations`: Smallest step of the free
+ *   variable of `solve_lambert` that counts as converged, and the maximal
+ *   number of Householder iterations.
+ * - `swing_by_tolerance` and `swing_by_iterations`: Same for the Newton
+ *   iterations of the pericenter radius in `pow_swing_by_inv`.
+ */
+struct high_fidelity
+{
+  static constexpr fidelity level = fidelity::high;
+  static constexpr double lambert_tolerance = 1e-8;
+  static constexpr int lambert_iterations = 15;
+  static constexpr double swing_by_tolerance = 1e-8;
+  static constexpr int swing_by_iterations = 30;
+};
+
+/**
+ * The pericenter radius of `pow_swing_by_inv` is scaled by the gravitational
+ * parameter of the planet (about 5e-4 for Jupiter) and its constraint is
+ * penalised heavily, so its tolerance can only be relaxed slightly and its
+ * iterations are not capped.
+ *
+ * Measured with `pass::fidelity_comparison` on 40000 random agents per
+ * mission, with the ephemeris tables of the problems. The differences are
+ * relative to the high-fidelity objective value (but at least 1), over all
+ * agents / the best 10% of them:
+ *
+ * | Mission        | Faster by | Difference | Best 10% |
+ * |----------------|-----------|------------|----------|
+ * | Cassini 1      | 11%       | 1.2e-3     | 8.2e-4   |
+ * | GTOC 1         | 11 - 12%  | 1.1e-2     | 1.9e-3   |
+ * | Messenger_Full | 31%       | 2.7e-1     | 2.1e-6   |
+ * | Rosetta        | 31%       | 3.5e-6     | 7.0e-7   |
+ *
+ * Most of the MGA-DSM savings come from the universal variables. On
+ * Messenger_Full, the differences above 1e-4 only occur at objective values
+ * above 1e6 km/s, and 7 agents are only feasible at one of the fidelities.
+ *
+ * The MGA problems have no cheaper level: They already use the ephemeris
+ * tables at both fidelities, and a `pass::porkchop_table` for the first leg
+ * only saves about 2% on Cassini 1, as each arc still needs a Householder
+ * iteration.
+ */
+struct low_fidelity
+{
+  static constexpr fidelity level = fidelity::low;
+  static constexpr double lambert_tolerance = 1e-2;
+  static constexpr int lambert_iterations = 8;
+  static constexpr double swing_by_tolerance = 1e-7;
+  static constexpr int swing_by_iterations = 30;
+};
+} // namespace pass
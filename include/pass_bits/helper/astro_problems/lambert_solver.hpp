@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pass_bits/helper/astro_problems/fidelity.hpp"
+#include <cstddef> // std::size_t
+
+namespace pass
+{
+/**
+ * Result of `solve_lambert`.
+ */
+enum class lambert_error
+{
+  none = 0,
+  /**
+   * The time of flight is zero or negative.
+   */
+  non_positive_time_of_flight,
+  /**
+   * The positions are collinear with the central body (or zero), so the plane
+   * of the transfer is undefined.
+   */
+  undefined_transfer_plane,
+  /**
+   * The iteration did not converge, e.g. for non-finite inputs.
+   */
+  not_converged
+};
+
+/**
+ * Solves Lambert's problem without full revolutions: Finds the velocities
+ * `v1` at `r1` and `v2` at `r2` of the Kepler orbit around a central body with
+ * gravitational parameter `mu`, which travels from `r1` to `r2` in
+ * `time_of_flight`. If `long_way` is `false`, the transfer angle is less than
+ * pi, with the angular momentum in direction of `r1 x r2`; otherwise greater.
+ *
+ * Uses the algorithm of D. Izzo ("Revisiting Lambert's problem", Celestial
+ * Mechanics and Dynamical Astronomy 121, 2015): The time of flight is
+ * expressed in a single variable `x`, which is found with third-order
+ * Householder iterations from a close initial guess, usually within 2 to 3
+ * iterations, in double precision.
+ *
+ * Units must be consistent, e.g. km, s and km^3/s^2. `v1` and `v2` are left
+ * unchanged if an error is returned. If `x` is not `nullptr`, the solution of
+ * the free variable is written into it, e.g. to tabulate it for
+ * `refine_lambert`.
+ */
+lambert_error solve_lambert(const double *r1, const double *r2,
+                            const double time_of_flight, const double mu,
+                            const bool long_way, double *v1, double *v2,
+                            double *x = nullptr);
+
+/**
+ * Solves the Lambert problem (see above) with the tolerances of the fidelity
+ * policy `Fidelity`. `solve_lambert<high_fidelity>` equals `solve_lambert`.
+ * Instantiated for `high_fidelity` and `low_fidelity`, each for the scalar
+ * types `double` and `gradient_dual`. With dual numbers, the Householder
+ * iterations converge to the derivatives of the solution as well.
+ */
+template <typename Fidelity, typename Scalar>
+lambert_error solve_lambert(const Scalar *r1, const Scalar *r2,
+                            const Scalar time_of_flight, const double mu,
+                            const bool long_way, Scalar *v1, Scalar *v2);
+
+/**
+ * Solves the same problem as `solve_lambert`, but starts at the approximate
+ * solution `x` of the free variable (e.g. interpolated from neighbouring
+ * problems) and performs exactly `iterations` Householder iterations, without
+ * checking for convergence. As the convergence is cubic, a single iteration
+ * turns an error of 1e-4 in `x` into about 1e-12.
+ */
+lambert_error refine_lambert(const double *r1, const double *r2,
+                             const double time_of_flight, const double mu,
+                             const bool long_way, const double x,
+                             const int iterations, double *v1, double *v2);
+
+/**
+ * Solves `n` independent Lambert problems (see above). The vectors `r1`,
+ * `r2`, `v1` and `v2` store 3 consecutive values per problem.
+ * `errors` may be `nullptr`.
+ */
+void solve_lambert(const double *r1, const double *r2,
+                   const double *time_of_flight, const bool *long_way,
+                   const double mu, const std::size_t n, double *v1,
+                   double *v2, lambert_error *errors);
+
+/**
+ * Solves `n` independent Lambert problems with the tolerances of `Fidelity`.
+ */
+template <typename Fidelity>
+void solve_lambert(const double *r1, const double *r2,
+                   const double *time_of_flight, const bool *long_way,
+                   const double mu, const std::size_t n, double *v1,
+                   double *v2, lambert_error *errors);
+} // namespace pass
@@ -10,8 +10,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
+#include "pass_bits/helper/dual.hpp"
 #include "pl_eph_an.hpp"
+#include "ephemeris_table.hpp"
+#include "fidelity.hpp"
+#include "porkchop_table.hpp"
 
 using namespace std;
 
@@ -23,6 +28,10 @@ const int total_DV_rndv = 3;            // Cassini 2 and Messenger
 const int asteroid_impact = 4;          // gtoc1
 const int time2AUs = 5;                 // SAGAS
 
+// Longest supported fly-by sequence. Compiled problems store all per-body data
+// in arrays of this size, so that evaluations work on the stack only
+const int max_sequence_length = 16;
+
 struct customobject
 {
   double keplerian[6];
@@ -41,12 +50,104 @@ struct mgaproblem
   double Isp;
   double mass;
   double DVlaunch;
+
+  //Accuracy of the Lambert and swing-by solvers
+  pass::fidelity fidelity = pass::fidelity::high;
+
+  //Optional precomputed ephemerides, one per entry of the sequence. If empty,
+  //the analytical ephemerides are evaluated instead
+  vector<shared_ptr<const pass::ephemeris_table>> ephemerides;
+};
+
+//Immutable, compiled form of an mgaproblem. The constants of all bodies are
+//resolved once, so that MGA only performs arithmetic. Copies share the
+//ephemerides
+struct mgaplan
+{
+  int type;
+  int n; //length of the fly-by sequence
+  int sequence[max_sequence_length];
+  int rev_flag[max_sequence_length];
+  double mu[max_sequence_length];             //gravitational constant of each body
+  double penalty[max_sequence_length];        //minimal fly-by radius of each body
+  double penalty_coeffs[max_sequence_length]; //penalty per km below `penalty`
+  shared_ptr<const pass::ephemeris_table> ephemerides[max_sequence_length]; //may be null
+  //Optional porkchop table of the first leg, indexed by launch date and time of
+  //flight. If null, the first leg is solved like all others
+  shared_ptr<const pass::porkchop_table> first_leg;
+  customobject asteroid;
+  double e;
+  double rp;
+  double Isp;
+  double mass;
+  double DVlaunch;
+  pass::fidelity fidelity;
 };
 
+//Intermediate results of MGA for the last decision vector evaluated with this
+//state, so that the next one only recomputes what depends on its changed
+//entries (see the overload of MGA with state). A state belongs to a single
+//plan; a default-constructed one is empty. It is also reset if the fidelity or
+//the porkchop table of the plan changed since, as the problems change these in
+//place
+struct mgastate
+{
+  const mgaplan *plan = nullptr; //plan of the cached decision vector, or nullptr
+  pass::fidelity fidelity = pass::fidelity::high; //fidelity of the plan then
+  const pass::porkchop_table *first_leg = nullptr; //porkchop table of the plan then
+  double t[max_sequence_length];
+  double dates[max_sequence_length]; //MJD2000 of each body
+  double r[3 * max_sequence_length]; //3 consecutive values per body or leg
+  double v[3 * max_sequence_length];
+  double v_departure[3 * (max_sequence_length - 1)];
+  double v_arrival[3 * (max_sequence_length - 1)];
+  pass::lambert_error errors[max_sequence_length - 1];
+  double rp[max_sequence_length];
+  double DV[max_sequence_length];
+  int fly_bys = 0; //the fly-bys at the bodies 1...fly_bys are up to date
+};
+
+//Throws std::invalid_argument if the sequence is shorter than 2 or longer than
+//max_sequence_length bodies, rev_flag or ephemerides don't match its length, or
+//the type is neither total_DV_orbit_insertion nor asteroid_impact
+mgaplan compile_mga(const mgaproblem &);
+
+//Position and velocity of the i_count-th body of the sequence at MJD2000 T
+void get_celobj_r_and_v(const mgaplan &, const double T, const int i_count, double *r, double *v);
+
+//Like above, in dual numbers. Always evaluates the analytical ephemerides, as
+//the precomputed ones aren't differentiated
+void get_celobj_r_and_v(const mgaplan &, const pass::gradient_dual T, const int i_count,
+                        pass::gradient_dual *r, pass::gradient_dual *v);
+
 int MGA(
     //INPUTS
-    vector<double>,
-    mgaproblem,
+    const double *, // the n entries of the decision vector
+    const mgaplan &,
 
     //OUTPUTS
-    vector<double> &, vector<double> &, double &);
+    double *, // n-2 pericenter radii
+    double *, // n delta-Vs
+    double &);
+
+//Like MGA, but stops early once the objective function is known to exceed
+//`cutoff`, and returns 1 then. In this case, the objective function is set to
+//a lower bound that exceeds `cutoff`: the delta Vs and penalties of the legs
+//evaluated so far. Only total_DV_orbit_insertion stops early, as the objective
+//function of asteroid_impact isn't a sum of delta Vs
+int MGA(const double *, const mgaplan &, const double cutoff, double &);
+
+//Like MGA, but reuses the ephemerides, Lambert arcs and fly-bys of the previous
+//decision vector in `state` that don't depend on the entries that changed since,
+//and stores the results of t in `state`. Changing t[k] recomputes the bodies
+//from k and the legs and fly-bys from k - 1 on, so local searches over the
+//trailing times of flight are cheap. The objective function (and state.rp and
+//state.DV) equal those of MGA
+int MGA(const double *, const mgaplan &, mgastate &state, double &);
+
+//Like MGA, but in dual numbers, e.g. to compute the gradient of the objective
+//function with pass::forward_gradient. Always evaluates the analytical
+//ephemerides and solves all Lambert arcs, as the precomputed ephemerides and
+//the porkchop table aren't differentiated; the objective function agrees with
+//MGA to about their accuracy
+int MGA(const pass::gradient_dual *, const mgaplan &, pass::gradient_dual &);
@@ -10,8 +10,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "mga.hpp"
+#include "propagate_universal.hpp"
 
 struct mgadsmproblem
 {
@@ -24,18 +26,88 @@ struct mgadsmproblem
   double DVtotal;            //Total DV allowed in km/s (only in case of time2AUs)
   double DVonboard;          //Total DV on the spacecraft in km/s (only in case of time2AUs)
 
-  //Pre-allocated memory, in order to remove allocation of heap space in MGA_DSM calls
-  //The DV vector serves also as output containing all the values for the impulsive DV
-  std::vector<double *> r; // = std::vector<double*>(n);
-  std::vector<double *> v; // = std::vector<double*>(n);
-  std::vector<double> DV;  // = std::vector<double>(n+1);
+  //Propagator of the arcs up to the deep space manoeuvres
+  pass::kepler_propagator propagator = pass::kepler_propagator::elements;
+
+  //Accuracy of the Lambert solver. The low fidelity also propagates with
+  //kepler_propagator::universal_variables, whatever `propagator` is
+  pass::fidelity fidelity = pass::fidelity::high;
+
+  //Optional precomputed ephemerides, one per entry of the sequence. If empty,
+  //the analytical ephemerides are evaluated instead
+  std::vector<std::shared_ptr<const pass::ephemeris_table>> ephemerides;
+};
+
+//Immutable, compiled form of an mgadsmproblem. The constants of all bodies are
+//resolved once, so that MGA_DSM only performs arithmetic on the stack. Copies
+//share the ephemerides
+struct mgadsmplan
+{
+  int type;
+  int n; //length of the fly-by sequence
+  int sequence[max_sequence_length];
+  double mu[max_sequence_length];     //gravitational constant of each body
+  double radius[max_sequence_length]; //radius of each planet in km (0 if unknown)
+  std::shared_ptr<const pass::ephemeris_table> ephemerides[max_sequence_length]; //may be null
+  customobject asteroid;
+  double e;
+  double rp;
+  double AUdist;
+  double DVtotal;
+  double DVonboard;
+  pass::kepler_propagator propagator;
+  pass::fidelity fidelity;
+};
+
+//Intermediate results of MGA_DSM for the last decision vector evaluated with
+//this state, so that the next one only recomputes the legs that depend on its
+//changed entries (see the overload of MGA_DSM with state). A state belongs to a
+//single plan; a default-constructed one is empty. It is also reset if the
+//fidelity of the plan changed since, as the problems change it in place
+struct mgadsmstate
+{
+  const mgadsmplan *plan = nullptr; //plan of the cached decision vector, or nullptr
+  pass::fidelity fidelity = pass::fidelity::high; //fidelity of the plan then
+  double t[4 * max_sequence_length];
+  double dates[max_sequence_length]; //MJD2000 of each body
+  double r[max_sequence_length][3];
+  double v[max_sequence_length][3];
+  double DV[max_sequence_length];                //DV of the DSM of each leg, and the arrival DV
+  double v_arrival[max_sequence_length - 1][3]; //spacecraft velocity at the end of each leg
+  int legs = 0;                                  //the legs {0...legs-1} are up to date
 };
 
+//Throws std::invalid_argument if the sequence is shorter than 2 or longer than
+//max_sequence_length bodies, ephemerides doesn't match its length, or the type
+//is asteroid_impact
+mgadsmplan compile_mga_dsm(const mgadsmproblem &);
+
 int MGA_DSM(
     /* INPUT values: */
-    std::vector<double> x, // it is the decision vector
-    mgadsmproblem &mgadsm, // contains the problem specific data, passed as reference as mgadsm.DV is an output
+    const double *x,          // it is the decision vector
+    const mgadsmplan &mgadsm, // contains the problem specific data
 
     /* OUTPUT values: */
-    double &J // J output
+    double *DV, // the n+1 impulsive DVs, may be nullptr
+    double &J   // J output
 );
+
+//Like MGA_DSM, but stops early once J is known to exceed `cutoff`, and returns
+//1 then. In this case, J is set to a lower bound that exceeds `cutoff`: the
+//DVs of the legs evaluated so far (plus the escape velocity for the total_DV
+//types). time2AUs never stops early, as its J isn't a sum of DVs
+int MGA_DSM(const double *x, const mgadsmplan &mgadsm, const double cutoff, double &J);
+
+//Like MGA_DSM, but reuses the ephemerides and legs of the previous decision
+//vector in `state` that don't depend on the entries that changed since, and
+//stores the results of x in `state`. The legs are evaluated in sequence, so
+//changing an entry of leg k (its time of flight, DSM timing, or the fly-by
+//before it) recomputes the legs from k on; the launch entries recompute all.
+//J equals the one of MGA_DSM
+int MGA_DSM(const double *x, const mgadsmplan &mgadsm, mgadsmstate &state, double &J);
+
+//Like MGA_DSM, but in dual numbers, e.g. to compute the gradient of J with
+//pass::forward_gradient. Always evaluates the analytical ephemerides, as the
+//precomputed ones aren't differentiated; J agrees with MGA_DSM to about their
+//accuracy
+int MGA_DSM(const pass::gradient_dual *x, const mgadsmplan &mgadsm, pass::gradient_dual &J);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "pass_bits/helper/search_space_boxes.hpp"
+#include "pass_bits/problem/space_mission/mga_problem.hpp"
+#include <vector> // std::vector
+
+namespace pass
+{
+/**
+ * Reduces the search space of an MGA mission (launch date and leg durations)
+ * to the regions that are not hopeless, similar to GASP (Myatt et al.,
+ * "Advanced Global Optimisation for Mission Analysis and Design", ESA, 2004).
+ *
+ * The legs are pruned one after the other: The launch date and the duration
+ * of the first leg are divided into `cells` intervals each, and the leg is
+ * solved at the centre of each cell. A cell is pruned if its launch DV (in
+ * excess of `DVlaunch`) exceeds `threshold` (km/s). Each remaining cell is
+ * then divided along the duration of the next leg, where cells are pruned if
+ * the DV of the swing-by plus its pericenter penalty exceeds `threshold`; and
+ * so on. For orbit insertions, the insertion DV adds to the cost of the last
+ * leg. If more than `maximal_boxes` cells remain after a leg, the ones with
+ * the lowest accumulated DV are kept.
+ *
+ * As the cells are only evaluated at their centre, `threshold` should leave
+ * some margin. The cells of each leg are evaluated in parallel.
+ *
+ * Returns the boxes of the remaining cells, for `pass::search_space_boxes`.
+ * The result is empty if everything was pruned.
+ */
+std::vector<search_box> prune_search_space(const mga_problem &problem,
+                                           const double threshold,
+                                           const arma::uword cells = 16,
+                                           const arma::uword maximal_boxes = 10000);
+} // namespace pass
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "pass_bits/helper/astro_problems/mga.hpp"
+#include "pass_bits/helper/astro_problems/propagate_universal.hpp"
+#include <armadillo> // arma::vec
+#include <memory>    // std::shared_ptr
+#include <string>    // std::string
+#include <vector>    // std::vector
+
+namespace pass
+{
+/**
+ * Declarative description of a multiple gravity assist mission, from which
+ * `pass::mga_problem` and `pass::mga_dsm_problem` are built.
+ *
+ * A description is plain text with one `key value...` entry per line. Empty
+ * lines and everything after `#` are ignored. Numbers may also be written as
+ * `pi` or `-pi`. Example (Cassini 1):
+ *
+ *     name Cassini1
+ *     type total_DV_orbit_insertion
+ *     sequence 3 2 2 3 5 6
+ *     rev_flag 0 0 0 0 0 0
+ *     e 0.98
+ *     rp 108950
+ *     DVlaunch 0
+ *     lower_bounds -1000 30 100 30 400 1000
+ *     upper_bounds 0 400 470 400 2000 6000
+ *
+ * The keys are the members below. `type` is one of the problem types of
+ * `mga.hpp` (e.g. `rndv`) and `asteroid` lists the 6 keplerian elements, the
+ * epoch and the gravitational constant of the custom object (body 10).
+ * `propagator` is `elements` (default) or `universal_variables` and selects
+ * the Kepler propagator of MGA-DSM missions. Missing numbers default to 0 and
+ * `rev_flag` defaults to all 0.
+ */
+struct mission_description
+{
+  std::string name;
+  int type = 0;
+  std::vector<int> sequence;
+  std::vector<int> rev_flag;
+  customobject asteroid = {};
+  double e = 0.0;
+  double rp = 0.0;
+  double Isp = 0.0;
+  double mass = 0.0;
+  double DVlaunch = 0.0;
+  double AUdist = 0.0;
+  double DVtotal = 0.0;
+  double DVonboard = 0.0;
+  kepler_propagator propagator = kepler_propagator::elements;
+  arma::vec lower_bounds;
+  arma::vec upper_bounds;
+};
+
+/**
+ * Parses a mission description (see above).
+ *
+ * Throws `std::invalid_argument` for unknown keys, malformed numbers or a
+ * missing name, sequence or bounds.
+ */
+mission_description parse_mission_description(const std::string &description);
+
+/**
+ * Tabulates the ephemerides of all bodies in the fly-by sequence of `mission`
+ * on `[start, end]` (in MJD2000). Bodies that occur repeatedly share a table.
+ */
+std::vector<std::shared_ptr<const pass::ephemeris_table>> tabulate_ephemerides(
+    const mission_description &mission, const double start, const double end);
+
+/**
+ * The descriptions of the ESA missions that PASS implements.
+ */
+namespace missions
+{
+extern const char *const cassini1;
+extern const char *const gtoc1;
+extern const char *const messenger_full;
+extern const char *const rosetta;
+} // namespace missions
+} // namespace pass
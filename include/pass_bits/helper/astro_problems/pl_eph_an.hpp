@@ -10,6 +10,10 @@
 
 #pragma once
 
-void Planet_Ephemerides_Analytical(const double, const int, double *, double *);
+// Instantiated for double and pass::gradient_dual, like the functions of
+// astro_functions.hpp
+template <typename Scalar>
+void Planet_Ephemerides_Analytical(const Scalar, const int, Scalar *, Scalar *);
 
-void Custom_Eph(const double, const double, const double[], double *, double *);
+template <typename Scalar>
+void Custom_Eph(const Scalar, const double, const double[], Scalar *, Scalar *);
@@ -9,9 +9,18 @@
 // Copyright (c) 2004-2007 European Space Agency                            //
 // ------------------------------------------------------------------------ //
 
+#include "fidelity.hpp"
+
 namespace pass
 {
 
 void pow_swing_by_inv(const double, const double, const double, double &,
                       double &);
+
+// With the tolerances of the fidelity policy `Fidelity`; the version above
+// equals `pow_swing_by_inv<high_fidelity>`. Instantiated for the scalar types
+// double and gradient_dual
+template <typename Fidelity, typename Scalar>
+void pow_swing_by_inv(const Scalar, const Scalar, const Scalar, Scalar &,
+                      Scalar &);
 }
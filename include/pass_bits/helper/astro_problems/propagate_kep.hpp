@@ -12,14 +12,20 @@
 
 #include "astro_functions.hpp"
 
-void propagateKEP(const double *, const double *, double, double,
-                  double *, double *);
+// Instantiated for double and pass::gradient_dual, like the functions of
+// astro_functions.hpp
+template <typename Scalar>
+void propagateKEP(const Scalar *, const Scalar *, Scalar, double,
+                  Scalar *, Scalar *);
 
-void IC2par(const double *, const double *, double, double *);
+template <typename Scalar>
+void IC2par(const Scalar *, const Scalar *, double, Scalar *);
 
-void par2IC(const double *, double, double *, double *);
+template <typename Scalar>
+void par2IC(const Scalar *, double, Scalar *, Scalar *);
 
 // Returns the cross product of the vectors X and Y.
 // That is, z = X x Y.  X and Y must be 3 element
 // vectors.
-void cross(const double *, const double *, double *);
+template <typename Scalar>
+void cross(const Scalar *, const Scalar *, Scalar *);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+
+namespace pass
+{
+/**
+ * The algorithms that propagate Kepler orbits.
+ */
+enum class kepler_propagator
+{
+  /**
+   * `propagateKEP`: Converts the state to orbital elements, solves Kepler's
+   * equation and converts back. Orbits close to zero inclination are rotated
+   * first, as the elements are singular there.
+   */
+  elements,
+  /**
+   * `propagate_universal`
+   */
+  universal_variables
+};
+
+/**
+ * Propagates the state `r0`, `v0` by `t` along its Kepler orbit around a
+ * central body with gravitational parameter `mu` and writes the resulting
+ * state into `r` and `v`.
+ *
+ * Solves the universal Kepler equation for the universal anomaly with
+ * Laguerre-Conway iterations and applies the Lagrange coefficients f, g,
+ * f' and g'. This works the same for elliptic, parabolic and hyperbolic
+ * orbits without any conversion to orbital elements, so there is no
+ * singularity at zero inclination or eccentricity.
+ *
+ * Units must be consistent, e.g. km, s and km^3/s^2. `t` may be negative.
+ *
+ * Instantiated for `double` and `gradient_dual`.
+ */
+template <typename Scalar>
+void propagate_universal(const Scalar *r0, const Scalar *v0, const Scalar t,
+                         const double mu, Scalar *r, Scalar *v);
+
+/**
+ * Propagates `n` independent states (see above). The vectors `r0`, `v0`, `r`
+ * and `v` store 3 consecutive values per state.
+ */
+void propagate_universal(const double *r0, const double *v0, const double *t,
+                         const double mu, const std::size_t n, double *r,
+                         double *v);
+
+/**
+ * Propagates the state `r0`, `v0` by `t` with the given `propagator`.
+ * Instantiated for `double` and `gradient_dual`.
+ */
+template <typename Scalar>
+void propagate_kepler(const kepler_propagator propagator, const Scalar *r0,
+                      const Scalar *v0, const Scalar t, const double mu,
+                      Scalar *r, Scalar *v);
+} // namespace pass
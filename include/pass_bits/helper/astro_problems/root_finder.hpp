@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <utility> // std::swap
+
+namespace pass
+{
+/**
+ * Finds a zero of `f` in [`lower`, `upper`] with the Amsterdam method, a
+ * combination of inverse quadratic interpolation and bisection that keeps the
+ * zero bracketed (see http://mymathlib.webtrellis.net/roots/amsterdam.html).
+ *
+ * `f` may be any callable `double(double)`. As it's a template parameter, the
+ * calls are inlined, and as the whole state is local, it is safe to call
+ * `find_zero` concurrently from several threads.
+ *
+ * Returns a point within `tolerance` of a zero, or an end point where `f` is
+ * zero. If `f(lower)` and `f(upper)` have the same sign, returns 0.
+ *
+ * The results equal those of `zero_finder::FZero`, which delegates here.
+ */
+template <typename Function>
+double find_zero(Function &&f, double lower, double upper,
+                 const double tolerance = 1e-15, const int maximal_iterations = 500)
+{
+  double a = lower;
+  double c = upper;
+  double fa = f(a);
+  double fc = f(c);
+
+  if (fa * fc >= 0.0)
+  {
+    if (fa * fc > 0.0)
+    {
+      return 0.0;
+    }
+    return fa == 0.0 ? a : c;
+  }
+
+  if (a > c)
+  {
+    std::swap(a, c);
+    std::swap(fa, fc);
+  }
+
+  // Turns the problem into one with f(a) < 0 < f(c). Negating the function
+  // values is exact, so the interpolation steps are the same either way.
+  const double sign = fa > 0.0 ? -1.0 : 1.0;
+  fa *= sign;
+  fc *= sign;
+
+  double b = 0.5 * (a + c);
+  for (int iteration = 0; iteration < maximal_iterations; ++iteration)
+  {
+    if (c - a < tolerance)
+    {
+      return 0.5 * (a + c);
+    }
+
+    const double fb = sign * f(b);
+
+    // Close to an end point, the interval shrinks slowly, so it is bisected.
+    if (b - a < tolerance)
+    {
+      if (fb < 0.0)
+      {
+        a = b;
+        fa = fb;
+        b = 0.5 * (a + c);
+        continue;
+      }
+      return b;
+    }
+    if (c - b < tolerance)
+    {
+      if (fb > 0.0)
+      {
+        c = b;
+        fc = fb;
+        b = 0.5 * (a + c);
+        continue;
+      }
+      return b;
+    }
+
+    // Inverse quadratic interpolation, if its estimate lies within the interval
+    if (fa < fb && fb < fc)
+    {
+      const double denominator = (fc - fb) * (fa - fb) * (fa - fc);
+      if (denominator != 0.0)
+      {
+        const double dab = a - b;
+        const double dcb = c - b;
+        const double delta = fb * (dab * fc * (fc - fb) - fa * dcb * (fa - fb)) / denominator;
+        if (delta > dab && delta < dcb)
+        {
+          if (fb < 0.0)
+          {
+            a = b;
+            fa = fb;
+          }
+          else if (fb > 0.0)
+          {
+            c = b;
+            fc = fb;
+          }
+          else
+          {
+            return b;
+          }
+          b += delta;
+          continue;
+        }
+      }
+    }
+
+    // Bisection
+    if (fb < 0.0)
+    {
+      a = b;
+      fa = fb;
+    }
+    else
+    {
+      c = b;
+      fc = fb;
+    }
+    b = 0.5 * (a + c);
+  }
+
+  return b;
+}
+
+/**
+ * Finds zeros of `n` independent functions (see above), e.g. for all agents of
+ * a population. `f(i, x)` evaluates the `i`-th function at `x`, and its zero
+ * is searched in [`lower[i]`, `upper[i]`] and written to `zeros[i]`.
+ */
+template <typename Function>
+void find_zeros(Function &&f, const double *lower, const double *upper,
+                const std::size_t n, double *zeros,
+                const double tolerance = 1e-15, const int maximal_iterations = 500)
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    zeros[i] = find_zero([&f, i](const double x) { return f(i, x); },
+                         lower[i], upper[i], tolerance, maximal_iterations);
+  }
+}
+} // namespace pass
@@ -40,6 +40,13 @@ public:
                      double g);
 };
 
+/**
+ * Root finder for `Function1D` and `Function1D_7param`.
+ *
+ * Prefer `pass::find_zero` in new code: It takes any callable without virtual
+ * calls and parameters stored in the function object, so it inlines and is
+ * safe to call concurrently.
+ */
 class FZero
 {
 private:
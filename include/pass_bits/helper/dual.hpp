@@ -0,0 +1,532 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <array>     // std::array
+#include <cmath>     // std::sqrt, std::cos, std::exp, ...
+#include <cstddef>   // std::size_t
+#include <vector>    // std::vector
+
+namespace pass
+{
+/**
+ * Dual numbers, with their arithmetic and elementary functions. The functions
+ * are in a namespace of their own, as unqualified calls of e.g. `sqrt` within
+ * namespace `pass` would otherwise only find these overloads, but not the ones
+ * for `double`.
+ */
+namespace dual_numbers
+{
+/**
+ * A dual number for forward-mode automatic differentiation: a value and its
+ * partial derivatives with respect to `N` seeded variables.
+ *
+ * Functions templated on their scalar type compute their value and `N`
+ * directional derivatives in a single evaluation, if instantiated with
+ * `dual<N>`. Each operation propagates the derivatives by the chain rule, so
+ * the results are exact up to rounding, without the truncation error and
+ * step size of finite differences. The values are computed like in double
+ * precision, so they equal the results of the `double` instantiation.
+ *
+ * Branches (comparisons, `floor`, ...) only depend on the value. Functions
+ * that aren't differentiable at a point (e.g. `fabs` at 0) use one of their
+ * one-sided derivatives.
+ */
+template <std::size_t N>
+struct dual
+{
+  double value;
+  std::array<double, N> derivatives;
+
+  dual() noexcept
+      : value(0.0),
+        derivatives()
+  {
+  }
+
+  /**
+   * A constant, i.e. all derivatives are 0.
+   */
+  dual(const double value) noexcept
+      : value(value),
+        derivatives()
+  {
+  }
+
+  dual &operator+=(const dual &other) noexcept
+  {
+    value += other.value;
+    for (std::size_t n = 0; n < N; ++n)
+    {
+      derivatives[n] += other.derivatives[n];
+    }
+    return *this;
+  }
+
+  dual &operator-=(const dual &other) noexcept
+  {
+    value -= other.value;
+    for (std::size_t n = 0; n < N; ++n)
+    {
+      derivatives[n] -= other.derivatives[n];
+    }
+    return *this;
+  }
+
+  dual &operator*=(const dual &other) noexcept
+  {
+    for (std::size_t n = 0; n < N; ++n)
+    {
+      derivatives[n] = derivatives[n] * other.value + value * other.derivatives[n];
+    }
+    value *= other.value;
+    return *this;
+  }
+
+  dual &operator/=(const dual &other) noexcept
+  {
+    // The value is divided, not multiplied by the inverse, so that it is
+    // rounded like in double precision
+    const double inverse = 1.0 / other.value;
+    value /= other.value;
+    for (std::size_t n = 0; n < N; ++n)
+    {
+      derivatives[n] = (derivatives[n] - value * other.derivatives[n]) * inverse;
+    }
+    return *this;
+  }
+};
+
+/**
+ * Returns the dual number with value `f` and the derivatives of `x` scaled by
+ * `df`, i.e. the chain rule for f(x) with f'(x) = `df`.
+ */
+template <std::size_t N>
+dual<N> chain(const dual<N> &x, const double f, const double df) noexcept
+{
+  dual<N> result(f);
+  for (std::size_t n = 0; n < N; ++n)
+  {
+    result.derivatives[n] = df * x.derivatives[n];
+  }
+  return result;
+}
+
+// Arithmetic
+
+template <std::size_t N>
+dual<N> operator+(const dual<N> &x) noexcept
+{
+  return x;
+}
+
+template <std::size_t N>
+dual<N> operator-(const dual<N> &x) noexcept
+{
+  return chain(x, -x.value, -1.0);
+}
+
+template <std::size_t N>
+dual<N> operator+(dual<N> x, const dual<N> &y) noexcept
+{
+  return x += y;
+}
+
+template <std::size_t N>
+dual<N> operator+(dual<N> x, const double y) noexcept
+{
+  x.value += y;
+  return x;
+}
+
+template <std::size_t N>
+dual<N> operator+(const double x, dual<N> y) noexcept
+{
+  y.value += x;
+  return y;
+}
+
+template <std::size_t N>
+dual<N> operator-(dual<N> x, const dual<N> &y) noexcept
+{
+  return x -= y;
+}
+
+template <std::size_t N>
+dual<N> operator-(dual<N> x, const double y) noexcept
+{
+  x.value -= y;
+  return x;
+}
+
+template <std::size_t N>
+dual<N> operator-(const double x, const dual<N> &y) noexcept
+{
+  return chain(y, x - y.value, -1.0);
+}
+
+template <std::size_t N>
+dual<N> operator*(dual<N> x, const dual<N> &y) noexcept
+{
+  return x *= y;
+}
+
+template <std::size_t N>
+dual<N> operator*(const dual<N> &x, const double y) noexcept
+{
+  return chain(x, x.value * y, y);
+}
+
+template <std::size_t N>
+dual<N> operator*(const double x, const dual<N> &y) noexcept
+{
+  return chain(y, x * y.value, x);
+}
+
+template <std::size_t N>
+dual<N> operator/(dual<N> x, const dual<N> &y) noexcept
+{
+  return x /= y;
+}
+
+template <std::size_t N>
+dual<N> operator/(const dual<N> &x, const double y) noexcept
+{
+  return chain(x, x.value / y, 1.0 / y);
+}
+
+template <std::size_t N>
+dual<N> operator/(const double x, const dual<N> &y) noexcept
+{
+  const double f = x / y.value;
+  return chain(y, f, -f / y.value);
+}
+
+// Comparisons only consider the values
+
+#define PASS_DUAL_COMPARISON(op)                                        \
+  template <std::size_t N>                                              \
+  bool operator op(const dual<N> &x, const dual<N> &y) noexcept         \
+  {                                                                     \
+    return x.value op y.value;                                          \
+  }                                                                     \
+  template <std::size_t N>                                              \
+  bool operator op(const dual<N> &x, const double y) noexcept           \
+  {                                                                     \
+    return x.value op y;                                                \
+  }                                                                     \
+  template <std::size_t N>                                              \
+  bool operator op(const double x, const dual<N> &y) noexcept           \
+  {                                                                     \
+    return x op y.value;                                                \
+  }
+
+PASS_DUAL_COMPARISON(==)
+PASS_DUAL_COMPARISON(!=)
+PASS_DUAL_COMPARISON(<)
+PASS_DUAL_COMPARISON(<=)
+PASS_DUAL_COMPARISON(>)
+PASS_DUAL_COMPARISON(>=)
+
+#undef PASS_DUAL_COMPARISON
+
+// Elementary functions, found by argument-dependent lookup. Functions
+// templated on their scalar type call them unqualified, after `using
+// std::sqrt;` etc. for `double`.
+
+template <std::size_t N>
+dual<N> sqrt(const dual<N> &x) noexcept
+{
+  const double f = std::sqrt(x.value);
+  return chain(x, f, 0.5 / f);
+}
+
+template <std::size_t N>
+dual<N> cbrt(const dual<N> &x) noexcept
+{
+  const double f = std::cbrt(x.value);
+  return chain(x, f, 1.0 / (3.0 * f * f));
+}
+
+template <std::size_t N>
+dual<N> exp(const dual<N> &x) noexcept
+{
+  const double f = std::exp(x.value);
+  return chain(x, f, f);
+}
+
+template <std::size_t N>
+dual<N> log(const dual<N> &x) noexcept
+{
+  return chain(x, std::log(x.value), 1.0 / x.value);
+}
+
+template <std::size_t N>
+dual<N> pow(const dual<N> &x, const double y) noexcept
+{
+  const double f = std::pow(x.value, y);
+  return chain(x, f, y == 0.0 ? 0.0 : y * std::pow(x.value, y - 1.0));
+}
+
+template <std::size_t N>
+dual<N> pow(const double x, const dual<N> &y) noexcept
+{
+  const double f = std::pow(x, y.value);
+  return chain(y, f, f * std::log(x));
+}
+
+template <std::size_t N>
+dual<N> pow(const dual<N> &x, const dual<N> &y) noexcept
+{
+  if (y.derivatives == std::array<double, N>())
+  {
+    return pow(x, y.value);
+  }
+  return exp(y * log(x));
+}
+
+template <std::size_t N>
+dual<N> sin(const dual<N> &x) noexcept
+{
+  return chain(x, std::sin(x.value), std::cos(x.value));
+}
+
+template <std::size_t N>
+dual<N> cos(const dual<N> &x) noexcept
+{
+  return chain(x, std::cos(x.value), -std::sin(x.value));
+}
+
+template <std::size_t N>
+dual<N> tan(const dual<N> &x) noexcept
+{
+  const double f = std::tan(x.value);
+  return chain(x, f, 1.0 + f * f);
+}
+
+template <std::size_t N>
+dual<N> asin(const dual<N> &x) noexcept
+{
+  return chain(x, std::asin(x.value), 1.0 / std::sqrt(1.0 - x.value * x.value));
+}
+
+template <std::size_t N>
+dual<N> acos(const dual<N> &x) noexcept
+{
+  return chain(x, std::acos(x.value), -1.0 / std::sqrt(1.0 - x.value * x.value));
+}
+
+template <std::size_t N>
+dual<N> atan(const dual<N> &x) noexcept
+{
+  return chain(x, std::atan(x.value), 1.0 / (1.0 + x.value * x.value));
+}
+
+template <std::size_t N>
+dual<N> atan2(const dual<N> &y, const dual<N> &x) noexcept
+{
+  const double inverse = 1.0 / (x.value * x.value + y.value * y.value);
+  dual<N> result(std::atan2(y.value, x.value));
+  for (std::size_t n = 0; n < N; ++n)
+  {
+    result.derivatives[n] = (x.value * y.derivatives[n] - y.value * x.derivatives[n]) * inverse;
+  }
+  return result;
+}
+
+template <std::size_t N>
+dual<N> sinh(const dual<N> &x) noexcept
+{
+  return chain(x, std::sinh(x.value), std::cosh(x.value));
+}
+
+template <std::size_t N>
+dual<N> cosh(const dual<N> &x) noexcept
+{
+  return chain(x, std::cosh(x.value), std::sinh(x.value));
+}
+
+template <std::size_t N>
+dual<N> tanh(const dual<N> &x) noexcept
+{
+  const double f = std::tanh(x.value);
+  return chain(x, f, 1.0 - f * f);
+}
+
+template <std::size_t N>
+dual<N> asinh(const dual<N> &x) noexcept
+{
+  return chain(x, std::asinh(x.value), 1.0 / std::sqrt(x.value * x.value + 1.0));
+}
+
+template <std::size_t N>
+dual<N> acosh(const dual<N> &x) noexcept
+{
+  return chain(x, std::acosh(x.value), 1.0 / std::sqrt(x.value * x.value - 1.0));
+}
+
+template <std::size_t N>
+dual<N> fabs(const dual<N> &x) noexcept
+{
+  return x.value < 0.0 ? -x : x;
+}
+
+template <std::size_t N>
+dual<N> abs(const dual<N> &x) noexcept
+{
+  return fabs(x);
+}
+
+template <std::size_t N>
+dual<N> copysign(const dual<N> &x, const dual<N> &y) noexcept
+{
+  return std::signbit(x.value) == std::signbit(y.value) ? x : -x;
+}
+
+template <std::size_t N>
+dual<N> copysign(const dual<N> &x, const double y) noexcept
+{
+  return std::signbit(x.value) == std::signbit(y) ? x : -x;
+}
+
+/**
+ * The remainder of `x / y`; its derivatives equal those of `x`, as the
+ * quotient is a piecewise constant integer.
+ */
+template <std::size_t N>
+dual<N> fmod(dual<N> x, const double y) noexcept
+{
+  x.value = std::fmod(x.value, y);
+  return x;
+}
+
+template <std::size_t N>
+dual<N> fmax(const dual<N> &x, const dual<N> &y) noexcept
+{
+  return x.value < y.value ? y : x;
+}
+
+template <std::size_t N>
+dual<N> fmax(const dual<N> &x, const double y) noexcept
+{
+  return x.value < y ? dual<N>(y) : x;
+}
+
+template <std::size_t N>
+dual<N> fmax(const double x, const dual<N> &y) noexcept
+{
+  return fmax(y, x);
+}
+
+template <std::size_t N>
+dual<N> fmin(const dual<N> &x, const dual<N> &y) noexcept
+{
+  return y.value < x.value ? y : x;
+}
+
+template <std::size_t N>
+dual<N> fmin(const dual<N> &x, const double y) noexcept
+{
+  return y < x.value ? dual<N>(y) : x;
+}
+
+template <std::size_t N>
+dual<N> fmin(const double x, const dual<N> &y) noexcept
+{
+  return fmin(y, x);
+}
+
+template <std::size_t N>
+bool isfinite(const dual<N> &x) noexcept
+{
+  return std::isfinite(x.value);
+}
+
+template <std::size_t N>
+bool isnan(const dual<N> &x) noexcept
+{
+  return std::isnan(x.value);
+}
+
+} // namespace dual_numbers
+
+using dual_numbers::dual;
+
+/**
+ * The dual number used for gradients (see `forward_gradient`). Each
+ * evaluation propagates 8 partial derivatives, which fills two AVX registers
+ * per operation.
+ */
+typedef dual<8> gradient_dual;
+
+/**
+ * Returns the value of `x`, e.g. for branches of functions templated on their
+ * scalar type.
+ */
+inline double value_of(const double x) noexcept
+{
+  return x;
+}
+
+template <std::size_t N>
+double value_of(const dual<N> &x) noexcept
+{
+  return x.value;
+}
+
+/**
+ * Returns the derivative of the univariate function `f` at `x`, i.e. calls `f`
+ * once with a `dual<1>`.
+ */
+template <typename Function>
+double derivative(Function &&f, const double x)
+{
+  dual<1> variable(x);
+  variable.derivatives[0] = 1.0;
+  return f(variable).derivatives[0];
+}
+
+/**
+ * Computes the gradient of `f` at `agent` (`dimension` elements) by forward-
+ * mode automatic differentiation, writes it into `gradient` and returns
+ * the value of `f`.
+ *
+ * `f` may be any callable `gradient_dual(const gradient_dual *)`. It is
+ * called once per chunk of 8 variables, each time seeding the derivatives of
+ * the next chunk, so the gradient costs `ceil(dimension / 8)` evaluations in
+ * dual numbers, instead of `2 * dimension` evaluations for central
+ * differences.
+ */
+template <typename Function>
+double forward_gradient(Function &&f, const double *agent, const std::size_t dimension,
+                        double *gradient)
+{
+  const std::size_t chunk_size = gradient_dual().derivatives.size();
+
+  std::vector<gradient_dual> variables(agent, agent + dimension);
+  double value = 0.0;
+
+  std::size_t first = 0;
+  do
+  {
+    const std::size_t last = std::min(first + chunk_size, dimension);
+
+    for (std::size_t n = first; n < last; ++n)
+    {
+      variables[n].derivatives[n - first] = 1.0;
+    }
+
+    const gradient_dual result = f(variables.data());
+    value = result.value;
+
+    for (std::size_t n = first; n < last; ++n)
+    {
+      gradient[n] = result.derivatives[n - first];
+      variables[n].derivatives[n - first] = 0.0;
+    }
+
+    first = last;
+  } while (first < dimension);
+
+  return value;
+}
+} // namespace pass
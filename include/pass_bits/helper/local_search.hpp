@@ -0,0 +1,52 @@
+#pragma once
+
+#include "pass_bits/optimiser.hpp"
+#include <chrono> // std::chrono::nanoseconds
+
+namespace pass
+{
+/**
+ * Local searches that polish `result.normalised_agent` (with its
+ * `result.fitness_value`) within the normalised bounds [0, 1], e.g. to finish
+ * the basin a swarm converged to.
+ *
+ * Both stop once they converge, `result` is solved, or they performed
+ * `maximal_evaluations` evaluations or ran for `maximal_duration`. They
+ * replace the agent of `result` only by better ones and add their
+ * evaluations to `result.evaluations` (and `result.gradient_evaluations`),
+ * but don't change `result.iterations`.
+ */
+
+/**
+ * Projected L-BFGS with bounds (similar to L-BFGS-B, but the variables at a
+ * bound whose gradient points outwards are fixed, instead of searching the
+ * generalised Cauchy point), using `problem::normalised_gradient`. Intended
+ * for problems with `problem::has_gradient`. Each gradient is charged to
+ * `result.evaluations` (and `maximal_evaluations`) as `ceil(dimension / 8)`
+ * evaluations with `problem::has_gradient`, and as the 2 evaluations per
+ * dimension of the central differences otherwise. A gradient is only
+ * computed if the remaining evaluations cover its cost, so that
+ * `maximal_evaluations` is never exceeded.
+ *
+ * Steps are accepted by a backtracking line search on the projected path
+ * (Armijo condition), so non-finite objective values are backtracked from.
+ * Converges once the projected gradient is below 1e-8.
+ */
+void bounded_lbfgs(optimise_result &result, const arma::uword maximal_evaluations,
+                   const std::chrono::nanoseconds maximal_duration);
+
+/**
+ * Compass search: Polls the 2 neighbours along each coordinate at distance
+ * `step_size`, moves to the best one if it improves the agent, and halves
+ * the step size otherwise. Each neighbour changes a single coordinate, so
+ * problems with `problem::has_delta_evaluation` evaluate it with
+ * `problem::evaluate_delta` (costing one more evaluation to initialise the
+ * delta state). Otherwise, the neighbours of a poll are evaluated with
+ * `problem::evaluate_normalised_batch`, in batches of at most 64.
+ *
+ * Converges once the step size is below 1e-9.
+ */
+void pattern_search(optimise_result &result, const double step_size,
+                    const arma::uword maximal_evaluations,
+                    const std::chrono::nanoseconds maximal_duration);
+} // namespace pass
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <armadillo> // arma::vec, arma::uword
+#include <string>    // std::string
+
+namespace pass
+{
+/**
+ * Stores tuned optimiser parameters, keyed by problem name, optimiser name,
+ * host and dimension.
+ *
+ * All profiles are kept in one binary file of fixed-size records, sorted by
+ * their key, so that a profile is found by binary search. The file starts
+ * with the 8 bytes `PASSREG1` and the number of records (`arma::uword`).
+ * Each record consists of the problem name, optimiser name and host
+ * (64 characters each, zero padded), the dimension (`arma::uword`) and the
+ * parameters (`parameters_per_profile` doubles).
+ */
+class parameter_registry
+{
+public:
+  /**
+   * The number of parameters stored per profile.
+   */
+  static constexpr arma::uword parameters_per_profile = 5;
+
+  /**
+   * The file in which the profiles are stored.
+   */
+  const std::string file_name;
+
+  /**
+   * Uses the registry stored in `file_name`. Defaults to
+   * `parameter_registry.pass` in `pass::profile_directory()`.
+   */
+  parameter_registry();
+  explicit parameter_registry(const std::string &file_name);
+
+  /**
+   * Stores `parameters` for the current host, replacing an existing profile
+   * with the same key.
+   */
+  void store(const std::string &problem_name, const std::string &optimiser_name,
+             const arma::uword dimension, const arma::vec &parameters) const;
+
+  /**
+   * Returns `true` and sets `parameters`, if a profile with exactly this key
+   * exists for the current host.
+   */
+  bool find(const std::string &problem_name, const std::string &optimiser_name,
+            const arma::uword dimension, arma::vec &parameters) const;
+
+  /**
+   * Returns `true` and sets `parameters` to the exact profile, if it exists.
+   * Otherwise, each parameter is predicted from the profiles of the same
+   * problem and optimiser in other dimensions with a linear regression over
+   * log(dimension) (see `pass::regression`). Profiles of the current host are
+   * preferred over those of other hosts.
+   *
+   * Returns `false` if there are no profiles of the problem and optimiser.
+   */
+  bool predict(const std::string &problem_name, const std::string &optimiser_name,
+               const arma::uword dimension, arma::vec &parameters) const;
+};
+} // namespace pass
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string> // std::string
+
+namespace pass
+{
+/**
+ * Returns the name of the machine this process runs on.
+ *
+ * Used to key machine-specific profiles (e.g. the OpenMP speedup model), so
+ * that a shared home directory on a cluster keeps one profile per host.
+ */
+std::string host_name();
+
+/**
+ * Returns the directory in which PASS stores its profiles.
+ *
+ * The directory is taken from the environment variable `PASS_PROFILE_DIRECTORY`
+ * or defaults to `$HOME/.pass`. If neither is available, the current
+ * directory is used. The directory is created if it does not exist.
+ */
+std::string profile_directory();
+
+/**
+ * Returns the path of the profile `name` for the current host, e.g.
+ * `$HOME/.pass/openmp_model_<host>.pass`.
+ */
+std::string profile_path(const std::string &name);
+
+} // namespace pass
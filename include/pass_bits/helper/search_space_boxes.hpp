@@ -0,0 +1,66 @@
+#pragma once
+
+#include "pass_bits/problem.hpp"
+#include <vector> // std::vector
+
+namespace pass
+{
+/**
+ * An axis-aligned region of a problem's search space.
+ */
+struct search_box
+{
+  arma::vec lower_bounds;
+  arma::vec upper_bounds;
+};
+
+/**
+ * This helper class restricts a wrapped problem to the union of a set of
+ * boxes (e.g. the result of `pass::prune_search_space`), so that optimisers
+ * only sample these regions.
+ *
+ * The problem has the same dimension as the wrapped problem, with bounds
+ * [0, 1] in each dimension. The first coordinate selects the box (in
+ * proportion to its volume) and its position along the first dimension; the
+ * remaining coordinates are mapped to the box like normalised agents. A
+ * uniformly distributed agent is therefore uniformly distributed within the
+ * union of the boxes.
+ */
+class search_space_boxes : public problem
+{
+public:
+  /**
+   * The internal problem to which `evaluate` calls are forwarded.
+   *
+   * CAUTION: This variable is a reference type! Do not free or reuse the
+   * memory of `wrapped_object` until `search_space_boxes` is destroyed!
+   */
+  const pass::problem &wrapped_problem;
+
+  /**
+   * The boxes, within the bounds of `wrapped_problem`.
+   */
+  const std::vector<search_box> boxes;
+
+  /**
+   * Throws `std::invalid_argument` if `boxes` is empty, or a box doesn't match
+   * the dimension of `wrapped_problem` or has no volume.
+   */
+  search_space_boxes(const pass::problem &wrapped_problem,
+                     const std::vector<search_box> &boxes);
+
+  double evaluate(const arma::vec &agent) const override;
+
+  /**
+   * Maps `agent` of this problem to the corresponding agent of
+   * `wrapped_problem`, e.g. to translate an optimisation result.
+   */
+  arma::vec wrapped_agent(const arma::vec &agent) const;
+
+private:
+  /**
+   * The cumulative volume fractions of the boxes; the last entry is 1.
+   */
+  arma::vec cumulative_volumes;
+};
+} // namespace pass
@@ -57,6 +57,27 @@ struct optimise_result
    */
   arma::uword evaluations;
 
+  /**
+   * The number of times `problem.evaluate_low_fidelity` was called to screen
+   * agents, and the number of agents among them that were discarded without
+   * calling `problem.evaluate`.
+   */
+  arma::uword low_fidelity_evaluations;
+  arma::uword screened_out_agents;
+
+  /**
+   * The number of evaluations that the problem aborted early, because the
+   * agent couldn't improve the personal best of its particle (see
+   * `problem::evaluate` with cutoff). They are included in `evaluations`.
+   */
+  arma::uword aborted_evaluations;
+
+  /**
+   * The number of times `problem.gradient` was called, e.g. by a local search
+   * (see `pass::bounded_lbfgs`). Their cost is charged to `evaluations`.
+   */
+  arma::uword gradient_evaluations;
+
   /**
    * Total time in nanoseconds (10^-9) the optimiser took to find `objective_value`.
    */
@@ -70,6 +91,12 @@ struct optimise_result
    */
   bool solved() const;
 
+  /**
+   * Returns the share of screened agents that were discarded, or 0 if no
+   * agent was screened.
+   */
+  double screening_rate() const;
+
   /**
    * Returns `normalised_agent`, but mapped to the search space of `problem`.
    */
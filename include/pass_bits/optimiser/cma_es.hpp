@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pass_bits/optimiser.hpp"
+
+namespace pass
+{
+/**
+ * Implements the Covariance Matrix Adaptation Evolution Strategy (CMA-ES)
+ * with restarts and increasing population size (IPOP-CMA-ES), as described in
+ * N. Hansen, "The CMA Evolution Strategy: A Tutorial"
+ * (https://arxiv.org/abs/1604.00772) and A. Auger, N. Hansen, "A Restart
+ * CMA Evolution Strategy With Increasing Population Size" (CEC 2005).
+ *
+ * The search happens in the normalised search space [0, 1]. Offspring outside
+ * of it are mirrored at the bounds, and the mirrored offspring are used for
+ * the update.
+ *
+ * Each generation:
+ * - The offspring are sampled at once, as a product of the scaled
+ *   eigenvectors of the covariance matrix with a matrix of normally
+ *   distributed numbers.
+ * - They are evaluated with `problem::evaluate_normalised_batch`, split
+ *   across the MPI ranks of `communicator` and the threads of each rank.
+ * - The rank-mu update of the covariance matrix is a single matrix product of
+ *   the weighted selected steps.
+ * - The eigendecomposition of the covariance matrix is only updated every
+ *   `population_size / (10 * dimension * (c_1 + c_mu))` generations (about
+ *   `dimension / 5` for the default population size), as proposed by Hansen.
+ *
+ * A run is restarted from a random mean with `population_growth` times the
+ * population size once its step size falls below 1e-12, the covariance matrix
+ * becomes ill-conditioned (condition number above 1e14), or the best fitness
+ * values of the last `10 + 30 * dimension / population_size` generations and
+ * the finite fitness values of the current one differ by less than 1e-12.
+ * The optimiser stops like the others (see `optimiser`); `iterations`
+ * counts the generations of all runs.
+ */
+class cma_es : public optimiser
+{
+public:
+  /**
+   * The number of offspring of the first run. Must be greater or equal
+   * than 2, or 0.
+   *
+   * Is initialized to `0`, i.e. `4 + floor(3 * log(dimension))`.
+   */
+  arma::uword population_size;
+
+  /**
+   * The initial standard deviation of the offspring, in normalised
+   * coordinates. Must be greater than 0.
+   *
+   * Is initialized to `0.3`.
+   */
+  double initial_step_size;
+
+  /**
+   * The factor by which the population size grows with each restart. Must be
+   * greater or equal than 1.
+   *
+   * Is initialized to `2`.
+   */
+  double population_growth;
+
+#if defined(SUPPORT_MPI)
+  /**
+   * The MPI ranks of this communicator share the evaluations of each
+   * generation. The offspring are sampled on rank 0, so that all ranks follow
+   * the same search. With a single rank (e.g. `MPI_COMM_SELF`), each rank
+   * searches on its own.
+   *
+   * Is initialized to `MPI_COMM_WORLD`.
+   */
+  MPI_Comm communicator;
+#endif
+
+  /**
+   * Initializes an object of this type.
+   */
+  cma_es() noexcept;
+
+  virtual optimise_result optimise(const pass::problem &problem);
+
+private:
+  /**
+   * The number of threads if openMP is enabled
+   *
+   * Is initialized to maximum available threads
+   */
+#if defined(SUPPORT_OPENMP)
+  int number_threads;
+#endif
+};
+} // namespace pass
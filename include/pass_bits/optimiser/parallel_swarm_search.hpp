@@ -56,6 +56,117 @@ public:
    */
   double neighbourhood_probability;
 
+  /**
+   * If `true`, the inertia, accelerations and neighbourhood probability are
+   * adapted during the optimisation instead of being fixed, based on the
+   * success history of the particles (similar to SHADE):
+   * - Before each iteration, every particle draws its own parameters around a
+   *   randomly chosen entry of a history of 5 parameter sets.
+   * - After each iteration, the parameters of the particles that improved
+   *   their personal best are averaged, weighted by the improvement, and
+   *   replace the oldest history entry.
+   *
+   * The parameters set above are the initial history.
+   *
+   * Is initialized to `false`.
+   */
+  bool self_adaptive;
+
+  /**
+   * If `true` and the problem provides a low fidelity (see
+   * `problem::has_low_fidelity`), each moved particle is first evaluated with
+   * `problem::evaluate_low_fidelity`. Only if this value could improve its
+   * personal best, i.e. is less than the personal best plus
+   * `screening_tolerance` times its magnitude, the particle is evaluated
+   * exactly. Otherwise, it keeps its personal best.
+   *
+   * The initial swarm is always evaluated exactly. `optimise_result` counts
+   * the screened and discarded particles; `evaluations` only counts the
+   * exact evaluations.
+   *
+   * Screening only saves time while the mean low-fidelity evaluation costs
+   * less than the share of screened out particles times the mean exact
+   * evaluation. Both are timed from the fifth screening iteration on, and
+   * screening is turned off for the rest of the run once this no longer
+   * holds. On `messenger_full`, 10 - 33% of the moved particles are screened
+   * out (5 runs of 100000 exact evaluations, default parameters), while a
+   * low-fidelity evaluation costs about 69% of an exact one (see
+   * `pass::low_fidelity`), so screening is turned off after five iterations.
+   *
+   * Is initialized to `false`.
+   */
+  bool multi_fidelity;
+
+  /**
+   * The relative error of the low fidelity that is tolerated when screening
+   * particles (see `multi_fidelity`). Must be greater or equal than 0.
+   *
+   * Is initialized to `0.01`.
+   */
+  double screening_tolerance;
+
+  /**
+   * If greater than 0 and less than the problem dimension, and the problem
+   * supports delta evaluations (see `problem::has_delta_evaluation`), the
+   * problem is optimised by cooperative coevolution:
+   * - The coordinates are randomly split into groups of
+   *   `coevolution_group_size` coordinates in each cycle.
+   * - For each group in turn, a swarm optimises only these coordinates for
+   *   `coevolution_iterations` iterations, while the other coordinates are
+   *   fixed to the best agent found so far (the context). Each of its
+   *   evaluations costs O(`coevolution_group_size`) for separable problems.
+   * - Improvements are written back into the context.
+   *
+   * The swarm of each group uses the parameters of this optimiser. With MPI,
+   * the ranks of `communicator` share the context and each optimises a
+   * different group at the same time; after each round, the improvements are
+   * written back into the context of all ranks, one group after the other.
+   *
+   * Is initialized to `0`, i.e. all coordinates are optimised together.
+   */
+  arma::uword coevolution_group_size;
+
+  /**
+   * The number of iterations for each group during cooperative coevolution
+   * (see `coevolution_group_size`). Must be greater than 0.
+   *
+   * Is initialized to `20`.
+   */
+  arma::uword coevolution_iterations;
+
+  /**
+   * If greater than 0, the best personal bests are polished by a local search
+   * once the best fitness value didn't improve for `polishing_stall`
+   * iterations:
+   * - The `polishing_candidates` best particles, whose personal best changed
+   *   since it was last polished, are polished concurrently (one per thread).
+   * - Problems with `problem::has_gradient` are polished with
+   *   `pass::bounded_lbfgs`, others with `pass::pattern_search`, starting with
+   *   the standard deviation of the personal bests as step size.
+   * - Each local search may perform up to `polishing_evaluations`
+   *   evaluations. Improvements replace the personal bests, and the swarm
+   *   continues afterwards.
+   *
+   * Is initialized to `0`, i.e. no polishing.
+   */
+  arma::uword polishing_stall;
+
+  /**
+   * The number of personal bests that are polished (see `polishing_stall`).
+   * Must be greater than 0.
+   *
+   * Is initialized to `1`, i.e. only the best agent.
+   */
+  arma::uword polishing_candidates;
+
+  /**
+   * The maximal number of evaluations of each local search (see
+   * `polishing_stall`).
+   *
+   * Is initialized to `1000`.
+   */
+  arma::uword polishing_evaluations;
+
 #if defined(SUPPORT_MPI)
   /**
    * Denotes the migration invervall for the MPI Communication
@@ -63,6 +174,35 @@ public:
    * Is initialized to 0 i.e. MPI after every iteration
    */
   arma::uword migration_stall;
+
+  /**
+   * The MPI ranks of this communicator are the islands that exchange their
+   * best agents. With a single rank (e.g. `MPI_COMM_SELF`), no migrations
+   * are performed.
+   *
+   * Is initialized to `MPI_COMM_WORLD`.
+   */
+  MPI_Comm communicator;
+#endif
+
+#if defined(SUPPORT_OPENMP)
+  /**
+   * If `true`, the parallel execution is tuned while optimising:
+   * - The evaluation times of the initial swarm decide between a static
+   *   (similar evaluation times) and a dynamic (varying evaluation times)
+   *   distribution of the particles to the threads.
+   * - During the first iterations, the number of threads is halved as long as
+   *   this reduces the duration of an iteration. A single thread executes the
+   *   swarm serially, without starting a parallel region.
+   * - Only numbers of threads that divide the swarm into equally sized
+   *   chunks are used, e.g. 20 instead of 24 threads for 40 particles, as
+   *   the remaining threads would be idle anyway.
+   *
+   * If `false`, all threads are used with a static distribution.
+   *
+   * Is initialized to `true`.
+   */
+  bool adaptive_parallelism;
 #endif
 
   /**
@@ -72,7 +212,24 @@ public:
 
   virtual optimise_result optimise(const pass::problem &problem);
 
+  /**
+   * Loads the parameters tuned for `problem` by `pass::search_parameters`
+   * from the parameter registry of this host. If `problem` was not tuned in
+   * its dimension, the parameters are predicted from other dimensions (see
+   * `parameter_registry::predict`).
+   *
+   * Returns `false` and keeps the current parameters if there is no profile
+   * of `problem`.
+   */
+  bool load_profile(const pass::problem &problem);
+
 private:
+  /**
+   * Optimises `problem` by cooperative coevolution (see
+   * `coevolution_group_size`).
+   */
+  optimise_result optimise_cooperatively(const pass::problem &problem);
+
   /**
    * The number of threads if openMP is enabled
    *
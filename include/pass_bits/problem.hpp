@@ -20,6 +20,37 @@ namespace pass
 class problem
 {
 public:
+  /**
+   * An agent together with partial results of its evaluation, which let
+   * `evaluate_delta` evaluate agents that differ in a few coordinates
+   * without evaluating all of them. Created by `initialise_delta_state`.
+   */
+  struct delta_state
+  {
+    /**
+     * The agent, in the search space of the problem.
+     */
+    arma::vec agent;
+
+    /**
+     * The objective value of `agent`.
+     */
+    double fitness_value;
+
+    /**
+     * Problem-specific partial results, e.g. the sum of all terms of a
+     * separable function.
+     */
+    arma::vec partial_results;
+
+    /**
+     * The number of coordinates updated since the partial results were last
+     * computed from scratch. Problems recompute them from time to time, so
+     * that rounding errors don't accumulate.
+     */
+    arma::uword updates;
+  };
+
   /**
    * Lower bound constraints for each problem dimension. An optimiser will never
    * evaluate a point outside of these bounds.
@@ -71,6 +102,86 @@ public:
    */
   virtual double evaluate(const arma::vec &agent) const = 0;
 
+  /**
+   * Evaluates this problem at `agent`, but may stop as soon as its objective
+   * value is known to exceed `cutoff` (e.g. the personal best of a particle).
+   * Then, `is_aborted` is set to `true` and a lower bound of the objective
+   * value is returned, which is greater than `cutoff`. Otherwise,
+   * `is_aborted` is set to `false` and the objective value is returned.
+   *
+   * Calls `evaluate`, unless overridden by problems whose objective value
+   * accumulates non-negative parts.
+   */
+  virtual double evaluate(const arma::vec &agent, const double cutoff, bool &is_aborted) const;
+
+  /**
+   * Evaluates all `agents`, stored column-wise, and returns their fitness
+   * values. Calls `evaluate` for each agent, unless overridden by problems
+   * that evaluate multiple agents faster together.
+   */
+  virtual arma::rowvec evaluate_batch(const arma::mat &agents) const;
+
+  /**
+   * Returns `true` if `evaluate_low_fidelity` is cheaper than `evaluate`, i.e.
+   * if it's worth screening agents with it.
+   */
+  virtual bool has_low_fidelity() const;
+
+  /**
+   * Evaluates an approximation of this problem at `agent`, which is cheaper
+   * than `evaluate` (e.g. with looser solver tolerances). Optimisers may use
+   * it to skip the exact evaluation of agents that can't compete.
+   *
+   * Calls `evaluate`, unless overridden together with `has_low_fidelity`.
+   */
+  virtual double evaluate_low_fidelity(const arma::vec &agent) const;
+
+  /**
+   * Returns `true` if `evaluate_delta` costs O(k) for k changed coordinates,
+   * instead of evaluating the whole agent.
+   */
+  virtual bool has_delta_evaluation() const;
+
+  /**
+   * Evaluates `agent`, stores it together with its partial results in
+   * `state` and returns its objective value.
+   */
+  virtual double initialise_delta_state(const arma::vec &agent, delta_state &state) const;
+
+  /**
+   * Returns the objective value of the agent of `state`, with its
+   * coordinates `changed_indices` (which must be distinct) set to
+   * `new_values`. `state` is not changed, so several threads may evaluate
+   * deltas of the same state.
+   *
+   * The result equals `evaluate` up to rounding. Calls `evaluate`, unless
+   * overridden together with `has_delta_evaluation`.
+   */
+  virtual double evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                const arma::vec &new_values) const;
+
+  /**
+   * Sets the coordinates `changed_indices` of the agent of `state` to
+   * `new_values`, and updates its partial results and objective value.
+   */
+  virtual void update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                  const arma::vec &new_values) const;
+
+  /**
+   * Returns `true` if `gradient` is exact (e.g. computed by automatic
+   * differentiation, see `pass::dual`), instead of approximated by finite
+   * differences.
+   */
+  virtual bool has_gradient() const;
+
+  /**
+   * Returns the gradient of the objective function at `agent`.
+   *
+   * Approximates it by central differences, i.e. 2 evaluations per
+   * dimension, unless overridden together with `has_gradient`.
+   */
+  virtual arma::vec gradient(const arma::vec &agent) const;
+
   /**
    * Evaluates this problem at `agent`, which must be a normalized vector (all
    * values must be in range [0, 1]). `agent` is mapped to the problem
@@ -78,6 +189,30 @@ public:
    */
   double evaluate_normalised(const arma::vec &normalised_agent) const;
 
+  /**
+   * Evaluates `normalised_agent` with a `cutoff` (see `evaluate` and
+   * `evaluate_normalised`).
+   */
+  double evaluate_normalised(const arma::vec &normalised_agent, const double cutoff, bool &is_aborted) const;
+
+  /**
+   * Evaluates all `normalised_agents`, stored column-wise, with
+   * `evaluate_batch` (see `evaluate_normalised`).
+   */
+  arma::rowvec evaluate_normalised_batch(const arma::mat &normalised_agents) const;
+
+  /**
+   * Evaluates `normalised_agent` with `evaluate_low_fidelity` (see
+   * `evaluate_normalised`).
+   */
+  double evaluate_normalised_low_fidelity(const arma::vec &normalised_agent) const;
+
+  /**
+   * Returns the gradient at `normalised_agent` with respect to the normalised
+   * coordinates (see `gradient` and `evaluate_normalised`).
+   */
+  arma::vec normalised_gradient(const arma::vec &normalised_agent) const;
+
   /**
    * Draws `count` uniformly distributed random agents from range [0, 1], stored
    * column-wise.
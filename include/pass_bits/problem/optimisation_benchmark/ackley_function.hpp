@@ -40,5 +40,12 @@ public:
   explicit ackley_function(const arma::uword dimension);
 
   double evaluate(const arma::vec &agent) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Computed by automatic differentiation (see `pass::forward_gradient`).
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
 };
 } // namespace pass
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
 
 namespace pass
 {
@@ -27,7 +27,7 @@ namespace pass
 //     Σ (p(i)²)
 //    i=1
 
-class de_jong_function : public problem
+class de_jong_function : public separable_function
 {
 public:
   /**
@@ -36,6 +36,9 @@ public:
    */
   explicit de_jong_function(const arma::uword dimension);
 
-  double evaluate(const arma::vec &agent) const override;
+protected:
+  double term(const arma::uword index, const double value) const override;
+
+  double term_derivative(const arma::uword index, const double value) const override;
 };
 } // namespace pass
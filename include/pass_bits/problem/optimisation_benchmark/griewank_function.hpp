@@ -37,5 +37,47 @@ public:
   explicit griewank_function(const arma::uword dimension);
 
   double evaluate(const arma::vec &agent) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Computed by automatic differentiation (see `pass::forward_gradient`).
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
+
+  /**
+   * The delta state caches the sum of squares and the product of cosines.
+   * The product is stored as the sum of the logarithms of its absolute
+   * factors, together with the number of zero and negative factors. This
+   * way, a factor can be replaced in O(1), even if it is zero.
+   */
+  bool has_delta_evaluation() const override;
+
+  double initialise_delta_state(const arma::vec &agent, delta_state &state) const override;
+
+  double evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                        const arma::vec &new_values) const override;
+
+  void update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                          const arma::vec &new_values) const override;
+
+private:
+  /**
+   * Replaces the coordinate `index` of value `old_value` by `new_value` in the
+   * partial results (sum of squares, sum of logarithms, number of zero
+   * factors and number of negative factors).
+   */
+  void replace(arma::vec &results, const arma::uword index,
+               const double old_value, const double new_value) const;
+
+  /**
+   * Returns the objective value of the partial results.
+   */
+  double fitness_value(const arma::vec &results) const;
+
+  /**
+   * Computes the partial results of `agent` from scratch.
+   */
+  arma::vec partial_results(const arma::vec &agent) const;
 };
 } // namespace pass
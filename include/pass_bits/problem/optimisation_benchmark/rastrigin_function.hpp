@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
 
 namespace pass
 {
@@ -33,7 +33,7 @@ namespace pass
 //    10 * D + ∑ ⎜p(i)² - 10 * cos(2π * p(i))⎟
 //            i=1⎝                            ⎠
 //
-class rastrigin_function : public problem
+class rastrigin_function : public separable_function
 {
 public:
   /**
@@ -42,6 +42,9 @@ public:
    */
   explicit rastrigin_function(const arma::uword dimension);
 
-  double evaluate(const arma::vec &agent) const override;
+protected:
+  double term(const arma::uword index, const double value) const override;
+
+  double term_derivative(const arma::uword index, const double value) const override;
 };
 } // namespace pass
@@ -47,5 +47,12 @@ public:
   explicit rosenbrock_function(const arma::uword dimension);
 
   double evaluate(const arma::vec &agent) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Computed by automatic differentiation (see `pass::forward_gradient`).
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
 };
 } // namespace pass
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
 
 namespace pass
 {
@@ -32,7 +32,7 @@ namespace pass
 // 418.9828872724338 * D - ∑ ⎜ p(i) * sin(√ ||p(i)||) ⎟
 //                        i=1⎝                        ⎠
 //
-class schwefel_function : public problem
+class schwefel_function : public separable_function
 {
 public:
   /**
@@ -41,6 +41,9 @@ public:
    */
   explicit schwefel_function(const arma::uword dimension);
 
-  double evaluate(const arma::vec &agent) const override;
+protected:
+  double term(const arma::uword index, const double value) const override;
+
+  double term_derivative(const arma::uword index, const double value) const override;
 };
 } // namespace pass
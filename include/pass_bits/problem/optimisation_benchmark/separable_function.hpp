@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pass_bits/helper/dual.hpp"
+#include "pass_bits/problem.hpp"
+
+namespace pass
+{
+/**
+ * Base of the benchmark functions that sum independent terms of each
+ * coordinate:
+ *
+ * \f[
+ *   f(x_1 \cdots x_n) = offset + scale \cdot \sum_{i=1}^n term_i(x_i)
+ * \f]
+ *
+ * The sum is cached in `problem::delta_state`, so that `evaluate_delta` only
+ * evaluates the terms of the changed coordinates. Changing k coordinates then
+ * costs O(k) instead of O(n), e.g. in cooperative coevolution (see
+ * `parallel_swarm_search::coevolution_group_size`).
+ */
+class separable_function : public problem
+{
+public:
+  double evaluate(const arma::vec &agent) const override;
+
+  bool has_delta_evaluation() const override;
+
+  double initialise_delta_state(const arma::vec &agent, delta_state &state) const override;
+
+  double evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                        const arma::vec &new_values) const override;
+
+  void update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                          const arma::vec &new_values) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Each term only depends on its own coordinate, so the gradient consists of
+   * the derivatives of the terms (see `term_derivative`), in O(dimension).
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
+
+protected:
+  separable_function(const arma::uword dimension, const double lower_bound,
+                     const double upper_bound, const std::string &name,
+                     const double offset, const double scale);
+
+  /**
+   * Returns the term of the coordinate `index` with value `value`.
+   */
+  virtual double term(const arma::uword index, const double value) const = 0;
+
+  /**
+   * Returns the derivative of `term` with respect to `value`, e.g. computed
+   * with `pass::derivative` from a term templated on its scalar type.
+   */
+  virtual double term_derivative(const arma::uword index, const double value) const = 0;
+
+private:
+  double offset;
+  double scale;
+
+  /**
+   * Returns the sum of the terms of all coordinates of `agent`.
+   */
+  double sum_of_terms(const arma::vec &agent) const;
+};
+} // namespace pass
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
 
 namespace pass
 {
@@ -28,7 +28,7 @@ namespace pass
 //   0.5  * ∑ ⎜p(i)⁴ - 16 * p(i)² + 5 * p(i)⎟
 //         i=1⎝                             ⎠
 //
-class styblinski_tang_function : public problem
+class styblinski_tang_function : public separable_function
 {
 public:
   /**
@@ -37,6 +37,9 @@ public:
    */
   explicit styblinski_tang_function(const arma::uword dimension);
 
-  double evaluate(const arma::vec &agent) const override;
+protected:
+  double term(const arma::uword index, const double value) const override;
+
+  double term_derivative(const arma::uword index, const double value) const override;
 };
 } // namespace pass
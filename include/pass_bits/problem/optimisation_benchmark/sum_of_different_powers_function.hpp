@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
 
 namespace pass
 {
@@ -26,7 +26,7 @@ namespace pass
 //     ∑  ⎜||p(i)||^(i + 1) ⎟
 //    i=1 ⎝                 ⎠
 //
-class sum_of_different_powers_function : public problem
+class sum_of_different_powers_function : public separable_function
 {
 public:
   /**
@@ -35,6 +35,9 @@ public:
    */
   explicit sum_of_different_powers_function(const arma::uword dimension);
 
-  double evaluate(const arma::vec &agent) const override;
+protected:
+  double term(const arma::uword index, const double value) const override;
+
+  double term_derivative(const arma::uword index, const double value) const override;
 };
 } // namespace pass
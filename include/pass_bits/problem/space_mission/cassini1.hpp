@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/space_mission/mga_problem.hpp"
 
 namespace pass
 {
@@ -8,14 +8,13 @@ namespace pass
  * `cassini1` is a 6-dimensional optimization problem issued by the ESA:
  * https://www.esa.int/gsp/ACT/projects/gtop/cassini1.html
  */
-class cassini1 : public problem
+class cassini1 : public mga_problem
 {
 public:
   /**
-   * Initializes the lower and upper bounds to the values listed on the ESA page.
+   * Initializes the mission and its bounds to the values listed on the ESA
+   * page (see `pass::missions::cassini1`).
    */
   cassini1();
-
-  double evaluate(const arma::vec &agent) const override;
 };
 } // namespace pass
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "pass_bits/helper/astro_problems/constants.hpp"
+#include "pass_bits/helper/astro_problems/ephemeris_table.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
 #include "pass_bits/problem.hpp"
+#include <map>
 
 namespace pass
 {
@@ -14,6 +17,9 @@ namespace pass
  * This code assumes a planet sequence has been defined, and evaluates the
  * impulse gained from a whole maneuver if the spacecraft arrives at the nth
  * planet at the point in time specified by the nth problem parameter.
+ *
+ * The default mission is also available as `pass::missions::gtoc1`, for
+ * which `pass::mga_problem` returns the same objective values.
  */
 class gtoc1 : public problem
 {
@@ -71,5 +77,32 @@ public:
   gtoc1();
 
   double evaluate(const arma::vec &agent) const override;
+
+private:
+  typedef std::array<std::array<double, 3>, 8> states;
+
+  /**
+   * Writes the positions `r` and velocities `v` of the sequence and the
+   * destination, and the time of flight and direction of the 7 legs.
+   */
+  void legs(const double *agent, states &r, states &v, double *time_of_flight,
+            bool *long_way) const;
+
+  /**
+   * Evaluates the fly-bys and the objective, given the Lambert arcs of all 7
+   * legs. The velocities store 3 consecutive values per leg.
+   */
+  double objective(const states &v, const double *departure_velocity,
+                   const double *arrival_velocity,
+                   const lambert_error *errors) const;
+
+  /**
+   * Precomputed ephemerides of the initial `sequence` and `destination`,
+   * covering all dates within the bounds. Bodies that are changed afterwards
+   * use their analytical ephemeris.
+   */
+  std::map<const celestial_body *, ephemeris_table> planet_ephemerides;
+  asteroid tabulated_destination;
+  ephemeris_table destination_ephemeris;
 };
 } // namespace pass
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/space_mission/mga_dsm_problem.hpp"
 
 namespace pass
 {
@@ -8,14 +8,13 @@ namespace pass
  * `messenger_full` is a 26-dimensional optimization problem issued by the ESA:
  * https://www.esa.int/gsp/ACT/projects/gtop/messenger_full.html
  */
-class messenger_full : public problem
+class messenger_full : public mga_dsm_problem
 {
 public:
   /**
-   * Initializes the lower and upper bounds to the values listed on the ESA page.
+   * Initializes the mission and its bounds to the values listed on the ESA
+   * page (see `pass::missions::messenger_full`).
    */
   messenger_full();
-
-  double evaluate(const arma::vec &agent) const override;
 };
 } // namespace pass
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "pass_bits/helper/astro_problems/mga_dsm.hpp"
+#include "pass_bits/helper/astro_problems/mission_description.hpp"
+#include "pass_bits/problem.hpp"
+
+namespace pass
+{
+/**
+ * A multiple gravity assist mission with one deep space manoeuvre (DSM) per
+ * leg, built from a `pass::mission_description`. For `n` bodies, the decision
+ * vector consists of the launch date (MJD2000), the escape velocity and its 2
+ * direction variables, the `n - 1` leg durations (days), the `n - 1` DSM
+ * timings, and the `n - 2` pericenter radii and b-plane angles of the
+ * fly-bys. For `time2AUs`, the b-plane angle of the last fly-by is appended
+ * (its pericenter radius shares the entry of the first angle, as in the ESA
+ * code).
+ *
+ * Supports all problem types except `asteroid_impact`. The mission is
+ * compiled once, with precomputed ephemerides covering all dates within the
+ * bounds.
+ */
+class mga_dsm_problem : public problem
+{
+public:
+  /**
+   * The mission this problem was built from.
+   */
+  const mission_description mission;
+
+  /**
+   * Throws `std::invalid_argument` if the description is malformed, or the
+   * bounds don't match the fly-by sequence.
+   */
+  explicit mga_dsm_problem(const mission_description &mission);
+  explicit mga_dsm_problem(const std::string &description);
+
+  double evaluate(const arma::vec &agent) const override;
+
+  /**
+   * Stops after the leg whose delta Vs exceed `cutoff` (see `MGA_DSM`).
+   */
+  double evaluate(const arma::vec &agent, const double cutoff, bool &is_aborted) const override;
+
+  bool has_delta_evaluation() const override;
+
+  /**
+   * Evaluates `agent` and stores its ephemerides and legs (a `mgadsmstate`)
+   * in the partial results of `state`.
+   */
+  double initialise_delta_state(const arma::vec &agent, delta_state &state) const override;
+
+  /**
+   * Reuses the ephemerides and legs of `state` that don't depend on the
+   * changed entries (see the incremental `MGA_DSM`). The legs are evaluated
+   * in sequence, so changing an entry of a leg (its time of flight, DSM
+   * timing, or the fly-by before it) recomputes this and all later legs; the
+   * launch entries recompute all.
+   */
+  double evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                        const arma::vec &new_values) const override;
+
+  void update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                          const arma::vec &new_values) const override;
+
+  bool has_low_fidelity() const override;
+
+  /**
+   * Evaluates `agent` with `fidelity::low` (see `set_fidelity`).
+   */
+  double evaluate_low_fidelity(const arma::vec &agent) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Computed by automatic differentiation (see `pass::forward_gradient`),
+   * always with the analytical ephemerides, as the ephemeris table isn't
+   * differentiable.
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
+
+  /**
+   * Sets the accuracy of the Lambert solvers for subsequent evaluations.
+   * With `fidelity::low`, the arcs up to the DSMs are also propagated with
+   * the universal variables. An evaluation of Messenger or Rosetta is then
+   * about 31% faster and the objective values of good agents deviate by up
+   * to 2e-6 (relative; see `pass::low_fidelity`), so results should be
+   * re-evaluated at
+   * `fidelity::high` (the default). Copies of the problem share the
+   * ephemerides, so a low-fidelity copy is cheap.
+   */
+  void set_fidelity(const pass::fidelity level);
+
+private:
+  mgadsmplan plan;
+
+  /**
+   * A copy of `plan` with `fidelity::low`.
+   */
+  mgadsmplan low_fidelity_plan;
+};
+} // namespace pass
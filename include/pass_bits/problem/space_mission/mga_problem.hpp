@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pass_bits/helper/astro_problems/mga.hpp"
+#include "pass_bits/helper/astro_problems/mission_description.hpp"
+#include "pass_bits/problem.hpp"
+
+namespace pass
+{
+/**
+ * A multiple gravity assist (MGA) mission with a Lambert arc per leg, built
+ * from a `pass::mission_description`. The decision vector consists of the
+ * launch date (MJD2000) and the duration of each leg (days).
+ *
+ * Supports the problem types `total_DV_orbit_insertion` and
+ * `asteroid_impact`. The mission is compiled once, with precomputed
+ * ephemerides covering all dates within the bounds.
+ */
+class mga_problem : public problem
+{
+public:
+  /**
+   * The mission this problem was built from.
+   */
+  const mission_description mission;
+
+  /**
+   * Throws `std::invalid_argument` if the description is malformed, or the
+   * bounds don't match the fly-by sequence.
+   */
+  explicit mga_problem(const mission_description &mission);
+  explicit mga_problem(const std::string &description);
+
+  double evaluate(const arma::vec &agent) const override;
+
+  /**
+   * Stops after the leg whose delta Vs exceed `cutoff` (see `MGA`).
+   */
+  double evaluate(const arma::vec &agent, const double cutoff, bool &is_aborted) const override;
+
+  bool has_delta_evaluation() const override;
+
+  /**
+   * Evaluates `agent` and stores its ephemerides, Lambert arcs and fly-bys
+   * (a `mgastate`) in the partial results of `state`.
+   */
+  double initialise_delta_state(const arma::vec &agent, delta_state &state) const override;
+
+  /**
+   * Reuses the ephemerides, Lambert arcs and fly-bys of `state` that don't
+   * depend on the changed entries (see the incremental `MGA`): Changing the
+   * `k`-th entry recomputes the legs from `k - 1` on, so changes of the later
+   * times of flight, e.g. by local searches, are cheap.
+   */
+  double evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                        const arma::vec &new_values) const override;
+
+  void update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                          const arma::vec &new_values) const override;
+
+  bool has_low_fidelity() const override;
+
+  /**
+   * Evaluates `agent` with `fidelity::low` (see `set_fidelity`).
+   */
+  double evaluate_low_fidelity(const arma::vec &agent) const override;
+
+  bool has_gradient() const override;
+
+  /**
+   * Computed by automatic differentiation (see `pass::forward_gradient`),
+   * always with the analytical ephemerides, as neither the ephemeris table
+   * nor the porkchop table are differentiable.
+   */
+  arma::vec gradient(const arma::vec &agent) const override;
+
+  /**
+   * Sets the accuracy of the Lambert and swing-by solvers for subsequent
+   * evaluations. With `fidelity::low`, an evaluation of Cassini 1 or GTOC 1
+   * is only about 11% faster and the objective values of good agents deviate
+   * by up to 0.2% (see `pass::low_fidelity`), so results should be
+   * re-evaluated at `fidelity::high` (the default). Copies of the problem
+   * share the ephemerides, so a low-fidelity copy is cheap.
+   */
+  void set_fidelity(const pass::fidelity level);
+
+  /**
+   * Enables the fast path for the first leg: Its Lambert arcs are
+   * interpolated from a `pass::porkchop_table` over the bounds of the launch
+   * date and the first time of flight, built with the given number of points
+   * (or loaded from `cache_file`). The objective values then differ from the
+   * exact ones by about the accuracy of the table.
+   */
+  void use_porkchop_table(const std::size_t launch_points = 256,
+                          const std::size_t time_of_flight_points = 256,
+                          const std::string &cache_file = "");
+
+  /**
+   * The compiled mission, as evaluated by `MGA`.
+   */
+  const mgaplan &compiled_mission() const;
+
+private:
+  mgaplan plan;
+
+  /**
+   * A copy of `plan` with `fidelity::low`.
+   */
+  mgaplan low_fidelity_plan;
+};
+} // namespace pass
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "pass_bits/problem.hpp"
+#include "pass_bits/problem/space_mission/mga_dsm_problem.hpp"
 
 namespace pass
 {
@@ -8,14 +8,13 @@ namespace pass
  * `rosetta` is a 22-dimensional optimization problem issued by the ESA:
  * https://www.esa.int/gsp/ACT/projects/gtop/rosetta.html
  */
-class rosetta : public problem
+class rosetta : public mga_dsm_problem
 {
 public:
   /**
-   * Initializes the lower and upper bounds to the values listed on the ESA page.
+   * Initializes the mission and its bounds to the values listed on the ESA
+   * page (see `pass::missions::rosetta`).
    */
   rosetta();
-
-  double evaluate(const arma::vec &agent) const override;
 };
 } // namespace pass
@@ -1,7 +1,397 @@
 #include "pass_bits/analyser/adaptive_parameter_search.hpp"
-#include "pass_bits/optimiser/parallel_swarm_search.hpp"
+#include "pass_bits/helper/parameter_registry.hpp"
 #include "pass_bits/helper/random.hpp"
-#include <iostream> // std::cout
+#include "pass_bits/helper/stopwatch.hpp"
+#include <algorithm> // std::sort, std::min
+#include <cmath>     // std::round, std::pow, std::sqrt, std::erfc
+#include <numeric>   // std::iota
+#include <iostream>  // std::cout
+
+namespace
+{
+/**
+ * Returns the elapsed time of `stopwatch`. With MPI, the maximum of all ranks
+ * is returned, so that all ranks take the same decisions.
+ */
+std::chrono::nanoseconds synchronised_elapsed(const pass::stopwatch &stopwatch)
+{
+  double elapsed = static_cast<double>(stopwatch.get_elapsed().count());
+
+#if defined(SUPPORT_MPI)
+  MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(elapsed));
+}
+
+/**
+ * Ranks the configurations `alive` within each of the first `runs` runs
+ * (1 = best, ties get the average rank). Solved runs are better than unsolved
+ * ones; solved runs are compared by their evaluations, unsolved runs by
+ * their fitness value.
+ */
+arma::mat rank_runs(const arma::mat &fitness_values, const arma::mat &evaluations,
+                    const std::vector<arma::uword> &alive, const arma::uword runs)
+{
+  arma::mat ranks(runs, alive.size());
+  std::vector<arma::uword> order(alive.size());
+
+  for (arma::uword run = 0; run < runs; ++run)
+  {
+    auto key = [&](const arma::uword n) {
+      const double run_evaluations = evaluations(run, alive[n]);
+      return run_evaluations > 0 ? std::make_pair(0, run_evaluations)
+                                 : std::make_pair(1, fitness_values(run, alive[n]));
+    };
+
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const arma::uword a, const arma::uword b) {
+      return key(a) < key(b);
+    });
+
+    for (arma::uword first = 0; first < order.size();)
+    {
+      arma::uword last = first + 1;
+      while (last < order.size() && key(order[last]) == key(order[first]))
+      {
+        ++last;
+      }
+
+      for (arma::uword n = first; n < last; ++n)
+      {
+        ranks(run, order[n]) = (first + last + 1) / 2.0;
+      }
+      first = last;
+    }
+  }
+
+  return ranks;
+}
+
+/**
+ * Returns the configurations of `alive` that are not significantly worse than
+ * the best one, using the Friedman test and its post-hoc comparison by
+ * Conover at a significance level of 5%.
+ */
+std::vector<arma::uword> friedman_survivors(const arma::mat &fitness_values, const arma::mat &evaluations,
+                                            const std::vector<arma::uword> &alive, const arma::uword runs)
+{
+  const double k = static_cast<double>(alive.size());
+  const double b = static_cast<double>(runs);
+
+  if (alive.size() < 2 || runs < 2)
+  {
+    return alive;
+  }
+
+  const arma::mat ranks = rank_runs(fitness_values, evaluations, alive, runs);
+  const arma::rowvec rank_sums = arma::sum(ranks, 0);
+
+  const double sum_of_squared_ranks = arma::accu(arma::square(ranks));
+  const double correction = b * k * (k + 1.0) * (k + 1.0) / 4.0;
+
+  if (sum_of_squared_ranks - correction <= 0.0)
+  {
+    // All runs are ties
+    return alive;
+  }
+
+  const double statistic = (k - 1.0) * arma::accu(arma::square(rank_sums - b * (k + 1.0) / 2.0)) /
+                           (sum_of_squared_ranks - correction);
+
+  // 95% quantile of the chi-squared distribution (Wilson-Hilferty approximation)
+  const double degrees_of_freedom = k - 1.0;
+  const double chi_squared = degrees_of_freedom *
+                             std::pow(1.0 - 2.0 / (9.0 * degrees_of_freedom) +
+                                          1.6449 * std::sqrt(2.0 / (9.0 * degrees_of_freedom)),
+                                      3.0);
+
+  if (statistic <= chi_squared)
+  {
+    return alive;
+  }
+
+  // 97.5% quantile of the Student's t-distribution (Cornish-Fisher expansion)
+  const double z = 1.96;
+  const double t_degrees_of_freedom = (b - 1.0) * (k - 1.0);
+  const double t = z + (z * z * z + z) / (4.0 * t_degrees_of_freedom) +
+                   (5.0 * std::pow(z, 5.0) + 16.0 * z * z * z + 3.0 * z) /
+                       (96.0 * t_degrees_of_freedom * t_degrees_of_freedom);
+
+  const double critical_difference =
+      t * std::sqrt(std::max(0.0, 2.0 * b * (sum_of_squared_ranks - correction) / t_degrees_of_freedom *
+                                      (1.0 - statistic / (b * (k - 1.0)))));
+
+  const double best_rank_sum = rank_sums.min();
+
+  std::vector<arma::uword> survivors;
+  for (arma::uword n = 0; n < alive.size(); ++n)
+  {
+    if (rank_sums(n) - best_rank_sum <= critical_difference)
+    {
+      survivors.push_back(alive[n]);
+    }
+  }
+
+  return survivors;
+}
+
+/**
+ * Search space of the parameter tuning. The parameters are tuned in the unit
+ * cube, mapped linearly to these bounds:
+ * swarm size, neighbourhood probability, inertia, cognitive and social acceleration
+ */
+const arma::vec parameter_lower_bounds({10.0, 1e-6, -1.0, 0.0, 0.0});
+const arma::vec parameter_upper_bounds({200.0, 1.0, 1.0, 2.5, 2.5});
+
+/**
+ * Sets the parameters of `algorithm` to the normalised `parameters`.
+ */
+void set_parameters(pass::parallel_swarm_search &algorithm, const arma::vec &parameters)
+{
+  const arma::vec values = parameter_lower_bounds + parameters % (parameter_upper_bounds - parameter_lower_bounds);
+
+  algorithm.swarm_size = static_cast<arma::uword>(std::round(values(0)));
+  algorithm.neighbourhood_probability = values(1);
+  algorithm.inertia = values(2);
+  algorithm.cognitive_acceleration = values(3);
+  algorithm.social_acceleration = values(4);
+}
+
+/**
+ * Returns the normalised parameters of `algorithm`.
+ */
+arma::vec get_parameters(const pass::parallel_swarm_search &algorithm)
+{
+  const arma::vec values({static_cast<double>(algorithm.swarm_size),
+                          algorithm.neighbourhood_probability,
+                          algorithm.inertia,
+                          algorithm.cognitive_acceleration,
+                          algorithm.social_acceleration});
+
+  return (values - parameter_lower_bounds) / (parameter_upper_bounds - parameter_lower_bounds);
+}
+
+/**
+ * Gaussian process regression with a squared exponential kernel, used as
+ * surrogate of the tuning objective.
+ */
+struct surrogate
+{
+  arma::mat points;
+  arma::mat lower_cholesky;
+  arma::vec weights;
+  double length_scale;
+  double mean;
+  double deviation;
+};
+
+/**
+ * Variance of the observation noise, relative to the standardised values.
+ */
+const double surrogate_noise = 0.05;
+
+arma::mat squared_exponential(const arma::mat &first_points, const arma::mat &second_points, const double length_scale)
+{
+  arma::mat covariance(first_points.n_cols, second_points.n_cols);
+
+  for (arma::uword col = 0; col < second_points.n_cols; ++col)
+  {
+    for (arma::uword row = 0; row < first_points.n_cols; ++row)
+    {
+      covariance(row, col) = std::exp(-arma::accu(arma::square(first_points.col(row) - second_points.col(col))) /
+                                      (2.0 * length_scale * length_scale));
+    }
+  }
+
+  return covariance;
+}
+
+/**
+ * Fits a Gaussian process to the `values` at `points` (one point per column).
+ * The length scale is chosen by the marginal likelihood.
+ */
+surrogate fit_surrogate(const arma::mat &points, const arma::vec &values)
+{
+  surrogate model;
+  model.points = points;
+  model.mean = arma::mean(values);
+  model.deviation = values.n_elem > 1 ? arma::stddev(values) : 1.0;
+  if (model.deviation <= 0.0)
+  {
+    model.deviation = 1.0;
+  }
+
+  const arma::vec standardised_values = (values - model.mean) / model.deviation;
+  double best_likelihood = -std::numeric_limits<double>::infinity();
+
+  for (const double length_scale : {0.05, 0.1, 0.2, 0.4, 0.8})
+  {
+    const arma::mat covariance = squared_exponential(points, points, length_scale) +
+                                 surrogate_noise * arma::eye(points.n_cols, points.n_cols);
+
+    arma::mat lower_cholesky;
+    if (!arma::chol(lower_cholesky, covariance, "lower"))
+    {
+      continue;
+    }
+
+    const arma::vec weights = arma::solve(arma::trimatu(lower_cholesky.t()),
+                                          arma::solve(arma::trimatl(lower_cholesky), standardised_values));
+    const double likelihood = -0.5 * arma::dot(standardised_values, weights) -
+                              arma::accu(arma::log(lower_cholesky.diag()));
+
+    if (likelihood > best_likelihood)
+    {
+      best_likelihood = likelihood;
+      model.lower_cholesky = lower_cholesky;
+      model.weights = weights;
+      model.length_scale = length_scale;
+    }
+  }
+
+  return model;
+}
+
+/**
+ * Returns the expected improvement of `point` over the best (lowest) value
+ * `best_value`, both on the standardised scale of `model`.
+ */
+double expected_improvement(const surrogate &model, const arma::vec &point, const double best_value)
+{
+  const arma::vec covariance = squared_exponential(model.points, point, model.length_scale);
+  const double mean = arma::dot(covariance, model.weights);
+  const arma::vec v = arma::solve(arma::trimatl(model.lower_cholesky), covariance);
+  const double deviation = std::sqrt(std::max(1e-12, 1.0 - arma::dot(v, v)));
+
+  const double z = (best_value - mean) / deviation;
+  const double cumulative = 0.5 * std::erfc(-z / std::sqrt(2.0));
+  const double density = std::exp(-0.5 * z * z) / std::sqrt(2.0 * arma::datum::pi);
+
+  return (best_value - mean) * cumulative + deviation * density;
+}
+
+/**
+ * Proposes `count` new normalised parameter vectors (one per column) by
+ * maximising the expected improvement. For each further proposal, the
+ * previous ones are assumed to evaluate to their predicted mean (kriging
+ * believer), so the batch spreads out.
+ */
+arma::mat propose_parameters(const arma::mat &points, const arma::vec &values, const arma::uword count)
+{
+  const arma::uword samples = 2000;
+
+  arma::mat proposals(points.n_rows, count);
+  arma::mat believed_points = points;
+  arma::vec believed_values = values;
+
+  for (arma::uword n = 0; n < count; ++n)
+  {
+    const surrogate model = fit_surrogate(believed_points, believed_values);
+    const double best_value = (believed_values.min() - model.mean) / model.deviation;
+    const arma::vec incumbent = believed_points.col(believed_values.index_min());
+
+    double best_improvement = -1.0;
+
+    for (arma::uword sample = 0; sample < samples; ++sample)
+    {
+      // Half of the samples explore the whole space, the other half the region of the best point
+      arma::vec candidate(points.n_rows);
+      for (arma::uword k = 0; k < candidate.n_elem; ++k)
+      {
+        candidate(k) = sample % 2 == 0 ? pass::random_double_uniform_in_range(0.0, 1.0)
+                                       : std::min(1.0, std::max(0.0, incumbent(k) + pass::random_double_uniform_in_range(-0.1, 0.1)));
+      }
+
+      const double improvement = expected_improvement(model, candidate, best_value);
+      if (improvement > best_improvement)
+      {
+        best_improvement = improvement;
+        proposals.col(n) = candidate;
+      }
+    }
+
+    const arma::vec covariance = squared_exponential(model.points, proposals.col(n), model.length_scale);
+    believed_points.insert_cols(believed_points.n_cols, proposals.col(n));
+    believed_values.resize(believed_values.n_elem + 1);
+    believed_values(believed_values.n_elem - 1) = model.mean + model.deviation * arma::dot(covariance, model.weights);
+  }
+
+#if defined(SUPPORT_MPI)
+  // All ranks must evaluate the same parameters
+  MPI_Bcast(proposals.memptr(), proposals.n_elem, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+
+  return proposals;
+}
+
+/**
+ * The tuning objective of each configuration, from its `runtimes` (lower is
+ * better): the negative share of the other configurations it beats
+ * according to `compare_segments`.
+ */
+arma::vec tuning_objective(const std::vector<arma::mat> &runtimes)
+{
+  arma::vec objective(runtimes.size(), arma::fill::zeros);
+
+  for (arma::uword first = 0; first < runtimes.size(); ++first)
+  {
+    for (arma::uword second = first + 1; second < runtimes.size(); ++second)
+    {
+      if (pass::compare_segments(runtimes[first], runtimes[second]) == 1)
+      {
+        objective(first) -= 1.0;
+      }
+      else
+      {
+        objective(second) -= 1.0;
+      }
+    }
+  }
+
+  if (runtimes.size() > 1)
+  {
+    objective /= static_cast<double>(runtimes.size() - 1);
+  }
+
+  return objective;
+}
+
+/**
+ * Prints the success rate, the median evaluations (solved) or the median
+ * fitness value (unsolved) of `runtimes`.
+ */
+void print_runtimes(const arma::mat &runtimes, const bool benchmark, double &success, double &evaluations,
+                    double &fitness_value)
+{
+  arma::vec nonZeroIndices = arma::nonzeros(runtimes.col(1));
+  success = static_cast<double>(nonZeroIndices.size()) / static_cast<double>(runtimes.n_rows) * 100.00;
+  evaluations = std::numeric_limits<double>::max();
+  fitness_value = std::numeric_limits<double>::max();
+
+  if (nonZeroIndices.size() == 0)
+  {
+    fitness_value = arma::median(runtimes.col(0));
+  }
+  else
+  {
+    evaluations = arma::median(nonZeroIndices);
+  }
+
+  if (benchmark == true)
+  {
+    std::cout << " Success:                     " << success << " % " << std::endl;
+  }
+  if (nonZeroIndices.size() == 0)
+  {
+    std::cout << " Fitness Value:               " << fitness_value << std::endl;
+  }
+  else
+  {
+    std::cout << " Evaluations:                 " << evaluations << std::endl;
+  }
+}
+} // namespace
 
 void pass::search_parameters(const pass::problem &problem, const bool benchmark)
 {
@@ -11,10 +401,6 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
   // Time to run a black box problem
   const arma::uword time_in_seconds = 10;
 
-  // Global Winner
-  arma::uword global_winner;
-  arma::mat global_best_runtimes;
-
   // Check if the problem is a benchmark problem or not
   if (benchmark == true)
   {
@@ -33,12 +419,9 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
         "benchmark: Please check your benchmark value, as we got not a valid value");
   }
 
-  // Output file
-  std::string file_name;
-  file_name = "adaptive_parameter_";
-  file_name += problem.name;
-  file_name += "_d" + std::to_string(problem.dimension());
-  file_name += ".pass";
+  // The tuned parameters are stored in the registry of this host
+  const pass::parameter_registry registry;
+  const std::string &file_name = registry.file_name;
 
   // Output information
   std::cout << " ==================== Start Parameter Optimisation ================== " << std::endl;
@@ -60,8 +443,8 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
   std::cout << "                                                                      " << std::endl;
 
   arma::vec input(5);
-  // Check if the file exists
-  bool ok = input.load("./" + file_name);
+  // Check if the problem was already tuned in this dimension
+  bool ok = registry.find(problem.name, algorithm.name, problem.dimension(), input);
 
   // Output information
   std::cout << " ============================== Check  ============================== " << std::endl;
@@ -90,8 +473,6 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
       << " - Adaptive Parameters does not exist!                              " << std::endl;
   std::cout << "                                                                    " << std::endl;
 
-  // ================================ Default Parameters ================================
-
   // Output information
   std::cout << " ========================= Default Parameters ======================= " << std::endl;
   std::cout << "                                                                      " << std::endl;
@@ -103,301 +484,135 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
   std::cout << " ==================================================================== " << std::endl;
   std::cout << "                                                                      " << std::endl;
 
-  arma::mat default_runtimes = parameter_evaluate(algorithm, problem);
-  global_best_runtimes = default_runtimes;
+  pass::stopwatch stopwatch;
+  stopwatch.start();
 
-  arma::vec default_nonZeroIndices = arma::nonzeros(default_runtimes.col(1));
-  double default_success = static_cast<double>(default_nonZeroIndices.size()) / static_cast<double>(pass::parameter_setting_number_of_runs) * 100.00;
-  double default_evaluations = std::numeric_limits<double>::max();
-  double default_fitness_value = std::numeric_limits<double>::max();
+  // Each configuration is run this often before the surrogate is updated
+  const arma::uword runs_per_configuration = std::min<arma::uword>(10, pass::parameter_setting_number_of_runs);
 
-  if (default_nonZeroIndices.size() == 0)
-  {
-    default_fitness_value = arma::median(default_runtimes.col(0));
-  }
-  else
-  {
-    default_evaluations = arma::median(default_nonZeroIndices);
-  }
+  // Number of configurations in the initial design (including the default) and in total
+  const arma::uword initial_configurations = 10;
+  const arma::uword maximal_configurations = 40;
 
-  // Output information
-  std::cout << " ================ Done Optimising Default Parameters ================ " << std::endl;
-  std::cout << "                                                                      " << std::endl;
-  if (benchmark == true)
-  {
-    std::cout << " Success:                     " << default_success << " % " << std::endl;
-  }
-  if (default_nonZeroIndices.size() == 0)
-  {
-    std::cout << " Fitness Value:               " << default_fitness_value << std::endl;
-  }
-  else
-  {
-    std::cout << " Evaluations:                 " << default_evaluations << std::endl;
-  }
-  std::cout << " ==================================================================== " << std::endl;
-  std::cout << "                                                                      " << std::endl;
+  // Number of best configurations raced against the default at the end
+  const arma::uword finalists = 4;
 
-  // ================================ End Default Parameters ================================
-  //
-  //
-  //
-  //
-  // ====================================== Swarm Size ======================================
+  // Configurations evaluated in parallel, to keep all workers busy
+  const arma::uword workers = static_cast<arma::uword>(pass::number_of_nodes() * pass::number_of_threads());
+  const arma::uword batch_size = std::max<arma::uword>(1, std::min<arma::uword>(8, workers / runs_per_configuration));
 
   std::cout << " ==================== Optimising Parameters......  ================== " << std::endl;
   std::cout << "                                                                      " << std::endl;
-  std::cout << " - Start: Search for Population " << std::endl;
 
-  arma::uword p_min = 10;
-  arma::uword p_max = 200;
+  // The default configuration is the first one, followed by the prediction
+  // from other dimensions (if any) and random ones
+  arma::mat points(5, initial_configurations);
+  points.col(0) = get_parameters(algorithm);
+  arma::uword first_random_configuration = 1;
 
-  arma::uword p_granularity = 1;
-  arma::mat p_best_segment_runtimes;
-
-  while (p_granularity <= 4)
+  pass::parallel_swarm_search predicted_algorithm;
+  if (predicted_algorithm.load_profile(problem))
   {
-    arma::uword p_middle = (p_max - p_min) / 2 + p_min;
-
-    arma::uword first_segment = pass::random_integer_uniform_in_range(p_min, p_middle);
-    algorithm.swarm_size = first_segment;
-    arma::mat first_segment_runtimes = parameter_evaluate(algorithm, problem);
-
-    arma::uword second_segment = pass::random_integer_uniform_in_range(p_middle, p_max);
-    algorithm.swarm_size = second_segment;
-    arma::mat second_segment_runtimes = parameter_evaluate(algorithm, problem);
-
-    arma::uword winner = compare_segments(first_segment_runtimes, second_segment_runtimes);
-
-    if (winner == 1)
-    {
-      p_max = p_middle;
-      algorithm.swarm_size = first_segment;
-      p_best_segment_runtimes = first_segment_runtimes;
-    }
-    else
-    {
-      p_min = p_middle;
-      algorithm.swarm_size = second_segment;
-      p_best_segment_runtimes = second_segment_runtimes;
-    }
-
-    p_granularity++;
+    points.col(1) = arma::clamp(get_parameters(predicted_algorithm), 0.0, 1.0);
+    first_random_configuration = 2;
   }
 
-  // Compare with default
-  global_winner = compare_segments(p_best_segment_runtimes, global_best_runtimes);
-
-  // If the population search doesn't find a better value than the default
-  if (global_winner == 1)
+  for (arma::uword col = first_random_configuration; col < points.n_cols; ++col)
   {
-    global_best_runtimes = p_best_segment_runtimes;
-  }
-  else
-  {
-    algorithm.swarm_size = 40;
+    for (arma::uword row = 0; row < points.n_rows; ++row)
+    {
+      points(row, col) = pass::random_double_uniform_in_range(0.0, 1.0);
+    }
   }
 
-  std::cout << " - Finished: Search for Population " << std::endl;
-  std::cout << "                                                                      " << std::endl;
-
-  // ================================ End Swarm Size ================================
-  //
-  //
-  //
-  //
-  // ======================= Search for Neighbourhood Probability =======================
-
-  std::cout << " - Start: Search for Neighbourhood Probability " << std::endl;
-
-  arma::uword np_min = 0;
-  arma::uword np_max = 1000000;
+#if defined(SUPPORT_MPI)
+  MPI_Bcast(points.memptr(), points.n_elem, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
 
-  arma::uword np_granularity = 1;
-  arma::mat np_best_segment_runtimes;
+  std::vector<arma::mat> runtimes;
+  arma::mat batch = points;
 
-  while (np_granularity <= 6)
+  while (true)
   {
-    arma::uword np_middle = (np_max - np_min) / 2 + np_min;
-
-    arma::uword first_segment = pass::random_integer_uniform_in_range(np_min, np_middle);
-    algorithm.neighbourhood_probability = static_cast<double>(first_segment) / 1000000;
-    arma::mat first_segment_runtimes = parameter_evaluate(algorithm, problem);
-
-    arma::uword second_segment = pass::random_integer_uniform_in_range(np_middle, np_max);
-    algorithm.neighbourhood_probability = static_cast<double>(second_segment) / 1000000;
-    arma::mat second_segment_runtimes = parameter_evaluate(algorithm, problem);
-
-    arma::uword winner = compare_segments(first_segment_runtimes, second_segment_runtimes);
-
-    if (winner == 1)
+    std::vector<pass::parallel_swarm_search> configurations(batch.n_cols, algorithm);
+    for (arma::uword n = 0; n < batch.n_cols; ++n)
     {
-      np_max = np_middle;
-      algorithm.neighbourhood_probability = static_cast<double>(first_segment) / 1000000;
-      np_best_segment_runtimes = first_segment_runtimes;
+      set_parameters(configurations[n], batch.col(n));
     }
-    else
+
+    for (const arma::mat &configuration_runtimes :
+         pass::parameter_evaluate(configurations, problem, runs_per_configuration,
+                                  pass::parameter_setting_maximal_duration - synchronised_elapsed(stopwatch)))
     {
-      np_min = np_middle;
-      algorithm.neighbourhood_probability = static_cast<double>(second_segment) / 1000000;
-      np_best_segment_runtimes = second_segment_runtimes;
+      runtimes.push_back(configuration_runtimes);
     }
-    np_granularity++;
-  }
-
-  // Compare with best
-  global_winner = compare_segments(np_best_segment_runtimes, global_best_runtimes);
-
-  if (global_winner == 1)
-  {
-    global_best_runtimes = np_best_segment_runtimes;
-  }
-  else
-  {
-    algorithm.neighbourhood_probability = 1.0 -
-                                          std::pow(1.0 - 1.0 / static_cast<double>(40), 3.0);
-  }
-
-  std::cout << " - Finished: Search for Neighbourhood Probability " << std::endl;
-  std::cout << "                                                                      " << std::endl;
-
-  // ======================= End Search for Neighbourhood Probability ======================
-  //
-  //
-  //
-  //
-  // ================================ Search for Inertia ===================================
-
-  std::cout << " - Start: Search for Inertia " << std::endl;
-
-  arma::sword w_min = -1000000;
-  arma::sword w_max = 1000000;
-
-  arma::uword w_granularity = 1;
-  arma::mat w_best_segment_runtimes;
-
-  while (w_granularity <= 7)
-  {
-    arma::sword w_middle = (w_max - w_min) / 2 + w_min;
-
-    arma::sword first_segment = pass::random_integer_uniform_in_range(w_min, w_middle);
-    algorithm.inertia = static_cast<double>(first_segment) / 1000000;
-    arma::mat first_segment_runtimes = parameter_evaluate(algorithm, problem);
-
-    arma::sword second_segment = pass::random_integer_uniform_in_range(w_middle, w_max);
-    algorithm.inertia = static_cast<double>(second_segment) / 1000000;
-    arma::mat second_segment_runtimes = parameter_evaluate(algorithm, problem);
 
-    arma::uword winner = compare_segments(first_segment_runtimes, second_segment_runtimes);
+    std::cout << " - Evaluated configurations: " << runtimes.size() << std::endl;
 
-    if (winner == 1)
+    if (runtimes.size() >= maximal_configurations ||
+        synchronised_elapsed(stopwatch) >= pass::parameter_setting_maximal_duration)
     {
-      w_max = w_middle;
-      algorithm.inertia = static_cast<double>(first_segment) / 1000000;
-      w_best_segment_runtimes = first_segment_runtimes;
+      break;
     }
-    else
-    {
-      w_min = w_middle;
-      algorithm.inertia = static_cast<double>(second_segment) / 1000000;
-      w_best_segment_runtimes = second_segment_runtimes;
-    }
-    w_granularity++;
-  }
 
-  // Compare with best
-  global_winner = compare_segments(w_best_segment_runtimes, global_best_runtimes);
-
-  if (global_winner == 1)
-  {
-    global_best_runtimes = w_best_segment_runtimes;
-  }
-  else
-  {
-    algorithm.inertia = 1.0 / (2.0 * std::log(2.0));
+    batch = propose_parameters(points, tuning_objective(runtimes),
+                               std::min(batch_size, maximal_configurations - runtimes.size()));
+    points.insert_cols(points.n_cols, batch);
   }
 
-  std::cout << " - Finished: Search for Inertia " << std::endl;
   std::cout << "                                                                      " << std::endl;
 
-  // ================================ End Search for Inertia ===============================
-  //
-  //
-  //
-  //
-  // =============================== Search for C1 and C2 =================================
-
-  std::cout << " - Start: Search for Acceleration " << std::endl;
+  // The best configurations race against the default with all runs
+  const arma::uvec order = arma::stable_sort_index(tuning_objective(runtimes));
 
-  arma::uword c_min = 0;
-  arma::uword c_max = 2500000;
-
-  arma::uword c_granularity = 1;
-  arma::mat c_best_segment_runtimes;
-
-  while (c_granularity <= 7)
+  std::vector<pass::parallel_swarm_search> configurations(1, algorithm);
+  for (arma::uword n = 0; n < order.n_elem && configurations.size() <= finalists; ++n)
   {
-    arma::uword c_middle = (c_max - c_min) / 2 + c_min;
+    if (order(n) != 0)
+    {
+      configurations.push_back(algorithm);
+      set_parameters(configurations.back(), points.col(order(n)));
+    }
+  }
 
-    arma::uword first_segment = pass::random_integer_uniform_in_range(c_min, c_middle);
-    algorithm.cognitive_acceleration = static_cast<double>(first_segment) / 1000000;
-    algorithm.social_acceleration = algorithm.cognitive_acceleration;
-    arma::mat first_segment_runtimes = parameter_evaluate(algorithm, problem);
+  std::cout << " - Start: Race of the best configurations " << std::endl;
 
-    arma::uword second_segment = pass::random_integer_uniform_in_range(c_middle, c_max);
-    algorithm.cognitive_acceleration = static_cast<double>(second_segment) / 1000000;
-    algorithm.social_acceleration = algorithm.cognitive_acceleration;
-    arma::mat second_segment_runtimes = parameter_evaluate(algorithm, problem);
+  std::vector<arma::mat> race_runtimes;
+  const arma::uword winner = pass::race_parameters(
+      configurations, problem,
+      std::max(std::chrono::nanoseconds(0), pass::parameter_setting_maximal_duration - synchronised_elapsed(stopwatch)),
+      race_runtimes);
 
-    arma::uword winner = compare_segments(first_segment_runtimes, second_segment_runtimes);
+  const arma::mat default_runtimes = race_runtimes[0];
+  const arma::mat global_best_runtimes = race_runtimes[winner];
 
-    if (winner == 1)
-    {
-      c_max = c_middle;
-      algorithm.cognitive_acceleration = static_cast<double>(first_segment) / 1000000;
-      algorithm.social_acceleration = algorithm.cognitive_acceleration;
-      c_best_segment_runtimes = first_segment_runtimes;
-    }
-    else
-    {
-      c_min = c_middle;
-      algorithm.cognitive_acceleration = static_cast<double>(second_segment) / 1000000;
-      algorithm.social_acceleration = algorithm.cognitive_acceleration;
-      c_best_segment_runtimes = second_segment_runtimes;
-    }
-    c_granularity++;
-  }
+  algorithm.swarm_size = configurations[winner].swarm_size;
+  algorithm.neighbourhood_probability = configurations[winner].neighbourhood_probability;
+  algorithm.inertia = configurations[winner].inertia;
+  algorithm.cognitive_acceleration = configurations[winner].cognitive_acceleration;
+  algorithm.social_acceleration = configurations[winner].social_acceleration;
 
-  // Compare with best
-  global_winner = compare_segments(c_best_segment_runtimes, global_best_runtimes);
+  std::cout << " - Finished: Race of the best configurations " << std::endl;
+  std::cout << "                                                                      " << std::endl;
 
-  if (global_winner == 1)
+  if (synchronised_elapsed(stopwatch) >= pass::parameter_setting_maximal_duration)
   {
-    global_best_runtimes = c_best_segment_runtimes;
-  }
-  else
-  {
-    algorithm.cognitive_acceleration = 0.5 + std::log(2.0);
-    algorithm.social_acceleration = algorithm.cognitive_acceleration;
+    std::cout << " - Stopped: Maximal duration of the parameter search exceeded " << std::endl;
+    std::cout << "                                                                      " << std::endl;
   }
 
-  std::cout << " - Finished: Search for Acceleration " << std::endl;
-  std::cout << "                                                                      " << std::endl;
-
-  // ============================= End Search for C1 and C2 ===============================
-  //
-  //
-  //
-  //
   // File where the parameters are saved
-  arma::vec output(5);
-  output(0) = algorithm.swarm_size;
-  output(1) = algorithm.neighbourhood_probability;
-  output(2) = algorithm.inertia;
-  output(3) = algorithm.cognitive_acceleration;
-  output(4) = algorithm.social_acceleration;
+  if (pass::node_rank() == 0)
+  {
+    arma::vec output(5);
+    output(0) = algorithm.swarm_size;
+    output(1) = algorithm.neighbourhood_probability;
+    output(2) = algorithm.inertia;
+    output(3) = algorithm.cognitive_acceleration;
+    output(4) = algorithm.social_acceleration;
 
-  output.save("./" + file_name, arma::raw_ascii);
+    registry.store(problem.name, algorithm.name, problem.dimension(), output);
+  }
 
   // Output information
   std::cout << " ======================== Adaptive Parameters ======================= " << std::endl;
@@ -412,35 +627,20 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
 
   // =============================== Final Evaluations =================================
 
-  arma::vec final_nonZeroIndices = arma::nonzeros(global_best_runtimes.col(1));
-  double final_success = static_cast<double>(final_nonZeroIndices.size()) / static_cast<double>(pass::parameter_setting_number_of_runs) * 100.00;
-  double final_evaluations = std::numeric_limits<double>::max();
-  double final_fitness_value = std::numeric_limits<double>::max();
+  double default_success, default_evaluations, default_fitness_value;
+  double final_success, final_evaluations, final_fitness_value;
 
-  if (final_nonZeroIndices.size() == 0)
-  {
-    final_fitness_value = arma::median(global_best_runtimes.col(0));
-  }
-  else
-  {
-    final_evaluations = arma::median(final_nonZeroIndices);
-  }
+  // Output information
+  std::cout << " ================ Done Optimising Default Parameters ================ " << std::endl;
+  std::cout << "                                                                      " << std::endl;
+  print_runtimes(default_runtimes, benchmark, default_success, default_evaluations, default_fitness_value);
+  std::cout << " ==================================================================== " << std::endl;
+  std::cout << "                                                                      " << std::endl;
 
   // Output information
   std::cout << " ================ Done Optimising Adaptive Parameters =============== " << std::endl;
   std::cout << "                                                                      " << std::endl;
-  if (benchmark == true)
-  {
-    std::cout << " Success:                     " << final_success << " % " << std::endl;
-  }
-  if (final_nonZeroIndices.size() == 0)
-  {
-    std::cout << " Fitness Value:               " << final_fitness_value << std::endl;
-  }
-  else
-  {
-    std::cout << " Evaluations:                 " << final_evaluations << std::endl;
-  }
+  print_runtimes(global_best_runtimes, benchmark, final_success, final_evaluations, final_fitness_value);
   std::cout << " ==================================================================== " << std::endl;
   std::cout << "                                                                      " << std::endl;
 
@@ -451,7 +651,7 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
   {
     std::cout << " Improvement Success:         " << final_success - default_success << " % more solved" << std::endl;
   }
-  if (final_nonZeroIndices.size() == 0)
+  if (final_success == 0.0)
   {
     std::cout << " Improvement Fitness Value:   " << default_fitness_value / final_fitness_value << " times better" << std::endl;
   }
@@ -471,6 +671,77 @@ void pass::search_parameters(const pass::problem &problem, const bool benchmark)
   // =============================== End Final Evaluations =================================
 }
 
+arma::uword pass::race_parameters(const std::vector<pass::parallel_swarm_search> &configurations,
+                                  const pass::problem &problem,
+                                  const std::chrono::nanoseconds maximal_duration,
+                                  std::vector<arma::mat> &runtimes)
+{
+  assert(configurations.size() > 0 && "Can't race 0 configurations");
+
+  pass::stopwatch stopwatch;
+  stopwatch.start();
+
+  const arma::uword maximal_runs = pass::parameter_setting_number_of_runs;
+  const arma::uword minimal_runs = std::min<arma::uword>(5, maximal_runs);
+
+  // One column per configuration, one row per run
+  arma::mat fitness_values(maximal_runs, configurations.size(), arma::fill::zeros);
+  arma::mat evaluations(maximal_runs, configurations.size(), arma::fill::zeros);
+  arma::uvec completed_runs(configurations.size(), arma::fill::zeros);
+
+  std::vector<arma::uword> alive(configurations.size());
+  std::iota(alive.begin(), alive.end(), 0);
+
+  const arma::uword workers = static_cast<arma::uword>(pass::number_of_nodes() * pass::number_of_threads());
+
+  arma::uword runs = 0;
+  std::chrono::nanoseconds elapsed(0);
+
+  do
+  {
+    // Enough runs per round to keep all workers busy
+    const arma::uword round_runs = std::min((workers + alive.size() - 1) / alive.size(), maximal_runs - runs);
+
+    std::vector<pass::parallel_swarm_search> alive_configurations;
+    for (const arma::uword n : alive)
+    {
+      alive_configurations.push_back(configurations[n]);
+    }
+
+    const std::vector<arma::mat> round_runtimes =
+        pass::parameter_evaluate(alive_configurations, problem, round_runs, maximal_duration - elapsed);
+
+    for (arma::uword n = 0; n < alive.size(); ++n)
+    {
+      fitness_values.submat(runs, alive[n], runs + round_runs - 1, alive[n]) = round_runtimes[n].col(0);
+      evaluations.submat(runs, alive[n], runs + round_runs - 1, alive[n]) = round_runtimes[n].col(1);
+      completed_runs(alive[n]) += round_runs;
+    }
+    runs += round_runs;
+
+    // Drop the configurations that are significantly worse
+    if (runs >= minimal_runs)
+    {
+      alive = friedman_survivors(fitness_values, evaluations, alive, runs);
+    }
+
+    elapsed = synchronised_elapsed(stopwatch);
+  } while (alive.size() > 1 && runs < maximal_runs && elapsed < maximal_duration);
+
+  // The best of the remaining configurations
+  const arma::rowvec rank_sums = arma::sum(rank_runs(fitness_values, evaluations, alive, runs), 0);
+  const arma::uword winner = alive[rank_sums.index_min()];
+
+  runtimes.clear();
+  for (arma::uword n = 0; n < configurations.size(); ++n)
+  {
+    runtimes.push_back(arma::join_rows(fitness_values.col(n).head(completed_runs(n)),
+                                       evaluations.col(n).head(completed_runs(n))));
+  }
+
+  return winner;
+}
+
 arma::mat pass::parameter_evaluate(pass::optimiser &optimiser, const pass::problem &problem)
 {
   arma::mat runtimes(pass::parameter_setting_number_of_runs, 2);
@@ -494,6 +765,66 @@ arma::mat pass::parameter_evaluate(pass::optimiser &optimiser, const pass::probl
   return runtimes;
 }
 
+std::vector<arma::mat> pass::parameter_evaluate(const std::vector<pass::parallel_swarm_search> &configurations,
+                                                const pass::problem &problem,
+                                                const arma::uword runs,
+                                                const std::chrono::nanoseconds maximal_duration)
+{
+  const arma::uword tasks = runs * configurations.size();
+  const arma::uword ranks = static_cast<arma::uword>(pass::number_of_nodes());
+  const arma::uword rank = static_cast<arma::uword>(pass::node_rank());
+
+  arma::mat fitness_values(runs, configurations.size(), arma::fill::zeros);
+  arma::mat evaluations(runs, configurations.size(), arma::fill::zeros);
+
+  // The tasks are distributed round-robin over the ranks and dynamically over
+  // the threads. Each run uses a single thread: the parallel regions of the
+  // raced optimisers are not activated, even if nesting is enabled, so that
+  // they don't oversubscribe the cores and skew each other's durations.
+#if defined(SUPPORT_OPENMP)
+  const int max_active_levels = omp_get_max_active_levels();
+  omp_set_max_active_levels(1);
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (arma::uword task = rank; task < tasks; task += ranks)
+  {
+    const arma::uword configuration = task % configurations.size();
+    const arma::uword run = task / configurations.size();
+
+    pass::parallel_swarm_search algorithm(configurations[configuration]);
+    algorithm.maximal_duration = std::min(algorithm.maximal_duration, maximal_duration);
+#if defined(SUPPORT_OPENMP)
+    // A single thread is available to each run, so there is nothing to tune
+    algorithm.adaptive_parallelism = false;
+#endif
+#if defined(SUPPORT_MPI)
+    // Each run is its own island, so no MPI calls happen inside the threads
+    algorithm.communicator = MPI_COMM_SELF;
+#endif
+
+    pass::optimise_result result = algorithm.optimise(problem);
+
+    fitness_values(run, configuration) = result.fitness_value;
+    evaluations(run, configuration) = result.solved() ? result.evaluations : 0;
+  }
+#if defined(SUPPORT_OPENMP)
+  omp_set_max_active_levels(max_active_levels);
+#endif
+
+#if defined(SUPPORT_MPI)
+  MPI_Allreduce(MPI_IN_PLACE, fitness_values.memptr(), fitness_values.n_elem, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, evaluations.memptr(), evaluations.n_elem, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  std::vector<arma::mat> runtimes;
+  for (arma::uword n = 0; n < configurations.size(); ++n)
+  {
+    runtimes.push_back(arma::join_rows(fitness_values.col(n), evaluations.col(n)));
+  }
+
+  return runtimes;
+}
+
 arma::uword pass::compare_segments(const arma::mat first_segment_runtimes, const arma::mat second_segment_runtimes)
 {
   arma::uword winner = arma::datum::nan;
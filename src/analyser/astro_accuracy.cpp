@@ -0,0 +1,232 @@
+#include "pass_bits/analyser/astro_accuracy.hpp"
+#include "pass_bits/helper/astro_problems/astro_helpers.hpp"
+#include "pass_bits/helper/astro_problems/constants.hpp"
+#include "pass_bits/helper/astro_problems/mission_description.hpp"
+#include "pass_bits/helper/astro_problems/pl_eph_an.hpp"
+#include "pass_bits/helper/astro_problems/propagate_kep.hpp"
+#include "pass_bits/helper/astro_problems/propagate_universal.hpp"
+#include "pass_bits/helper/astro_problems/root_finder.hpp"
+#include <algorithm> // std::max
+#include <cmath>     // std::sin, std::cos, std::tan, std::log, std::fabs, std::sqrt, std::pow
+#include <initializer_list> // for-loops over braced lists
+#include <stdexcept>        // std::runtime_error
+#include <sstream>          // std::ostringstream
+
+namespace
+{
+/**
+ * Returns the error reporting that `difference` (in `unit`) exceeds its bound.
+ */
+std::runtime_error accuracy_error(const std::string &message, const double difference, const std::string &unit)
+{
+  std::ostringstream stream;
+  stream << message << difference << " " << unit << ".";
+  return std::runtime_error(stream.str());
+}
+} // namespace
+
+pass::kepler_solver_accuracy_result pass::kepler_solver_accuracy()
+{
+  kepler_solver_accuracy_result accuracy;
+  accuracy.maximal_difference = 0.0;
+  accuracy.maximal_residual = 0.0;
+  accuracy.unconverged_references = 0;
+
+  const double pi = 3.14159265358979323846;
+  const double elliptic_eccentricities[] = {0.0, 0.01, 0.05, 0.1, 0.15, 0.2, 0.25, 0.3, 0.35, 0.4, 0.45, 0.5,
+                                            0.55, 0.6, 0.65, 0.7, 0.75, 0.8, 0.85, 0.9, 0.95, 0.99, 0.995, 0.999};
+  const double hyperbolic_eccentricities[] = {1.001, 1.01, 1.05, 1.1, 1.3, 1.5, 2.0, 3.0, 5.0, 10.0, 50.0};
+  const int steps = 200;
+
+  for (const double e : elliptic_eccentricities)
+  {
+    for (int i = 0; i <= steps; ++i)
+    {
+      const double m = -pi + 2.0 * pi * i / steps;
+      const double eccentric_anomaly = mean_to_eccentric(m, e);
+
+      accuracy.maximal_residual = std::max(
+          accuracy.maximal_residual,
+          std::fabs(eccentric_anomaly - e * std::sin(eccentric_anomaly) - m) / (1.0 - e * std::cos(eccentric_anomaly)));
+
+      // The previous solver: Newton iterations, starting at m + e cos(m)
+      double reference = m + e * std::cos(m);
+      double step = 1.0;
+      int iterations = 0;
+      while (step > 1e-13 && iterations < 100)
+      {
+        const double next = reference - (reference - e * std::sin(reference) - m) / (1.0 - e * std::cos(reference));
+        step = std::fabs(next - reference);
+        reference = next;
+        ++iterations;
+      }
+
+      if (step > 1e-13)
+      {
+        ++accuracy.unconverged_references;
+        continue;
+      }
+      accuracy.maximal_difference = std::max(accuracy.maximal_difference, std::fabs(eccentric_anomaly - reference));
+    }
+  }
+
+  for (const double e : hyperbolic_eccentricities)
+  {
+    for (int i = 0; i <= steps; ++i)
+    {
+      const double m = -50.0 + 100.0 * i / steps;
+      // The Gudermannian of the hyperbolic anomaly
+      const double gudermannian = mean_to_eccentric(m, e);
+      const double hyperbolic_anomaly = std::asinh(std::tan(gudermannian));
+
+      // The derivative of Kepler's equation with respect to the Gudermannian
+      // is (e cosh(H) - 1) cosh(H).
+      accuracy.maximal_residual = std::max(
+          accuracy.maximal_residual,
+          std::fabs(e * std::sinh(hyperbolic_anomaly) - hyperbolic_anomaly - m) /
+              ((e * std::cosh(hyperbolic_anomaly) - 1.0) * std::cosh(hyperbolic_anomaly)));
+
+      // The previous solver: the zero of the Gudermannian form
+      const double reference = pass::find_zero(
+          [m, e, pi](const double x) { return e * std::tan(x) - std::log(std::tan(0.5 * x + 0.25 * pi)) - m; },
+          -0.5 * pi + 1e-8, 0.5 * pi - 1e-8);
+      accuracy.maximal_difference = std::max(accuracy.maximal_difference, std::fabs(gudermannian - reference));
+    }
+  }
+
+  // Checked in all builds, as the Release build compiles asserts out
+  if (!(accuracy.maximal_difference <= 1e-12))
+  {
+    throw accuracy_error("kepler_solver_accuracy: `mean_to_eccentric` deviates from the previous Kepler solver by ",
+                         accuracy.maximal_difference, "rad");
+  }
+  if (!(accuracy.maximal_residual <= 1e-13))
+  {
+    throw accuracy_error("kepler_solver_accuracy: `mean_to_eccentric` leaves a residual of ",
+                         accuracy.maximal_residual, "rad in Kepler's equation");
+  }
+
+  return accuracy;
+}
+
+pass::kepler_propagator_accuracy_result pass::kepler_propagator_accuracy()
+{
+  kepler_propagator_accuracy_result accuracy;
+  accuracy.maximal_position_difference = 0.0;
+  accuracy.maximal_velocity_difference = 0.0;
+  accuracy.legs = 0;
+
+  const double mu = pass::celestial_body::SUN.mu;
+
+  // The 6 coordinate axes and the 8 diagonals
+  double directions[14][3];
+  int direction = 0;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (const double sign : {-1.0, 1.0})
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        directions[direction][i] = i == axis ? sign : 0.0;
+      }
+      ++direction;
+    }
+  }
+  for (const double x : {-1.0, 1.0})
+  {
+    for (const double y : {-1.0, 1.0})
+    {
+      for (const double z : {-1.0, 1.0})
+      {
+        directions[direction][0] = x / std::sqrt(3.0);
+        directions[direction][1] = y / std::sqrt(3.0);
+        directions[direction][2] = z / std::sqrt(3.0);
+        ++direction;
+      }
+    }
+  }
+
+  for (const char *const mission : {pass::missions::rosetta, pass::missions::messenger_full})
+  {
+    const mission_description description = parse_mission_description(mission);
+    const arma::vec &lower_bounds = description.lower_bounds;
+    const arma::vec &upper_bounds = description.upper_bounds;
+    // The decision vector holds the launch date, the 3 launch variables, the
+    // n - 1 times of flight and then the n - 1 DSM fractions
+    const arma::uword legs = description.sequence.size() - 1;
+
+    double earliest_departure = lower_bounds(0);
+    double latest_departure = upper_bounds(0);
+    for (arma::uword leg = 0; leg < legs; ++leg)
+    {
+      const arma::uword time_of_flight = 4 + leg;
+      const arma::uword fraction = 4 + legs + leg;
+
+      for (int i = 0; i <= 4; ++i)
+      {
+        const double date = earliest_departure + (latest_departure - earliest_departure) * i / 4.0;
+        double body_position[3];
+        double body_velocity[3];
+        Planet_Ephemerides_Analytical(date, description.sequence[leg], body_position, body_velocity);
+
+        const double slowest = leg == 0 ? lower_bounds(1) : 1.0;
+        const double fastest = leg == 0 ? upper_bounds(1) : 10.0;
+        for (int j = 0; j <= 2; ++j)
+        {
+          for (const auto &excess_direction : directions)
+          {
+            double velocity[3];
+            for (int k = 0; k < 3; ++k)
+            {
+              velocity[k] = body_velocity[k] + (slowest + (fastest - slowest) * j / 2.0) * excess_direction[k];
+            }
+
+            for (int k = 0; k <= 2; ++k)
+            {
+              for (int l = 0; l <= 2; ++l)
+              {
+                const double duration =
+                    (lower_bounds(time_of_flight) + (upper_bounds(time_of_flight) - lower_bounds(time_of_flight)) * k / 2.0) *
+                    (lower_bounds(fraction) + (upper_bounds(fraction) - lower_bounds(fraction)) * l / 2.0) * 86400.0;
+
+                double elements_position[3], elements_velocity[3];
+                double universal_position[3], universal_velocity[3];
+                propagateKEP(body_position, velocity, duration, mu, elements_position, elements_velocity);
+                pass::propagate_universal(body_position, velocity, duration, mu, universal_position, universal_velocity);
+
+                double position_difference = 0.0;
+                double velocity_difference = 0.0;
+                for (int m = 0; m < 3; ++m)
+                {
+                  position_difference += std::pow(elements_position[m] - universal_position[m], 2.0);
+                  velocity_difference += std::pow(elements_velocity[m] - universal_velocity[m], 2.0);
+                }
+                accuracy.maximal_position_difference =
+                    std::max(accuracy.maximal_position_difference, std::sqrt(position_difference));
+                accuracy.maximal_velocity_difference =
+                    std::max(accuracy.maximal_velocity_difference, std::sqrt(velocity_difference));
+                ++accuracy.legs;
+              }
+            }
+          }
+        }
+      }
+
+      earliest_departure += lower_bounds(time_of_flight);
+      latest_departure += upper_bounds(time_of_flight);
+    }
+  }
+
+  if (!(accuracy.maximal_position_difference <= 1e-3))
+  {
+    throw accuracy_error("kepler_propagator_accuracy: The Kepler propagators disagree on the positions by ",
+                         accuracy.maximal_position_difference, "km");
+  }
+  if (!(accuracy.maximal_velocity_difference <= 1e-9))
+  {
+    throw accuracy_error("kepler_propagator_accuracy: The Kepler propagators disagree on the velocities by ",
+                         accuracy.maximal_velocity_difference, "km/s");
+  }
+
+  return accuracy;
+}
@@ -0,0 +1,72 @@
+#include "pass_bits/analyser/fidelity_comparison.hpp"
+#include "pass_bits/helper/stopwatch.hpp"
+#include <algorithm> // std::min, std::max
+#include <cassert>   // assert
+#include <cmath>     // std::isfinite, std::fabs
+
+pass::fidelity_comparison_result pass::fidelity_comparison(const pass::problem &problem,
+                                                           const arma::uword number_of_agents)
+{
+  assert(number_of_agents > 0 && "`number_of_agents` should be greater than 0");
+
+  const arma::mat agents = problem.normalised_random_agents(number_of_agents);
+  arma::vec high_fidelity_values(number_of_agents);
+  arma::vec low_fidelity_values(number_of_agents);
+
+  fidelity_comparison_result comparison;
+  comparison.high_fidelity_time = arma::datum::inf;
+  comparison.low_fidelity_time = arma::datum::inf;
+
+  for (arma::uword repetition = 0; repetition < 9; ++repetition)
+  {
+    pass::stopwatch stopwatch;
+    stopwatch.start();
+    for (arma::uword n = 0; n < number_of_agents; ++n)
+    {
+      high_fidelity_values(n) = problem.evaluate_normalised(agents.col(n));
+    }
+    comparison.high_fidelity_time =
+        std::min(comparison.high_fidelity_time, static_cast<double>(stopwatch.get_elapsed().count()) / number_of_agents);
+
+    stopwatch.start();
+    for (arma::uword n = 0; n < number_of_agents; ++n)
+    {
+      low_fidelity_values(n) = problem.evaluate_normalised_low_fidelity(agents.col(n));
+    }
+    comparison.low_fidelity_time =
+        std::min(comparison.low_fidelity_time, static_cast<double>(stopwatch.get_elapsed().count()) / number_of_agents);
+  }
+
+  // The best 10% are those at or below this objective value
+  const arma::vec finite_values = high_fidelity_values.elem(arma::find_finite(high_fidelity_values));
+  const double best_threshold =
+      finite_values.is_empty() ? -arma::datum::inf
+                               : arma::vec(arma::sort(finite_values))(finite_values.n_elem / 10);
+
+  comparison.maximal_difference = 0.0;
+  comparison.maximal_best_difference = 0.0;
+  comparison.finiteness_mismatches = 0;
+  for (arma::uword n = 0; n < number_of_agents; ++n)
+  {
+    const double high_fidelity_value = high_fidelity_values(n);
+    if (std::isfinite(high_fidelity_value) != std::isfinite(low_fidelity_values(n)))
+    {
+      ++comparison.finiteness_mismatches;
+      continue;
+    }
+    if (!std::isfinite(high_fidelity_value))
+    {
+      continue;
+    }
+
+    const double difference = std::fabs(low_fidelity_values(n) - high_fidelity_value) /
+                              std::max(1.0, std::fabs(high_fidelity_value));
+    comparison.maximal_difference = std::max(comparison.maximal_difference, difference);
+    if (high_fidelity_value <= best_threshold)
+    {
+      comparison.maximal_best_difference = std::max(comparison.maximal_best_difference, difference);
+    }
+  }
+
+  return comparison;
+}
@@ -0,0 +1,188 @@
+#include "pass_bits/analyser/mpi.hpp"
+#include "pass_bits/analyser/openmp.hpp"
+#include "pass_bits/analyser/problem_evaluation_time.hpp"
+#include "pass_bits/helper/profile_cache.hpp"
+#include "pass_bits/helper/random.hpp"
+#include "pass_bits/helper/stopwatch.hpp"
+#include <algorithm> // std::max
+#include <cmath>     // std::ceil, std::log2
+#include <thread>    // std::thread::hardware_concurrency
+
+#if defined(SUPPORT_MPI)
+#include <mpi.h>
+#endif
+
+pass::mpi_recommendation pass::enable_mpi(const pass::problem &problem, const double maximal_communication_fraction)
+{
+  assert(maximal_communication_fraction > 0.0 && maximal_communication_fraction < 1.0 &&
+         "`maximal_communication_fraction` should be a value between 0.0 and 1.0");
+
+  // The default swarm size of the parallel swarm search
+  const arma::uword swarm_size = 40;
+
+  const bool is_root = pass::node_rank() == 0;
+
+  if (is_root)
+  {
+    std::cout << " ============================ Start MPI Analyse =========================== " << std::endl;
+    std::cout << "                                                                            " << std::endl;
+    std::cout << " Your Problem:                " << problem.name << std::endl;
+    std::cout << " Dimension:                   " << problem.dimension() << std::endl;
+    std::cout << " Number of Ranks:             " << pass::number_of_nodes() << std::endl;
+    std::cout << " Number of Threads:           " << pass::number_of_threads() << std::endl;
+    std::cout << "                                                                            " << std::endl;
+  }
+
+  // Evaluate the problem on all ranks at once, as during the optimisation
+  double evaluation_time = pass::problem_evaluation_time(problem);
+  double measured_migration_time = pass::migration_time(problem.dimension());
+
+  int ranks = pass::number_of_nodes();
+  int ranks_on_this_node = 1;
+  int nodes = 1;
+
+#if defined(SUPPORT_MPI)
+  MPI_Allreduce(MPI_IN_PLACE, &evaluation_time, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  evaluation_time /= ranks;
+
+  // Ranks sharing memory are on the same node
+  MPI_Comm node_communicator;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_communicator);
+  int node_local_rank;
+  MPI_Comm_rank(node_communicator, &node_local_rank);
+  MPI_Comm_size(node_communicator, &ranks_on_this_node);
+  MPI_Comm_free(&node_communicator);
+
+  int is_node_leader = node_local_rank == 0 ? 1 : 0;
+  MPI_Allreduce(&is_node_leader, &nodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  // Hardware threads of one node
+  int cores_per_node = static_cast<int>(std::thread::hardware_concurrency());
+  if (cores_per_node <= 0)
+  {
+    cores_per_node = ranks_on_this_node * pass::number_of_threads();
+  }
+
+  pass::mpi_recommendation recommendation;
+
+  // The OpenMP model is only loaded (and calibrated if needed) once per run
+  arma::rowvec model(3);
+  if (is_root)
+  {
+    model = pass::openmp_model();
+  }
+
+#if defined(SUPPORT_MPI)
+  MPI_Bcast(model.memptr(), model.n_elem, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+
+  recommendation.threads_per_rank = pass::optimal_number_of_threads(model, evaluation_time, swarm_size,
+                                                                    std::min(cores_per_node, pass::number_of_threads()));
+  recommendation.ranks_per_node = std::max(1, cores_per_node / recommendation.threads_per_rank);
+  recommendation.number_of_islands = nodes * recommendation.ranks_per_node;
+
+  // Collectives need about log2(p) steps, so the measured time is scaled to
+  // the recommended number of islands.
+  recommendation.migration_time = measured_migration_time *
+                                  std::log2(std::max(2, recommendation.number_of_islands)) /
+                                  std::log2(std::max(2, ranks));
+
+  recommendation.iteration_time = pass::predict_iteration_time(model, evaluation_time, swarm_size,
+                                                               recommendation.threads_per_rank);
+  recommendation.migration_stall = pass::optimal_migration_stall(
+      recommendation.migration_time, recommendation.iteration_time, maximal_communication_fraction);
+  recommendation.communication_fraction =
+      recommendation.migration_time /
+      ((recommendation.migration_stall + 1) * recommendation.iteration_time + recommendation.migration_time);
+
+  if (is_root)
+  {
+    std::cout << " ========================= Start MPI Recommendation ======================= " << std::endl;
+    std::cout << "                                                                            " << std::endl;
+    std::cout << " Evaluation time:             " << evaluation_time * 1e-3 << " microseconds." << std::endl;
+    std::cout << " Iteration time:              " << recommendation.iteration_time * 1e-3 << " microseconds." << std::endl;
+    std::cout << " Migration time:              " << recommendation.migration_time * 1e-3 << " microseconds." << std::endl;
+    std::cout << " Nodes:                       " << nodes << std::endl;
+    std::cout << "                                                                            " << std::endl;
+    std::cout << " Migration stall:             " << recommendation.migration_stall << std::endl;
+    std::cout << " Number of islands:           " << recommendation.number_of_islands << std::endl;
+    std::cout << " Ranks per node:              " << recommendation.ranks_per_node << std::endl;
+    std::cout << " Threads per rank:            " << recommendation.threads_per_rank << std::endl;
+    std::cout << " Communication:               " << 100.0 * recommendation.communication_fraction << " % of the runtime." << std::endl;
+    std::cout << "                                                                            " << std::endl;
+    std::cout << " ========================== Done MPI Recommendation ======================= " << std::endl;
+    std::cout << "                                                                            " << std::endl;
+
+    arma::rowvec profile({static_cast<double>(recommendation.migration_stall),
+                          static_cast<double>(recommendation.number_of_islands),
+                          static_cast<double>(recommendation.ranks_per_node),
+                          static_cast<double>(recommendation.threads_per_rank),
+                          recommendation.migration_time,
+                          recommendation.iteration_time,
+                          recommendation.communication_fraction});
+    profile.save(pass::profile_path("mpi_model_" + problem.name), arma::raw_ascii);
+
+    std::cout << " ===========================  Done MPI Analyse  =========================== " << std::endl;
+  }
+
+  return recommendation;
+}
+
+double pass::migration_time(const arma::uword dimension)
+{
+#if defined(SUPPORT_MPI)
+  struct
+  {
+    double fitness_value;
+    int best_rank;
+  } mpi;
+
+  arma::vec agent(dimension, arma::fill::randu);
+  arma::vec times(50);
+
+  // warm up
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  for (arma::uword n = 0; n < times.n_elem; ++n)
+  {
+    mpi.fitness_value = pass::random_double_uniform_in_range(0.0, 1.0);
+    mpi.best_rank = pass::node_rank();
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    pass::stopwatch stopwatch;
+    stopwatch.start();
+
+    // Same communication as one migration of the parallel swarm search
+    MPI_Allreduce(MPI_IN_PLACE, &mpi, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+    MPI_Bcast(agent.memptr(), agent.n_elem, MPI_DOUBLE, mpi.best_rank, MPI_COMM_WORLD);
+
+    times(n) = stopwatch.get_elapsed().count();
+  }
+
+  // The slowest rank determines the duration of a migration
+  double duration = arma::median(times);
+  MPI_Allreduce(MPI_IN_PLACE, &duration, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  return duration;
+#else
+  (void)dimension;
+  return 0.0;
+#endif
+}
+
+arma::uword pass::optimal_migration_stall(const double migration_time, const double iteration_time,
+                                          const double maximal_communication_fraction)
+{
+  if (migration_time <= 0.0 || iteration_time <= 0.0)
+  {
+    return 0;
+  }
+
+  // C / ((stall + 1) * T + C) <= f  <=>  stall + 1 >= C * (1 - f) / (f * T)
+  const double iterations = std::ceil(migration_time * (1.0 - maximal_communication_fraction) /
+                                      (maximal_communication_fraction * iteration_time));
+
+  return static_cast<arma::uword>(std::max(0.0, iterations - 1.0));
+}
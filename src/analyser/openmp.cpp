@@ -1,14 +1,58 @@
 #include "pass_bits/analyser/openmp.hpp"
-#include "pass_bits/problem/space_mission/gtoc1.hpp"
 #include "pass_bits/problem/optimisation_benchmark/de_jong_function.hpp"
 #include "pass_bits/helper/evaluation_time_stall.hpp"
-#include "pass_bits/optimiser/parallel_swarm_search.hpp"
-#include "pass_bits/optimiser/particle_swarm_optimisation.hpp"
 #include "pass_bits/analyser/problem_evaluation_time.hpp"
+#include "pass_bits/helper/profile_cache.hpp"
 #include "pass_bits/helper/regression.hpp"
-#include "pass_bits/helper/random.hpp"
-#include <unistd.h> // usleep
-#include <iomanip>  // setprecision, setfill
+#include "pass_bits/helper/stopwatch.hpp"
+#include <iomanip> // setprecision, setfill
+#include <cmath>   // std::ceil
+
+#if defined(SUPPORT_OPENMP)
+#include <omp.h>
+#endif
+
+namespace
+{
+/**
+ * Returns the median duration in nanoseconds of evaluating all columns of
+ * `agents` with `threads` threads, which is one iteration of a swarm.
+ *
+ * Iterations are repeated for about 10 milliseconds (at least 3 times) to
+ * get a robust value, instead of pausing between single runs.
+ */
+double iteration_time(const pass::problem &problem, const arma::mat &agents, const int threads)
+{
+  const std::chrono::nanoseconds target_duration = std::chrono::milliseconds(10);
+  arma::vec times(50);
+  arma::uword count = 0;
+
+  pass::stopwatch total;
+  total.start();
+
+  while (count < times.n_elem && (count < 3 || total.get_elapsed() < target_duration))
+  {
+    pass::stopwatch stopwatch;
+    stopwatch.start();
+
+#if defined(SUPPORT_OPENMP)
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+    for (arma::uword n = 0; n < agents.n_cols; ++n)
+    {
+      problem.evaluate_normalised(agents.col(n));
+    }
+
+    times(count++) = stopwatch.get_elapsed().count();
+  }
+
+#if !defined(SUPPORT_OPENMP)
+  (void)threads;
+#endif
+
+  return arma::median(times.head(count));
+}
+} // namespace
 
 bool pass::enable_openmp(const pass::problem &problem)
 {
@@ -38,176 +82,131 @@ bool pass::enable_openmp(const pass::problem &problem)
   std::cout << " ============================= End Evaluation  ============================ " << std::endl;
   std::cout << "                                                                            " << std::endl;
 
-  arma::mat summary;
-  arma::rowvec model;
+  arma::rowvec model = openmp_model();
+
+  std::cout << " ========================= Start SpeedUp Prediction ======================= " << std::endl;
+
+  // The default swarm size of the parallel swarm search
+  const arma::uword swarm_size = 40;
+
+  const int threads = optimal_number_of_threads(model, your_time, swarm_size, pass::number_of_threads());
+  const double speedup = predict_speedup(model, your_time, swarm_size, threads);
 
-  // Check if the file exists
-  bool ok = model.load("./openmp_model.pass");
+  std::cout << "                                                                            " << std::endl;
+  std::cout << " Optimal number of threads:           " << threads << std::endl;
+  std::cout << " Your speedUp will be approximately:  " << speedup << std::endl;
+  std::cout << "                                                                            " << std::endl;
+  std::cout << " ========================== Done SpeedUp Prediction ======================= " << std::endl;
+  std::cout << "                                                                            " << std::endl;
 
-  if (ok == false)
+  if (threads > 1)
   {
-    std::cout << " - Model does not exist                                                     " << std::endl;
-    std::cout << "                                                                            " << std::endl;
-    // Start training + build model
-    summary = train(120);
-    model = build_model(summary);
+    std::cout << " You should activate openMP with " << threads << " threads!" << std::endl;
   }
   else
   {
-    std::cout << " - Model exists                                                             " << std::endl;
-    std::cout << "                                                                            " << std::endl;
+    std::cout << " You should NOT activate openMP!                                            " << std::endl;
   }
 
-  std::cout << " ========================= Start SpeedUp Prediction ======================= " << std::endl;
+  std::cout << "                                                                            " << std::endl;
+  std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
 
-  // Generating a regression object
-  pass::regression r;
+  return threads > 1;
+}
 
-  if (model.n_elem == 3)
+int pass::optimal_number_of_threads(const pass::problem &problem, const arma::uword swarm_size)
+{
+  if (pass::number_of_threads() == 1)
   {
-    double predict_linear = r.predict_linear(your_time, model);
+    return 1;
+  }
 
-    if (predict_linear > 0.9 * pass::number_of_threads())
-    {
-      predict_linear = 0.9 * pass::number_of_threads();
-    }
-    std::cout << "                                                                            " << std::endl;
-    std::cout << " Your speedUp will be approximately:  " << predict_linear << std::endl;
+  return optimal_number_of_threads(openmp_model(), pass::problem_evaluation_time(problem),
+                                   swarm_size, pass::number_of_threads());
+}
 
-    std::cout << "                                                                            " << std::endl;
-    std::cout << " ========================== Done SpeedUp Prediction ======================= " << std::endl;
+arma::rowvec pass::openmp_model()
+{
+  arma::rowvec model;
 
-    if (predict_linear >= pass::number_of_threads() * 0.5) // efficienty is more than 50 %
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " You should activate openMP!                                                " << std::endl;
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
-      return true;
-    }
-    if (predict_linear <= pass::number_of_threads() * 0.2) // efficienty is less than 20 %
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " You should NOT activate openMP!                                            " << std::endl;
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
-      return false;
-    }
-    if (predict_linear > pass::number_of_threads() * 0.2 && predict_linear < pass::number_of_threads() * 0.5)
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " Decide yourself if to activate openMP or not!                              " << std::endl;
-      std::cout << "                                                                            " << std::endl;
-    }
+  // Check if the profile of this machine exists
+  bool ok = model.load(pass::profile_path("openmp_model"));
+
+  if (ok == false || model.n_elem != 3)
+  {
+    std::cout << " - Model does not exist                                                     " << std::endl;
+    std::cout << "                                                                            " << std::endl;
+    // Start training + build model
+    model = build_model(train(8));
   }
   else
   {
-    double predict_poly = r.predict_poly(your_time, model);
-
-    if (predict_poly > 0.9 * pass::number_of_threads())
-    {
-      predict_poly = 0.9 * pass::number_of_threads();
-    }
-    std::cout << "                                                                            " << std::endl;
-    std::cout << " Your speedUp will be approximately: " << predict_poly << std::endl;
+    std::cout << " - Model exists                                                             " << std::endl;
     std::cout << "                                                                            " << std::endl;
-    std::cout << " ========================== Done SpeedUp Prediction ======================= " << std::endl;
-
-    if (predict_poly >= pass::number_of_threads() * 0.5) // is efficienty is more than 50 %
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " You should activate openMP!                                                " << std::endl;
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
-      return true;
-    }
-    if (predict_poly <= pass::number_of_threads() * 0.2) // efficienty is less than 20 %
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " You should NOT activate openMP!                                            " << std::endl;
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
-      return false;
-    }
-    if (predict_poly > pass::number_of_threads() * 0.2 && predict_poly < pass::number_of_threads() * 0.5)
-    {
-      std::cout << "                                                                            " << std::endl;
-      std::cout << " Decide yourself if to activate openMP or not!                              " << std::endl;
-    }
   }
 
-  std::cout << "                                                                            " << std::endl;
-  std::cout << " =========================  Done openMP Analyse  ========================== " << std::endl;
-  std::cout << "                                                                            " << std::endl;
-  std::cout << "                                                                            " << std::endl;
-
-  return true;
+  return model;
 }
 
 arma::mat pass::train(const int &examples)
 {
+  assert(examples > 1 && "`examples` should be greater than 1");
+
   // Output information
   std::cout << " ============================= Start Trainining =========================== " << std::endl;
   std::cout << "                                                                            " << std::endl;
 
-  // define the maximum of runs
-  arma::uword alg_runs = 2;
-  int max_iter = 200;
+  // Same swarm size as the default parallel swarm search
+  const arma::uword swarm_size = 40;
 
-  arma::rowvec repetitions = pass::integers_uniform_in_range(1, 20000, examples);
-
-  arma::vec serial(alg_runs);
-  arma::vec parallel(alg_runs);
+  // Thread counts 1, 2, 4, ... and the maximal number of threads
+  std::vector<int> thread_counts;
+  for (int threads = 1; threads < pass::number_of_threads(); threads *= 2)
+  {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(pass::number_of_threads());
 
-  arma::mat summary(2, repetitions.size());
+  // Logarithmically spread evaluation times
+  arma::rowvec repetitions = arma::round(arma::exp(arma::linspace<arma::rowvec>(0.0, std::log(20000.0), examples)));
 
-  pass::particle_swarm_optimisation algorithm_serial;
-  algorithm_serial.maximal_iterations = max_iter;
+  arma::mat summary(4, repetitions.n_elem * thread_counts.size());
 
-  pass::parallel_swarm_search algorithm_parallel;
-  algorithm_parallel.maximal_iterations = max_iter;
+  pass::de_jong_function test_problem(10);
+  pass::evaluation_time_stall simulated_problem(test_problem);
+  const arma::mat agents = simulated_problem.normalised_random_agents(swarm_size);
 
-  repetitions = arma::sort(repetitions);
+  pass::stopwatch stopwatch;
+  stopwatch.start();
 
   arma::uword count = 0;
-  for (arma::uword repetition : repetitions)
+  for (arma::uword example = 0; example < repetitions.n_elem; ++example)
   {
-    // Problem initialisation
-    pass::de_jong_function test_problem(10);
-    pass::evaluation_time_stall simulated_problem(test_problem);
-    simulated_problem.repetitions = repetition;
-
-    double ev_time = pass::problem_evaluation_time(simulated_problem);
-    summary(0, count) = ev_time;
+    simulated_problem.repetitions = static_cast<arma::uword>(repetitions(example));
 
-    // Do the evaluation for serial and parallel for all the evaluations values
-    for (arma::uword serial_run = 0; serial_run < alg_runs; ++serial_run)
-    {
-      pass::optimise_result serial_alg = algorithm_serial.optimise(simulated_problem);
-      serial(serial_run) = serial_alg.duration.count();
-      usleep(1000000);
-    }
+    // warm up, and use the serial iteration to derive the evaluation time
+    iteration_time(simulated_problem, agents, 1);
+    const double evaluation_time = iteration_time(simulated_problem, agents, 1) / swarm_size;
 
-    for (arma::uword parallel_run = 0; parallel_run < alg_runs; ++parallel_run)
+    for (const int threads : thread_counts)
     {
-      optimise_result parallel_alg = algorithm_parallel.optimise(simulated_problem);
-      parallel(parallel_run) = parallel_alg.duration.count();
-      usleep(1000000);
+      summary(0, count) = evaluation_time;
+      summary(1, count) = threads;
+      summary(2, count) = iteration_time(simulated_problem, agents, threads);
+      summary(3, count) = swarm_size;
+      count++;
     }
 
-    summary(1, count) = arma::mean(serial) / arma::mean(parallel);
-
-    count++;
-
     // load bar
-    double temp_count = static_cast<double>(examples) / static_cast<double>(count);
     std::cout << std::fixed << std::setprecision(2) << std::setfill(' ');
-    std::cout << " \r " << 100.0 / temp_count << " % completed." << std::flush;
+    std::cout << " \r " << 100.0 * (example + 1) / repetitions.n_elem << " % completed." << std::flush;
   }
 
   std::cout << std::endl
             << std::endl
-            << " Training completed successfully.\n"
+            << " Training completed successfully in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(stopwatch.get_elapsed()).count()
+            << " milliseconds.\n"
             << std::flush;
   std::cout << "                                                                            " << std::endl;
   std::cout << " ===========================  End Training  =============================== " << std::endl;
@@ -218,53 +217,80 @@ arma::mat pass::train(const int &examples)
 
 arma::rowvec pass::build_model(const arma::mat &training_points)
 {
-  // File to save the model
-  std::string file_name;
-  file_name = "openmp_model.pass";
-
-  // Generating a regression object
-  pass::regression r;
-
-  // Getting the data for the model
-  arma::rowvec x_values = training_points.row(0);
-  arma::rowvec y_values = training_points.row(1);
-
   // Output information
   std::cout << " =========================== Start Building Models ======================== " << std::endl;
   std::cout << "                                                                            " << std::endl;
-  std::cout << " Building linear model for the training data.                               " << std::endl;
-  std::cout << "                                                                            " << std::endl;
 
-  // Generating the linear model
-  arma::rowvec linear_model = r.linear_model(x_values, y_values);
+  // The part of the iteration time that is not explained by the evaluations
+  // is modeled as serial_overhead + thread_overhead * (t - 1).
+  arma::rowvec x_values = training_points.row(1) - 1.0;
+  arma::rowvec y_values = training_points.row(2) -
+                          arma::ceil(training_points.row(3) / training_points.row(1)) % training_points.row(0);
 
-  if (linear_model(2) >= 0.9)
-  {
-    std::cout << " Finished building linear model.                                            " << std::endl;
-    std::cout << "                                                                            " << std::endl;
-    std::cout << " Linear Model is suitable.                                                  " << std::endl;
-    std::cout << "                                                                            " << std::endl;
-    std::cout << " ========================= Done Building Models  ========================== " << std::endl;
-    std::cout << "                                                                            " << std::endl;
+  arma::rowvec model(3);
 
-    linear_model.save("./" + file_name, arma::raw_ascii);
-
-    return linear_model;
+  if (arma::all(x_values == 0.0))
+  {
+    // Only one thread; there is no thread overhead to fit
+    model(0) = 0.0;
+    model(1) = arma::mean(y_values);
+    model(2) = 1.0;
+  }
+  else
+  {
+    // Generating a regression object
+    pass::regression r;
+    model = r.linear_model(x_values, y_values);
   }
 
-  std::cout << " Finished building linear model.                                            " << std::endl;
+  std::cout << " Thread overhead:             " << model(0) * 1e-3 << " microseconds." << std::endl;
+  std::cout << " Serial overhead:             " << model(1) * 1e-3 << " microseconds." << std::endl;
+  std::cout << " r^2:                         " << model(2) << std::endl;
   std::cout << "                                                                            " << std::endl;
-  std::cout << " Linear Model is NOT suitable.                                              " << std::endl;
-  std::cout << "                                                                            " << std::endl;
-  std::cout << " Building polynomial model.                                                 " << std::endl;
+  std::cout << " ========================= Done Building Models  ========================== " << std::endl;
   std::cout << "                                                                            " << std::endl;
 
-  arma::rowvec poly_model = r.poly_model(x_values, y_values, 3);
+  model.save(pass::profile_path("openmp_model"), arma::raw_ascii);
 
-  std::cout << " ========================= Done Building Models  ========================== " << std::endl;
-  std::cout << "                                                                            " << std::endl;
+  return model;
+}
 
-  poly_model.save("./" + file_name, arma::raw_ascii);
+double pass::predict_iteration_time(const arma::rowvec &model, const double evaluation_time,
+                                    const arma::uword swarm_size, const int threads)
+{
+  assert(model.n_elem == 3 && "Check the model! It seems to be not compatible with the openMP model");
+  assert(threads > 0 && "The number of threads should be greater than 0");
+
+  // Negative overheads are measurement noise
+  return std::max(0.0, model(1)) +
+         std::ceil(static_cast<double>(swarm_size) / threads) * evaluation_time +
+         std::max(0.0, model(0)) * (threads - 1);
+}
+
+double pass::predict_speedup(const arma::rowvec &model, const double evaluation_time,
+                             const arma::uword swarm_size, const int threads)
+{
+  return predict_iteration_time(model, evaluation_time, swarm_size, 1) /
+         predict_iteration_time(model, evaluation_time, swarm_size, threads);
+}
+
+int pass::optimal_number_of_threads(const arma::rowvec &model, const double evaluation_time,
+                                    const arma::uword swarm_size, const int maximal_threads)
+{
+  int optimal_threads = 1;
+  double optimal_time = predict_iteration_time(model, evaluation_time, swarm_size, 1);
+
+  for (int threads = 2; threads <= maximal_threads; ++threads)
+  {
+    const double time = predict_iteration_time(model, evaluation_time, swarm_size, threads);
+
+    // Prefer fewer threads if more threads do not pay off noticeably
+    if (time < 0.95 * optimal_time)
+    {
+      optimal_threads = threads;
+      optimal_time = time;
+    }
+  }
 
-  return poly_model;
+  return optimal_threads;
 }
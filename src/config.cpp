@@ -41,6 +41,13 @@ double precision(1e-06);
   */
 arma::uword parameter_setting_number_of_runs(30);
 
+/**
+  * Global variables used for evaluations
+  * @parameter_setting_maximal_duration: wall-clock budget of a parameter search
+  * Is initialized to the maximal representable duration, i.e. no limit.
+  */
+std::chrono::nanoseconds parameter_setting_maximal_duration(std::chrono::nanoseconds::max());
+
 /**
  * Use OpenMP
  * @number_of_threads: returns the number of the threads
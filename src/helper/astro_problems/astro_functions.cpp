@@ -9,55 +9,24 @@
 // ------------------------------------------------------------------------ //
 
 #include "pass_bits/helper/astro_problems/astro_functions.hpp"
+#include "pass_bits/helper/astro_problems/astro_helpers.hpp"
+#include "pass_bits/helper/dual.hpp"
 #include <iomanip>
 #include <iostream>
 
-class CZF : public zero_finder::Function1D
+template <typename Scalar>
+Scalar Mean2Eccentric(const Scalar M, const Scalar e)
 {
-public:
-  double operator()(double x)
-  {
-    return p1 * tan(x) - log(tan(0.5 * x + 0.25 * M_PI)) - p2;
-  }
-};
-
-double Mean2Eccentric(const double M, const double e)
-{
-  double Eccentric, Ecc_New;
-
-  if (e < 1.0)
-  {
-    double tolerance = 1e-13;
-    int n_of_it = 0; // Number of iterations
-    double err = 1.0;
-    Eccentric = M + e * cos(M); // Initial guess
-    while ((err > tolerance) && (n_of_it < 100))
-    {
-      Ecc_New = Eccentric - (Eccentric - e * sin(Eccentric) - M) /
-                                (1.0 - e * cos(Eccentric));
-      err = fabs(Eccentric - Ecc_New);
-      Eccentric = Ecc_New;
-      n_of_it++;
-    }
-  }
-  else
-  {
-    CZF FF; // function to find its zero point
-    zero_finder::FZero fz(-0.5 * 3.14159265358979 + 1e-8,
-                          0.5 * 3.14159265358979 - 1e-8);
-    FF.SetParameters(e, M);
-    Ecc_New = fz.FindZero(FF);
-    Eccentric = Ecc_New;
-  }
-  return Eccentric;
+  return pass::mean_to_eccentric(M, e);
 }
 
-void Conversion(const double *E, double *pos, double *vel, const double mu)
+template <typename Scalar>
+void Conversion(const Scalar *E, Scalar *pos, Scalar *vel, const double mu)
 {
-  double a, e, i, omg, omp, theta;
-  double b, n;
-  double X_per[3], X_dotper[3];
-  double R[3][3];
+  Scalar a, e, i, omg, omp, theta;
+  Scalar b, n;
+  Scalar X_per[3], X_dotper[3];
+  Scalar R[3][3];
 
   a = E[0];
   e = E[1];
@@ -69,8 +38,8 @@ void Conversion(const double *E, double *pos, double *vel, const double mu)
   b = a * sqrt(1 - e * e);
   n = sqrt(mu / pow(a, 3));
 
-  const double sin_theta = sin(theta);
-  const double cos_theta = cos(theta);
+  const Scalar sin_theta = sin(theta);
+  const Scalar cos_theta = cos(theta);
 
   X_per[0] = a * (cos_theta - e);
   X_per[1] = b * sin_theta;
@@ -78,12 +47,12 @@ void Conversion(const double *E, double *pos, double *vel, const double mu)
   X_dotper[0] = -(a * n * sin_theta) / (1 - e * cos_theta);
   X_dotper[1] = (b * n * cos_theta) / (1 - e * cos_theta);
 
-  const double cosomg = cos(omg);
-  const double cosomp = cos(omp);
-  const double sinomg = sin(omg);
-  const double sinomp = sin(omp);
-  const double cosi = cos(i);
-  const double sini = sin(i);
+  const Scalar cosomg = cos(omg);
+  const Scalar cosomp = cos(omp);
+  const Scalar sinomg = sin(omg);
+  const Scalar sinomp = sin(omp);
+  const Scalar cosi = cos(i);
+  const Scalar sini = sin(i);
 
   R[0][0] = cosomg * cosomp - sinomg * sinomp * cosi;
   R[0][1] = -cosomg * sinomp - sinomg * cosomp * cosi;
@@ -108,9 +77,10 @@ void Conversion(const double *E, double *pos, double *vel, const double mu)
   return;
 }
 
-double norm(const double *vet1, const double *vet2)
+template <typename Scalar>
+Scalar norm(const Scalar *vet1, const Scalar *vet2)
 {
-  double Vin = 0;
+  Scalar Vin = 0;
   for (int i = 0; i < 3; i++)
   {
     Vin += (vet1[i] - vet2[i]) * (vet1[i] - vet2[i]);
@@ -118,9 +88,10 @@ double norm(const double *vet1, const double *vet2)
   return sqrt(Vin);
 }
 
-double norm2(const double *vet1)
+template <typename Scalar>
+Scalar norm2(const Scalar *vet1)
 {
-  double temp = 0.0;
+  Scalar temp = 0.0;
   for (int i = 0; i < 3; i++)
   {
     temp += vet1[i] * vet1[i];
@@ -129,13 +100,25 @@ double norm2(const double *vet1)
 }
 
 // subfunction that evaluates vector product
-void vett(const double *vet1, const double *vet2, double *prod)
+template <typename Scalar>
+void vett(const Scalar *vet1, const Scalar *vet2, Scalar *prod)
 {
   prod[0] = (vet1[1] * vet2[2] - vet1[2] * vet2[1]);
   prod[1] = (vet1[2] * vet2[0] - vet1[0] * vet2[2]);
   prod[2] = (vet1[0] * vet2[1] - vet1[1] * vet2[0]);
 }
 
+template double Mean2Eccentric(const double, const double);
+template pass::gradient_dual Mean2Eccentric(const pass::gradient_dual, const pass::gradient_dual);
+template void Conversion(const double *, double *, double *, const double);
+template void Conversion(const pass::gradient_dual *, pass::gradient_dual *, pass::gradient_dual *, const double);
+template double norm(const double *, const double *);
+template pass::gradient_dual norm(const pass::gradient_dual *, const pass::gradient_dual *);
+template double norm2(const double *);
+template pass::gradient_dual norm2(const pass::gradient_dual *);
+template void vett(const double *, const double *, double *);
+template void vett(const pass::gradient_dual *, const pass::gradient_dual *, pass::gradient_dual *);
+
 double asinh(double x) { return log(x + sqrt(x * x + 1)); }
 
 double acosh(double x) { return log(x + sqrt(x * x - 1)); }
@@ -1,142 +1,138 @@
 #include "pass_bits/helper/astro_problems/astro_helpers.hpp"
 #include "pass_bits/helper/astro_problems/astro_functions.hpp"
-#include "pass_bits/helper/astro_problems/vector3d_helpers.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
+#include <algorithm> // std::min
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
-pass::lambert_solution pass::lambert(std::array<double, 3> r1,
-                                     std::array<double, 3> r2, double t,
-                                     const double mu, const int lw)
+namespace
 {
-  if (t <= 0)
+const double pi = 3.14159265358979323846;
+
+/**
+ * `x - sin(x)` without cancellation for small `x`.
+ */
+inline double x_minus_sin(const double x)
+{
+  const double x2 = x * x;
+  if (x2 < 1.0)
   {
-    throw std::invalid_argument(
-        "ERROR in Lambert Solver: Negative Time in input.");
+    // x^3/3! - x^5/5! + ..., truncated after x^17
+    return x * x2 / 6.0 * (1.0 - x2 / 20.0 * (1.0 - x2 / 42.0 * (1.0 - x2 / 72.0 * (1.0 - x2 / 110.0 * (1.0 - x2 / 156.0 * (1.0 - x2 / 210.0 * (1.0 - x2 / 272.0)))))));
   }
+  return x - std::sin(x);
+}
 
-  double R = sqrt(pass::gtoc::dot_product(r1, r1));
-  double V = sqrt(mu / R);
-  double T = R / V;
-
-  // working with non-dimensional radii and time-of-flight
-  t /= T;
-  r1 = pass::gtoc::div(r1, R);
-  r2 = pass::gtoc::div(r2, R);
-
-  // Evaluation of the relevant geometry parameters in non dimensional units
-  // R2 module
-  double r2_mod = sqrt(pass::gtoc::dot_product(r2, r2));
-
-  double theta = acos(pass::gtoc::dot_product(r1, r2) / r2_mod);
-
-  if (lw)
-    theta = 2 * acos(-1.0) - theta;
-
-  // non-dimensional chord
-  double c = sqrt(1 + r2_mod * (r2_mod - 2.0 * cos(theta)));
+/**
+ * `sinh(x) - x` without cancellation for small `x`.
+ */
+inline double sinh_minus_x(const double x)
+{
+  const double x2 = x * x;
+  if (x2 < 1.0)
+  {
+    return x * x2 / 6.0 * (1.0 + x2 / 20.0 * (1.0 + x2 / 42.0 * (1.0 + x2 / 72.0 * (1.0 + x2 / 110.0 * (1.0 + x2 / 156.0 * (1.0 + x2 / 210.0 * (1.0 + x2 / 272.0)))))));
+  }
+  return std::sinh(x) - x;
+}
 
-  // non dimesnional semi-perimeter
-  double s = (1 + r2_mod + c) / 2.0;
+/**
+ * Solves `E - e * sin(E) = m` for `e` in [0, 1).
+ *
+ * Starts with Markley's cubic approximation (F. L. Markley, "Kepler Equation
+ * Solver", Celestial Mechanics and Dynamical Astronomy 63, 1995), which is
+ * accurate to about 1e-4, followed by one fourth-order Householder step.
+ */
+inline double elliptic_anomaly(const double m, const double e)
+{
+  // Reduces `m` to [0, pi] using periodicity and symmetry
+  const double turns = std::nearbyint(m / (2.0 * pi));
+  const double reduced = m - turns * 2.0 * pi;
+  const double M = std::fabs(reduced);
+
+  const double alpha = (3.0 * pi * pi + 1.6 * pi * (pi - M) / (1.0 + e)) / (pi * pi - 6.0);
+  const double d = 3.0 * (1.0 - e) + alpha * e;
+  const double q = 2.0 * alpha * d * (1.0 - e) - M * M;
+  const double r = 3.0 * alpha * d * (d - 1.0 + e) * M + M * M * M;
+  const double w = std::pow(std::fabs(r) + std::sqrt(q * q * q + r * r), 2.0 / 3.0);
+  double E = (2.0 * r * w / (w * w + w * q + q * q) + M) / d;
+
+  const double e_sin = e * std::sin(E);
+  const double e_cos = e * std::cos(E);
+  // E - e sin(E) - M, rearranged to avoid cancellation close to e = 1
+  const double f = x_minus_sin(E) + (1.0 - e) * std::sin(E) - M;
+  const double f1 = 1.0 - e_cos;
+  const double newton = -f / f1;
+  const double halley = -f / (f1 + 0.5 * newton * e_sin);
+  E += -f / (f1 + 0.5 * halley * e_sin + halley * halley * e_cos / 6.0);
+
+  return std::copysign(E, reduced) + turns * 2.0 * pi;
+}
 
-  // minimum energy ellipse semi major axis
-  double am = s / 2.0;
+/**
+ * Solves `e * sinh(H) - H = m` for `e` >= 1 and returns the Gudermannian
+ * `atan(sinh(H))`, as expected by the ESA code.
+ *
+ * The start is the smaller of two upper bounds: the root of the cubic
+ * truncation `(e - 1) H + e H^3 / 6 = |m|` (tight for small H), and
+ * `asinh((|m| + H_cubic) / e)` (tight for large H). From above, the
+ * iteration cannot overshoot into the flat region around 0, so two
+ * fourth-order Householder steps suffice.
+ */
+inline double hyperbolic_anomaly(const double m, const double e)
+{
+  const double M = std::fabs(m);
 
-  // lambda parameter defined in Battin's Book
-  double lambda = sqrt(r2_mod) * cos(theta / 2.0) / s;
+  // H^3 + p H = q, solved with Cardano's formula in a cancellation free form
+  const double p = 6.0 * (e - 1.0) / e;
+  const double q = 6.0 * M / e;
+  const double u = std::cbrt(0.5 * q + std::sqrt(0.25 * q * q + p * p * p / 27.0));
+  const double cubic = u > 0.0 ? u - p / (3.0 * u) : 0.0;
+  double H = std::min(cubic, std::asinh((M + cubic) / e));
 
-  double x;
+  for (int iteration = 0; iteration < 2; ++iteration)
   {
-    // We start finding the log(x+1) value of the solution conic:
-    // NO MULTI REV --> (1 SOL)
-    //	inn1=-.5233;    //first guess point
-    //  inn2=.5233;     //second guess point
-    double x1 = log(0.4767);
-    double x2 = log(1.5233);
-    double y1 = log(x2tof(-.5233, s, c, lw)) - log(t);
-    double y2 = log(x2tof(.5233, s, c, lw)) - log(t);
-
-    // Increasing the tolerance does not bring any advantage as the
-    // precision is usually greater anyway (due to the rectification of the tof
-    // graph) except near particular cases such as parabolas in which cases a
-    // lower precision allow for usual convergence.
-    const double tolerance = 1e-11;
-    double error = 1;
-
-    // Newton iterations
-    double x_new = 0.0;
-    while ((error > tolerance) && (y1 != y2))
+    const double e_sinh = e * std::sinh(H);
+    const double e_cosh = e * std::cosh(H);
+    // e sinh(H) - H - M, rearranged to avoid cancellation close to e = 1
+    const double f = sinh_minus_x(H) + (e - 1.0) * std::sinh(H) - M;
+    const double f1 = e_cosh - 1.0;
+    if (f1 <= 0.0)
     {
-      x_new = (x1 * y2 - y1 * x2) / (y2 - y1);
-      double y_new = logf(x2tof(expf(x_new) - 1, s, c, lw)) - logf(t);
-      x1 = x2;
-      y1 = y2;
-      x2 = x_new;
-      y2 = y_new;
-      error = fabs(x1 - x_new);
+      // Only at H = 0 with e = 1, i.e. M = 0
+      break;
     }
-    x = expf(x_new) - 1;
+    const double newton = -f / f1;
+    const double halley = -f / (f1 + 0.5 * newton * e_sinh);
+    H += -f / (f1 + 0.5 * halley * e_sinh + halley * halley * e_cosh / 6.0);
   }
 
-  // The solution has been evaluated in terms of log(x+1) or tan(x*pi/2), we
-  // now need the conic. As for transfer angles near to pi the lagrange
-  // coefficient technique goes singular (dg approaches a zero/zero that is
-  // numerically bad) we here use a different technique for those cases. When
-  // the transfer angle is exactly equal to pi, then the ih unit vector is not
-  // determined. The remaining equations, though, are still valid.
+  return std::copysign(std::atan(std::sinh(H)), m);
+}
+} // namespace
+
+pass::lambert_solution pass::lambert(std::array<double, 3> r1,
+                                     std::array<double, 3> r2, double t,
+                                     const double mu, const int lw)
+{
+  pass::lambert_solution solution;
 
-  double a = am / (1 - x * x);
+  const lambert_error error =
+      solve_lambert(r1.data(), r2.data(), t, mu, lw != 0,
+                    solution.departure_velocity.data(), solution.arrival_velocity.data());
 
-  double eta, eta_squared;
-  // psi evaluation
-  if (x < 1)
+  if (error == lambert_error::non_positive_time_of_flight)
   {
-    // ellipse
-    double beta = 2 * asin(sqrt((s - c) / (2 * a)));
-    if (lw)
-      beta = -beta;
-    double alfa = 2 * acos(x);
-    double psi = (alfa - beta) / 2;
-    eta_squared = 2 * a * pow(sin(psi), 2) / s;
-    eta = sqrt(eta_squared);
+    throw std::invalid_argument(
+        "ERROR in Lambert Solver: Negative Time in input.");
   }
-  else
+  else if (error != lambert_error::none)
   {
-    // hyperbola
-    double beta = 2 * asinh(sqrt((c - s) / (2 * a)));
-    if (lw)
-      beta = -beta;
-    double alfa = 2 * acosh(x);
-    double psi = (alfa - beta) / 2;
-    eta_squared = -2 * a * pow(sinh(psi), 2) / s;
-    eta = sqrt(eta_squared);
+    solution.departure_velocity.fill(std::numeric_limits<double>::quiet_NaN());
+    solution.arrival_velocity.fill(std::numeric_limits<double>::quiet_NaN());
   }
 
-  // parameter of the solution
-  double p = (r2_mod / (am * eta_squared)) * pow(sin(theta / 2), 2);
-
-  std::array<double, 3> ih =
-      pass::gtoc::unit_vector(pass::gtoc::cross_product(r1, r2));
-  if (lw)
-    ih = pass::gtoc::mul(ih, -1);
-
-  pass::lambert_solution solution;
-
-  double vr1 = (1 / (eta * sqrt(am))) * (2 * lambda * am - (lambda + x * eta));
-  double vt1 = sqrt(p);
-  solution.departure_velocity = pass::gtoc::mul(
-      pass::gtoc::add(pass::gtoc::mul(r1, vr1),
-                      pass::gtoc::mul(pass::gtoc::cross_product(ih, r1), vt1)),
-      V);
-
-  double vt2 = vt1 / r2_mod;
-  double vr2 = -vr1 + (vt1 - vt2) / tan(theta / 2);
-  solution.arrival_velocity = pass::gtoc::mul(
-      pass::gtoc::add(
-          pass::gtoc::div(pass::gtoc::mul(r2, vr2), r2_mod),
-          pass::gtoc::mul(
-              pass::gtoc::cross_product(ih, pass::gtoc::unit_vector(r2)), vt2)),
-      V);
-
   return solution;
 }
 
@@ -236,5 +232,42 @@ std::pair<std::array<double, 3>, std::array<double, 3>> pass::conversion(
 
 double pass::mean_to_eccentric(const double m, const double e)
 {
-  return Mean2Eccentric(m, e);
+  return e < 1.0 ? elliptic_anomaly(m, e) : hyperbolic_anomaly(m, e);
+}
+
+void pass::mean_to_eccentric(const double *m, const double *e,
+                             double *eccentric_anomaly, const std::size_t n)
+{
+  // Every element takes the same fixed amount of work, without iterating
+  // until convergence.
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    eccentric_anomaly[i] = e[i] < 1.0 ? elliptic_anomaly(m[i], e[i]) : hyperbolic_anomaly(m[i], e[i]);
+  }
+}
+
+pass::gradient_dual pass::mean_to_eccentric(const gradient_dual &m, const gradient_dual &e)
+{
+  gradient_dual E = mean_to_eccentric(m.value, e.value);
+
+  // Differentiates E - e sin(E) = m, or e sinh(H) - H = m for the Gudermannian
+  // E = atan(sinh(H)), with sinh(H) = tan(E) and cosh(H) = 1 / cos(E)
+  double dm, de;
+  if (e.value < 1.0)
+  {
+    dm = 1.0 / (1.0 - e.value * std::cos(E.value));
+    de = std::sin(E.value) * dm;
+  }
+  else
+  {
+    const double cos_E = std::cos(E.value);
+    dm = cos_E / (e.value / cos_E - 1.0);
+    de = -std::tan(E.value) * dm;
+  }
+
+  for (std::size_t i = 0; i < E.derivatives.size(); ++i)
+  {
+    E.derivatives[i] = dm * m.derivatives[i] + de * e.derivatives[i];
+  }
+  return E;
 }
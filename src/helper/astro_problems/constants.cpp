@@ -6,19 +6,19 @@
 
 namespace pass
 {
-const celestial_body celestial_body::SUN(1.32712428e11, 0, 0);
-const celestial_body celestial_body::MERCURY(22321, 0, 0);
-const celestial_body celestial_body::VENUS(324860, 6351.8, 0.01);
-const celestial_body celestial_body::EARTH(398601.19, 6778.1, 0.01);
-const celestial_body celestial_body::MARS(42828.3, 6000, 0.01);
-const celestial_body celestial_body::JUPITER(126.7e6, 600000, 0.001);
-const celestial_body celestial_body::SATURN(37.9e6, 70000, 0.01);
-const celestial_body celestial_body::URANUS(5.78e6, 0, 0);
-const celestial_body celestial_body::NEPTUNE(6.8e6, 0, 0);
+const celestial_body celestial_body::SUN(0, 1.32712428e11, 0, 0);
+const celestial_body celestial_body::MERCURY(1, 22321, 0, 0);
+const celestial_body celestial_body::VENUS(2, 324860, 6351.8, 0.01);
+const celestial_body celestial_body::EARTH(3, 398601.19, 6778.1, 0.01);
+const celestial_body celestial_body::MARS(4, 42828.3, 6000, 0.01);
+const celestial_body celestial_body::JUPITER(5, 126.7e6, 600000, 0.001);
+const celestial_body celestial_body::SATURN(6, 37.9e6, 70000, 0.01);
+const celestial_body celestial_body::URANUS(7, 5.78e6, 0, 0);
+const celestial_body celestial_body::NEPTUNE(8, 6.8e6, 0, 0);
 
-celestial_body::celestial_body(double mu, double penalty,
+celestial_body::celestial_body(int id, double mu, double penalty,
                                double penalty_coefficient) noexcept
-    : mu(mu), penalty(penalty), penalty_coefficient(penalty_coefficient) {}
+    : id(id), mu(mu), penalty(penalty), penalty_coefficient(penalty_coefficient) {}
 
 std::pair<std::array<double, 3>, std::array<double, 3>>
 celestial_body::ephemeris(const double mjd2000) const
@@ -32,7 +32,9 @@ celestial_body::ephemeris(const double mjd2000) const
 
   double T = (mjd2000 + 36525.00) / 36525.00;
 
-  if (this == &celestial_body::MERCURY)
+  switch (id)
+  {
+  case 1: // Mercury
   {
     Kepl_Par[0] = (0.38709860);
     Kepl_Par[1] = (0.205614210 + 0.000020460 * T - 0.000000030 * T * T);
@@ -44,8 +46,9 @@ celestial_body::ephemeris(const double mjd2000) const
                    1.20833333333333333e-4 * T * T);
     XM = 1.49472515288888889e+5 + 6.38888888888888889e-6 * T;
     Kepl_Par[5] = (1.02279380555555556e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::VENUS)
+  case 2: // Venus
   {
     Kepl_Par[0] = (0.72333160);
     Kepl_Par[1] = (0.006820690 - 0.000047740 * T + 0.0000000910 * T * T);
@@ -56,8 +59,9 @@ celestial_body::ephemeris(const double mjd2000) const
                    1.38638888888888889e-3 * T * T);
     XM = 5.8517803875e+4 + 1.28605555555555556e-3 * T;
     Kepl_Par[5] = (2.12603219444444444e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::EARTH)
+  case 3: // Earth
   {
     Kepl_Par[0] = (1.000000230);
     Kepl_Par[1] = (0.016751040 - 0.000041800 * T - 0.0000001260 * T * T);
@@ -69,8 +73,9 @@ celestial_body::ephemeris(const double mjd2000) const
     XM = 3.599904975e+4 - 1.50277777777777778e-4 * T -
          3.33333333333333333e-6 * T * T;
     Kepl_Par[5] = (3.58475844444444444e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::MARS)
+  case 4: // Mars
   {
     Kepl_Par[0] = (1.5236883990);
     Kepl_Par[1] = (0.093312900 + 0.0000920640 * T - 0.0000000770 * T * T);
@@ -84,8 +89,9 @@ celestial_body::ephemeris(const double mjd2000) const
     XM = 1.91398585e+4 + 1.80805555555555556e-4 * T +
          1.19444444444444444e-6 * T * T;
     Kepl_Par[5] = (3.19529425e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::JUPITER)
+  case 5: // Jupiter
   {
     Kepl_Par[0] = (5.2025610);
     Kepl_Par[1] = (0.048334750 + 0.000164180 * T - 0.00000046760 * T * T -
@@ -100,8 +106,9 @@ celestial_body::ephemeris(const double mjd2000) const
     XM = 3.03469202388888889e+3 - 7.21588888888888889e-4 * T +
          1.78444444444444444e-6 * T * T;
     Kepl_Par[5] = (2.25328327777777778e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::SATURN)
+  case 6: // Saturn
   {
     Kepl_Par[0] = (9.5547470);
     Kepl_Par[1] = (0.055892320 - 0.00034550 * T - 0.0000007280 * T * T +
@@ -118,8 +125,9 @@ celestial_body::ephemeris(const double mjd2000) const
     XM = 1.22155146777777778e+3 - 5.01819444444444444e-4 * T -
          5.19444444444444444e-6 * T * T;
     Kepl_Par[5] = (1.75466216666666667e2 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::URANUS)
+  case 7: // Uranus
   {
     Kepl_Par[0] = (19.218140);
     Kepl_Par[1] = (0.04634440 - 0.000026580 * T + 0.0000000770 * T * T);
@@ -133,8 +141,9 @@ celestial_body::ephemeris(const double mjd2000) const
     XM = 4.28379113055555556e+2 + 7.88444444444444444e-5 * T +
          1.11111111111111111e-9 * T * T;
     Kepl_Par[5] = (7.26488194444444444e1 + XM * T);
+    break;
   }
-  else if (this == &celestial_body::NEPTUNE)
+  case 8: // Neptune
   {
     Kepl_Par[0] = (30.109570);
     Kepl_Par[1] = (0.008997040 + 0.0000063300 * T - 0.0000000020 * T * T);
@@ -147,9 +156,9 @@ celestial_body::ephemeris(const double mjd2000) const
                    1.4095e-4 * T * T + 4.11333333333333333e-6 * T * T * T);
     XM = 2.18461339722222222e+2 - 7.03333333333333333e-5 * T;
     Kepl_Par[5] = (3.77306694444444444e1 + XM * T);
+    break;
   }
-  else
-  {
+  default:
     throw std::domain_error(
         "`celestial_body::conversion` not implemented for SUN");
   }
@@ -0,0 +1,174 @@
+#include "pass_bits/helper/astro_problems/ephemeris_table.hpp"
+#include <algorithm> // std::max, std::min
+#include <cmath>     // std::cos, std::ceil, std::sqrt
+#include <stdexcept> // std::invalid_argument
+
+namespace
+{
+/**
+ * Longest and shortest segment lengths in days. 32 days keep the error of
+ * the slowly moving outer planets far below any sensible tolerance; Mercury
+ * and eccentric asteroids need shorter segments.
+ */
+const double maximal_segment_length = 32.0;
+const double minimal_segment_length = 1.0 / 64.0;
+
+/**
+ * Evaluates the Chebyshev series of all 6 components at `x` in [-1, 1] with
+ * the Clenshaw recurrence.
+ */
+void clenshaw(const double *coefficients, const double x, double *r, double *v)
+{
+  const std::size_t terms = pass::ephemeris_table::degree + 1;
+  double b1[6] = {};
+  double b2[6] = {};
+
+  for (std::size_t k = terms - 1; k > 0; --k)
+  {
+    const double *c = coefficients + 6 * k;
+    for (int n = 0; n < 6; ++n)
+    {
+      const double b0 = c[n] + 2.0 * x * b1[n] - b2[n];
+      b2[n] = b1[n];
+      b1[n] = b0;
+    }
+  }
+
+  for (int n = 0; n < 3; ++n)
+  {
+    r[n] = coefficients[n] + x * b1[n] - b2[n];
+    v[n] = coefficients[n + 3] + x * b1[n + 3] - b2[n + 3];
+  }
+}
+
+double relative_error(const double *expected, const double *actual)
+{
+  double difference = 0.0;
+  double magnitude = 0.0;
+  for (int n = 0; n < 3; ++n)
+  {
+    difference += (expected[n] - actual[n]) * (expected[n] - actual[n]);
+    magnitude += expected[n] * expected[n];
+  }
+
+  return magnitude > 0.0 ? std::sqrt(difference / magnitude) : std::sqrt(difference);
+}
+} // namespace
+
+constexpr std::size_t pass::ephemeris_table::degree;
+constexpr std::size_t pass::ephemeris_table::coefficients_per_segment;
+
+pass::ephemeris_table::ephemeris_table(const analytical_ephemeris &ephemeris,
+                                       const double start, const double end,
+                                       const double tolerance)
+    : fallback(ephemeris),
+      start(start),
+      end(end),
+      length(std::max(minimal_segment_length, std::min(maximal_segment_length, end - start))),
+      inverse_length(1.0 / length),
+      number_of_segments(0)
+{
+  if (start > end)
+  {
+    throw std::invalid_argument("`start` must be less than or equal to `end`.");
+  }
+  if (tolerance <= 0.0)
+  {
+    throw std::invalid_argument("`tolerance` must be positive.");
+  }
+
+  while (fit() > tolerance && length > minimal_segment_length)
+  {
+    length /= 2.0;
+  }
+}
+
+double pass::ephemeris_table::fit()
+{
+  const double pi = std::acos(-1.0);
+  const std::size_t terms = degree + 1;
+
+  inverse_length = 1.0 / length;
+  number_of_segments = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((end - start) * inverse_length)));
+  coefficients.assign(number_of_segments * coefficients_per_segment, 0.0);
+
+  // cos(pi * k * (j + 0.5) / terms), shared by all segments
+  std::vector<double> basis(terms * terms);
+  for (std::size_t k = 0; k < terms; ++k)
+  {
+    for (std::size_t j = 0; j < terms; ++j)
+    {
+      basis[k * terms + j] = std::cos(pi * k * (j + 0.5) / terms);
+    }
+  }
+
+  std::vector<double> values(6 * terms);
+  double maximal_error = 0.0;
+
+  for (std::size_t segment = 0; segment < number_of_segments; ++segment)
+  {
+    const double half_length = 0.5 * length;
+    const double middle = start + segment * length + half_length;
+
+    // Interpolates at the Chebyshev nodes x_j = cos(pi * (j + 0.5) / terms)
+    for (std::size_t j = 0; j < terms; ++j)
+    {
+      fallback(middle + half_length * basis[terms + j], &values[6 * j], &values[6 * j + 3]);
+    }
+
+    double *c = &coefficients[segment * coefficients_per_segment];
+    for (std::size_t k = 0; k < terms; ++k)
+    {
+      const double scale = (k == 0 ? 1.0 : 2.0) / terms;
+      for (int n = 0; n < 6; ++n)
+      {
+        double sum = 0.0;
+        for (std::size_t j = 0; j < terms; ++j)
+        {
+          sum += values[6 * j + n] * basis[k * terms + j];
+        }
+        c[6 * k + n] = scale * sum;
+      }
+    }
+
+    // The error is largest between the nodes, especially close to the ends.
+    for (const double x : {-0.99, -0.5, 0.0, 0.5, 0.99})
+    {
+      double expected_r[3], expected_v[3], r[3], v[3];
+      fallback(middle + half_length * x, expected_r, expected_v);
+      clenshaw(c, x, r, v);
+      maximal_error = std::max(maximal_error, std::max(relative_error(expected_r, r),
+                                                       relative_error(expected_v, v)));
+    }
+  }
+
+  return maximal_error;
+}
+
+void pass::ephemeris_table::evaluate(const double mjd2000, double *r, double *v) const
+{
+  if (!(mjd2000 >= start && mjd2000 <= end))
+  {
+    fallback(mjd2000, r, v);
+    return;
+  }
+
+  const std::size_t segment = std::min(number_of_segments - 1,
+                                       static_cast<std::size_t>((mjd2000 - start) * inverse_length));
+  const double x = 2.0 * ((mjd2000 - start) * inverse_length - segment) - 1.0;
+
+  clenshaw(&coefficients[segment * coefficients_per_segment], x, r, v);
+}
+
+std::pair<std::array<double, 3>, std::array<double, 3>> pass::ephemeris_table::ephemeris(
+    const double mjd2000) const
+{
+  std::pair<std::array<double, 3>, std::array<double, 3>> result;
+  evaluate(mjd2000, result.first.data(), result.second.data());
+  return result;
+}
+
+double pass::ephemeris_table::segment_length() const
+{
+  return length;
+}
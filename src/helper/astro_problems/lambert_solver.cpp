@@ -0,0 +1,349 @@
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
+#include "pass_bits/helper/dual.hpp"
+#include <cmath> // std::sqrt, std::acos, std::log, ...
+
+namespace
+{
+// Unqualified, so that dual numbers find their overloads by argument-dependent
+// lookup
+using std::acos;
+using std::acosh;
+using std::asin;
+using std::asinh;
+using std::copysign;
+using std::fabs;
+using std::fmax;
+using std::isfinite;
+using std::log;
+using std::pow;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+
+/**
+ * Gauss' hypergeometric function 2F1(3, 1, 5/2, z), used by Battin's series
+ * close to the parabola.
+ */
+template <typename Scalar>
+Scalar hypergeometric(const Scalar z)
+{
+  Scalar sum = 1.0;
+  Scalar term = 1.0;
+  for (int j = 0; j < 100 && fabs(term) > 1e-14; ++j)
+  {
+    term *= (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1.0);
+    sum += term;
+  }
+  return sum;
+}
+
+/**
+ * Non-dimensional time of flight as a function of `x` for `lambda`.
+ *
+ * Depending on the distance to the parabola (x = 1), uses Battin's series,
+ * Lagrange's or Lancaster's expression, each where it is numerically stable.
+ */
+template <typename Scalar>
+Scalar non_dimensional_time(const Scalar x, const Scalar lambda)
+{
+  const Scalar distance = fabs(x - 1.0);
+
+  if (distance < 0.2 && distance > 0.01)
+  {
+    // Lagrange
+    const Scalar a = 1.0 / (1.0 - x * x);
+    if (a > 0.0)
+    {
+      const Scalar alpha = 2.0 * acos(x);
+      const Scalar beta = copysign(2.0 * asin(sqrt(lambda * lambda / a)), lambda);
+      return a * sqrt(a) * ((alpha - sin(alpha)) - (beta - sin(beta))) / 2.0;
+    }
+    const Scalar alpha = 2.0 * acosh(x);
+    const Scalar beta = copysign(2.0 * asinh(sqrt(-lambda * lambda / a)), lambda);
+    return -a * sqrt(-a) * ((beta - sinh(beta)) - (alpha - sinh(alpha))) / 2.0;
+  }
+
+  const Scalar E = x * x - 1.0;
+  const Scalar z = sqrt(1.0 + lambda * lambda * E);
+
+  if (distance <= 0.01)
+  {
+    // Battin
+    const Scalar eta = z - lambda * x;
+    const Scalar S1 = 0.5 * (1.0 - lambda - x * eta);
+    const Scalar Q = 4.0 / 3.0 * hypergeometric(S1);
+    return (eta * eta * eta * Q + 4.0 * lambda * eta) / 2.0;
+  }
+
+  // Lancaster
+  const Scalar y = sqrt(fabs(E));
+  const Scalar g = x * z - lambda * E;
+  const Scalar d = E < 0.0 ? acos(g) : log(y * (z - lambda * x) + g);
+  return (x - lambda * z - d / y) / E;
+}
+
+/**
+ * The geometry of a Lambert problem, shared by the solver and the refinement.
+ */
+template <typename Scalar>
+struct transfer
+{
+  Scalar c;
+  Scalar R1;
+  Scalar R2;
+  Scalar s;
+  Scalar ir1[3];
+  Scalar ir2[3];
+  Scalar ih[3];
+  Scalar lambda2;
+  Scalar lambda;
+  Scalar lambda3;
+  /**
+   * Non-dimensional time of flight
+   */
+  Scalar T;
+};
+
+template <typename Scalar>
+pass::lambert_error prepare_transfer(const Scalar *r1, const Scalar *r2,
+                                     const Scalar time_of_flight, const double mu,
+                                     const bool long_way, transfer<Scalar> &t)
+{
+  if (!(time_of_flight > 0.0))
+  {
+    return pass::lambert_error::non_positive_time_of_flight;
+  }
+
+  const Scalar chord[3] = {r2[0] - r1[0], r2[1] - r1[1], r2[2] - r1[2]};
+  t.c = sqrt(chord[0] * chord[0] + chord[1] * chord[1] + chord[2] * chord[2]);
+  t.R1 = sqrt(r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2]);
+  t.R2 = sqrt(r2[0] * r2[0] + r2[1] * r2[1] + r2[2] * r2[2]);
+  t.s = (t.c + t.R1 + t.R2) / 2.0;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    t.ir1[i] = r1[i] / t.R1;
+    t.ir2[i] = r2[i] / t.R2;
+  }
+
+  // Normal of the transfer plane, in direction of the angular momentum
+  t.ih[0] = t.ir1[1] * t.ir2[2] - t.ir1[2] * t.ir2[1];
+  t.ih[1] = t.ir1[2] * t.ir2[0] - t.ir1[0] * t.ir2[2];
+  t.ih[2] = t.ir1[0] * t.ir2[1] - t.ir1[1] * t.ir2[0];
+  const Scalar ih_norm = sqrt(t.ih[0] * t.ih[0] + t.ih[1] * t.ih[1] + t.ih[2] * t.ih[2]);
+  if (!(ih_norm > 0.0))
+  {
+    return pass::lambert_error::undefined_transfer_plane;
+  }
+  const double direction = long_way ? -1.0 : 1.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    t.ih[i] *= direction / ih_norm;
+  }
+
+  t.lambda2 = 1.0 - t.c / t.s;
+  t.lambda = direction * sqrt(fmax(0.0, t.lambda2));
+  t.lambda3 = t.lambda * t.lambda2;
+
+  t.T = sqrt(2.0 * mu / (t.s * t.s * t.s)) * time_of_flight;
+
+  return pass::lambert_error::none;
+}
+
+template <typename Scalar>
+Scalar initial_guess(const transfer<Scalar> &t)
+{
+  const Scalar T0 = acos(t.lambda) + t.lambda * sqrt(1.0 - t.lambda2);
+  const Scalar T1 = 2.0 / 3.0 * (1.0 - t.lambda3);
+  if (t.T >= T0)
+  {
+    return pow(T0 / t.T, 2.0 / 3.0) - 1.0;
+  }
+  if (t.T < T1)
+  {
+    return 5.0 / 2.0 * T1 / t.T * (T1 - t.T) / (1.0 - t.lambda2 * t.lambda3) + 1.0;
+  }
+  return pow(t.T / T0, log(2.0) / log(T1 / T0)) - 1.0;
+}
+
+/**
+ * Performs a Householder iteration on `x` and returns the step.
+ */
+template <typename Scalar>
+Scalar householder_step(const transfer<Scalar> &t, Scalar &x)
+{
+  const Scalar tof = non_dimensional_time(x, t.lambda);
+  const Scalar umx2 = 1.0 - x * x;
+  const Scalar y = sqrt(1.0 - t.lambda2 * umx2);
+  const Scalar y3 = y * y * y;
+  const Scalar dT = (3.0 * tof * x - 2.0 + 2.0 * t.lambda3 * x / y) / umx2;
+  const Scalar ddT = (3.0 * tof + 5.0 * x * dT + 2.0 * (1.0 - t.lambda2) * t.lambda3 / y3) / umx2;
+  const Scalar dddT = (7.0 * x * ddT + 8.0 * dT - 6.0 * (1.0 - t.lambda2) * t.lambda2 * t.lambda3 * x / (y3 * y * y)) / umx2;
+
+  const Scalar delta = tof - t.T;
+  const Scalar dT2 = dT * dT;
+  const Scalar step = delta * (dT2 - delta * ddT / 2.0) / (dT * (dT2 - delta * ddT) + dddT * delta * delta / 6.0);
+  x -= step;
+
+  return step;
+}
+
+/**
+ * Computes the terminal velocities for the solution `x`.
+ */
+template <typename Scalar>
+void terminal_velocities(const transfer<Scalar> &t, const Scalar x, const double mu, Scalar *v1, Scalar *v2)
+{
+  // Split into radial and tangential components
+  const Scalar gamma = sqrt(mu * t.s / 2.0);
+  const Scalar rho = (t.R1 - t.R2) / t.c;
+  const Scalar sigma = sqrt(fmax(0.0, 1.0 - rho * rho));
+  const Scalar y = sqrt(1.0 - t.lambda2 + t.lambda2 * x * x);
+  const Scalar vr1 = gamma * ((t.lambda * y - x) - rho * (t.lambda * y + x)) / t.R1;
+  const Scalar vr2 = -gamma * ((t.lambda * y - x) + rho * (t.lambda * y + x)) / t.R2;
+  const Scalar vt = gamma * sigma * (y + t.lambda * x);
+  const Scalar vt1 = vt / t.R1;
+  const Scalar vt2 = vt / t.R2;
+
+  // Tangential directions ih x ir
+  const Scalar it1[3] = {t.ih[1] * t.ir1[2] - t.ih[2] * t.ir1[1],
+                         t.ih[2] * t.ir1[0] - t.ih[0] * t.ir1[2],
+                         t.ih[0] * t.ir1[1] - t.ih[1] * t.ir1[0]};
+  const Scalar it2[3] = {t.ih[1] * t.ir2[2] - t.ih[2] * t.ir2[1],
+                         t.ih[2] * t.ir2[0] - t.ih[0] * t.ir2[2],
+                         t.ih[0] * t.ir2[1] - t.ih[1] * t.ir2[0]};
+
+  for (int i = 0; i < 3; ++i)
+  {
+    v1[i] = vr1 * t.ir1[i] + vt1 * it1[i];
+    v2[i] = vr2 * t.ir2[i] + vt2 * it2[i];
+  }
+}
+
+/**
+ * Solves the Lambert problem with the tolerances of `Fidelity`, see
+ * `pass::solve_lambert`.
+ */
+template <typename Fidelity, typename Scalar>
+pass::lambert_error solve(const Scalar *r1, const Scalar *r2,
+                          const Scalar time_of_flight, const double mu,
+                          const bool long_way, Scalar *v1, Scalar *v2,
+                          Scalar *x)
+{
+  transfer<Scalar> t;
+  const pass::lambert_error error = prepare_transfer(r1, r2, time_of_flight, mu, long_way, t);
+  if (error != pass::lambert_error::none)
+  {
+    return error;
+  }
+
+  Scalar solution = initial_guess(t);
+
+  // Householder iterations
+  bool is_converged = false;
+  for (int iteration = 0; iteration < Fidelity::lambert_iterations && !is_converged; ++iteration)
+  {
+    // The convergence is cubic, so the remaining error is far below the step.
+    is_converged = fabs(householder_step(t, solution)) < Fidelity::lambert_tolerance;
+  }
+
+  if (!is_converged || !isfinite(solution))
+  {
+    return pass::lambert_error::not_converged;
+  }
+
+  terminal_velocities(t, solution, mu, v1, v2);
+  if (x != nullptr)
+  {
+    *x = solution;
+  }
+
+  return pass::lambert_error::none;
+}
+} // namespace
+
+pass::lambert_error pass::solve_lambert(const double *r1, const double *r2,
+                                        const double time_of_flight, const double mu,
+                                        const bool long_way, double *v1, double *v2,
+                                        double *x)
+{
+  return solve<high_fidelity>(r1, r2, time_of_flight, mu, long_way, v1, v2, x);
+}
+
+template <typename Fidelity, typename Scalar>
+pass::lambert_error pass::solve_lambert(const Scalar *r1, const Scalar *r2,
+                                        const Scalar time_of_flight, const double mu,
+                                        const bool long_way, Scalar *v1, Scalar *v2)
+{
+  return solve<Fidelity, Scalar>(r1, r2, time_of_flight, mu, long_way, v1, v2, nullptr);
+}
+
+pass::lambert_error pass::refine_lambert(const double *r1, const double *r2,
+                                         const double time_of_flight, const double mu,
+                                         const bool long_way, const double x,
+                                         const int iterations, double *v1, double *v2)
+{
+  transfer<double> t;
+  const lambert_error error = prepare_transfer(r1, r2, time_of_flight, mu, long_way, t);
+  if (error != lambert_error::none)
+  {
+    return error;
+  }
+
+  double solution = x;
+  for (int iteration = 0; iteration < iterations; ++iteration)
+  {
+    householder_step(t, solution);
+  }
+
+  if (!std::isfinite(solution))
+  {
+    return lambert_error::not_converged;
+  }
+
+  terminal_velocities(t, solution, mu, v1, v2);
+
+  return lambert_error::none;
+}
+
+void pass::solve_lambert(const double *r1, const double *r2,
+                         const double *time_of_flight, const bool *long_way,
+                         const double mu, const std::size_t n, double *v1,
+                         double *v2, lambert_error *errors)
+{
+  solve_lambert<high_fidelity>(r1, r2, time_of_flight, long_way, mu, n, v1, v2, errors);
+}
+
+template <typename Fidelity>
+void pass::solve_lambert(const double *r1, const double *r2,
+                         const double *time_of_flight, const bool *long_way,
+                         const double mu, const std::size_t n, double *v1,
+                         double *v2, lambert_error *errors)
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const lambert_error error = solve<Fidelity, double>(r1 + 3 * i, r2 + 3 * i, time_of_flight[i], mu,
+                                                        long_way[i], v1 + 3 * i, v2 + 3 * i, nullptr);
+    if (errors != nullptr)
+    {
+      errors[i] = error;
+    }
+  }
+}
+
+template pass::lambert_error pass::solve_lambert<pass::high_fidelity>(
+    const double *, const double *, const double, const double, const bool, double *, double *);
+template pass::lambert_error pass::solve_lambert<pass::low_fidelity>(
+    const double *, const double *, const double, const double, const bool, double *, double *);
+template pass::lambert_error pass::solve_lambert<pass::high_fidelity>(
+    const gradient_dual *, const gradient_dual *, const gradient_dual, const double, const bool,
+    gradient_dual *, gradient_dual *);
+template pass::lambert_error pass::solve_lambert<pass::low_fidelity>(
+    const gradient_dual *, const gradient_dual *, const gradient_dual, const double, const bool,
+    gradient_dual *, gradient_dual *);
+template void pass::solve_lambert<pass::high_fidelity>(
+    const double *, const double *, const double *, const bool *, const double, const std::size_t,
+    double *, double *, lambert_error *);
+template void pass::solve_lambert<pass::low_fidelity>(
+    const double *, const double *, const double *, const bool *, const double, const std::size_t,
+    double *, double *, lambert_error *);
@@ -9,186 +9,290 @@
 // ------------------------------------------------------------------------ //
 
 #include <math.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #include "pass_bits/helper/astro_problems/pl_eph_an.hpp"
 #include "pass_bits/helper/astro_problems/mga.hpp"
-#include "pass_bits/helper/astro_problems/lambert.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
 #include "pass_bits/helper/astro_problems/pow_swing_by_inv.hpp"
 #include "pass_bits/helper/astro_problems/astro_functions.hpp"
 #define MAX(a, b) (a > b ? a : b)
 
 using namespace std;
 
-//the function return 0 if the input is right or -1 it there is something wrong
+namespace
+{
+const double MU[9] = {
+    //1.32712440018e11, //SUN = 0
+    1.32712428e11,
+    22321,     // Gravitational constant of Mercury	= 1
+    324860,    // Gravitational constant of Venus		= 2
+    398601.19, // Gravitational constant of Earth		= 3
+    42828.3,   // Gravitational constant of Mars		= 4
+    126.7e6,   // Gravitational constant of Jupiter	= 5
+    37.9e6,    // Gravitational constant of Saturn		= 6
+    5.78e6,    // Gravitational constant of Uranus		= 7
+    6.8e6      // Gravitational constant of Neptune	= 8
+};
+const double penalty[9] = {
+    0,
+    0,      // Mercury
+    6351.8, // Venus
+    6778.1, // Earth
+    6000,   // Mars
+            //671492, // Jupiter
+    600000, // Jupiter
+    70000,  // Saturn
+    0,      // Uranus
+    0       // Neptune
+};
+
+const double penalty_coeffs[9] = {
+    0,
+    0,     // Mercury
+    0.01,  // Venus
+    0.01,  // Earth
+    0.01,  // Mars
+    0.001, // Jupiter
+    0.01,  // Saturn
+    0,     // Uranus
+    0      // Neptune
+};
+} // namespace
+
+mgaplan compile_mga(const mgaproblem &problem)
+{
+  const int n = problem.sequence.size();
+  if (n < 2 || n > max_sequence_length)
+    throw std::invalid_argument("The fly-by sequence must contain between 2 and `max_sequence_length` bodies.");
+  if (static_cast<int>(problem.rev_flag.size()) < n - 1)
+    throw std::invalid_argument("`rev_flag` must contain a flag for each leg.");
+  if (!problem.ephemerides.empty() && static_cast<int>(problem.ephemerides.size()) != n)
+    throw std::invalid_argument("`ephemerides` must be empty or contain an entry for each body.");
+  if (problem.type != total_DV_orbit_insertion && problem.type != asteroid_impact)
+    throw std::invalid_argument("MGA only supports the types `total_DV_orbit_insertion` and `asteroid_impact`.");
+
+  mgaplan plan;
+  plan.type = problem.type;
+  plan.n = n;
+  plan.asteroid = problem.asteroid;
+  plan.e = problem.e;
+  plan.rp = problem.rp;
+  plan.Isp = problem.Isp;
+  plan.mass = problem.mass;
+  plan.DVlaunch = problem.DVlaunch;
+  plan.fidelity = problem.fidelity;
+
+  for (int i_count = 0; i_count < n; i_count++)
+  {
+    const int body = problem.sequence[i_count];
+    if (body < 10 && (body < 1 || body > 8))
+      throw std::invalid_argument("The fly-by sequence may only contain the planets 1 to 8 or a custom object (10).");
+
+    plan.sequence[i_count] = body;
+    plan.rev_flag[i_count] = i_count < static_cast<int>(problem.rev_flag.size()) ? problem.rev_flag[i_count] : 0;
+    plan.mu[i_count] = body < 10 ? MU[body] : problem.asteroid.mu;
+    plan.penalty[i_count] = body < 10 ? penalty[body] : 0;
+    plan.penalty_coeffs[i_count] = body < 10 ? penalty_coeffs[body] : 0;
+    plan.ephemerides[i_count] = problem.ephemerides.empty() ? nullptr : problem.ephemerides[i_count];
+  }
 
-int MGA(vector<double> t, // it is the vector which provides time in modified julian date 2000.
-                          // The first entry is launch date, the next entries represent the time needed to
-                          // fly from last swing-by to current swing-by.
-        mgaproblem problem,
+  return plan;
+}
 
-        /* OUTPUT values: */
-        vector<double> &rp, // periplanets radius
-        vector<double> &DV, // final delta-Vs
-        double &obj_funct)  //objective function
+namespace
+{
+// Positions r and velocities v of the bodies {0...n-1} at the dates of the
+// decision vector t. All vectors in this file are stored flat, with 3
+// consecutive values per body or leg, so that the legs can be passed to the
+// batch Lambert solver as they are
+template <typename Scalar>
+void mga_ephemerides(const Scalar *t, const mgaplan &problem, Scalar *r, Scalar *v)
+{
+  Scalar T = 0; // total time
+  for (int i_count = 0; i_count < problem.n; i_count++)
+  {
+    T += t[i_count];
+    get_celobj_r_and_v(problem, T, i_count, r + 3 * i_count, v + 3 * i_count);
+  }
+}
 
+// Like mga_ephemerides, but only for the bodies {first_body...n-1}. The dates
+// of the bodies before must be in `dates`; the others are stored there
+void mga_ephemerides(const double *t, const mgaplan &problem, const int first_body,
+                     double *dates, double *r, double *v)
 {
-  const int n = problem.sequence.size();
-  const vector<int> sequence = problem.sequence;
-  const vector<int> rev_flag = problem.rev_flag; // array containing 0 clockwise, 1 un-clockwise
-  customobject cust_obj = problem.asteroid;
-
-  double MU[9] = {
-      //1.32712440018e11, //SUN = 0
-      1.32712428e11,
-      22321,     // Gravitational constant of Mercury	= 1
-      324860,    // Gravitational constant of Venus		= 2
-      398601.19, // Gravitational constant of Earth		= 3
-      42828.3,   // Gravitational constant of Mars		= 4
-      126.7e6,   // Gravitational constant of Jupiter	= 5
-      37.9e6,    // Gravitational constant of Saturn		= 6
-      5.78e6,    // Gravitational constant of Uranus		= 7
-      6.8e6      // Gravitational constant of Neptune	= 8
-  };
-  double penalty[9] = {
-      0,
-      0,      // Mercury
-      6351.8, // Venus
-      6778.1, // Earth
-      6000,   // Mars
-              //671492, // Jupiter
-      600000, // Jupiter
-      70000,  // Saturn
-      0,      // Uranus
-      0       // Neptune
-  };
-
-  double penalty_coeffs[9] = {
-      0,
-      0,     // Mercury
-      0.01,  // Venus
-      0.01,  // Earth
-      0.01,  // Mars
-      0.001, // Jupiter
-      0.01,  // Saturn
-      0,     // Uranus
-      0      // Neptune
-  };
-
-  double DVtot = 0;
-  double Dum_Vec[3], Vin, Vout;
-  double V_Lamb[2][2][3], dot_prod;
-  double a, p, theta, alfa;
-  double DVrel, DVarr = 0;
+  double T = first_body > 0 ? dates[first_body - 1] : 0; // total time
+  for (int i_count = first_body; i_count < problem.n; i_count++)
+  {
+    T += t[i_count];
+    dates[i_count] = T;
+    get_celobj_r_and_v(problem, T, i_count, r + 3 * i_count, v + 3 * i_count);
+  }
+}
 
-  //only used for orbit insertion (ex: cassini)
-  double DVper, DVper2;
-  const double rp_target = problem.rp;
-  const double e_target = problem.e;
-  const double DVlaunch = problem.DVlaunch;
+// Time of flight and direction of the Lambert arcs of the legs {0...n-2}
+template <typename Scalar>
+void mga_legs(const Scalar *t, const mgaplan &problem, const Scalar *r, Scalar *tof, bool *long_way)
+{
+  Scalar Dum_Vec[3];
+  int lw;
 
-  //only used for asteroid impact (ex: gtoc1)
-  const double initial_mass = problem.mass; // Satellite initial mass [Kg]
-  double final_mass;                        // satelite final mass
-  const double Isp = problem.Isp;           // Satellite specific impulse [s]
-  const double g = 9.80665 / 1000.0;        // Gravity
+  for (int i_count = 0; i_count < problem.n - 1; i_count++)
+  {
+    vett(r + 3 * i_count, r + 3 * (i_count + 1), Dum_Vec);
 
-  double *vec, *rec;
-  vector<double *> r; // {0...n-1} position
-  vector<double *> v; // {0...n-1} velocity
+    if (Dum_Vec[2] > 0)
+      lw = (problem.rev_flag[i_count] == 0) ? 0 : 1;
+    else
+      lw = (problem.rev_flag[i_count] == 0) ? 1 : 0;
 
-  double T = 0.0; // total time
+    tof[i_count] = t[i_count + 1] * 24 * 60 * 60;
+    long_way[i_count] = lw;
+  }
+}
 
-  int i_count, j_count, lw;
+// Solves `count` independent Lambert arcs with the fidelity of the plan
+void mga_solve_lambert(const mgaplan &problem, const double *r_departure, const double *r_arrival,
+                       const double *tof, const bool *long_way, const int count,
+                       double *v_departure, double *v_arrival, pass::lambert_error *errors)
+{
+  if (problem.fidelity == pass::fidelity::low)
+    pass::solve_lambert<pass::low_fidelity>(r_departure, r_arrival, tof, long_way, MU[0], count,
+                                            v_departure, v_arrival, errors);
+  else
+    pass::solve_lambert(r_departure, r_arrival, tof, long_way, MU[0], count,
+                        v_departure, v_arrival, errors);
+}
 
-  int iter = 0;
+// Solves a single Lambert arc in dual numbers with the fidelity of the plan
+pass::lambert_error mga_solve_lambert(const mgaplan &problem, const pass::gradient_dual *r_departure,
+                                      const pass::gradient_dual *r_arrival, const pass::gradient_dual tof,
+                                      const bool long_way, pass::gradient_dual *v_departure,
+                                      pass::gradient_dual *v_arrival)
+{
+  if (problem.fidelity == pass::fidelity::low)
+    return pass::solve_lambert<pass::low_fidelity>(r_departure, r_arrival, tof, MU[0], long_way,
+                                                   v_departure, v_arrival);
+  return pass::solve_lambert<pass::high_fidelity>(r_departure, r_arrival, tof, MU[0], long_way,
+                                                  v_departure, v_arrival);
+}
 
-  if (n >= 2)
-  {
-    for (i_count = 0; i_count < n; i_count++)
-    {
-      vec = new double[3]; // velocity and position are 3 D vector
-      rec = new double[3];
-      r.push_back(vec);
-      v.push_back(rec);
+// Solves the Lambert arc of the first leg of the decision vector t, with the
+// porkchop table, if the plan has one
+pass::lambert_error mga_lambert_first_leg(const double *t, const mgaplan &problem, const double *r,
+                                          const double *tof, const bool *long_way,
+                                          double *v_departure, double *v_arrival)
+{
+  if (problem.first_leg)
+    return problem.first_leg->solve(t[0], t[1], r, r + 3, long_way[0], v_departure, v_arrival);
 
-      DV[i_count] = 0.0;
-    }
+  pass::lambert_error error;
+  mga_solve_lambert(problem, r, r + 3, tof, long_way, 1, v_departure, v_arrival, &error);
+  return error;
+}
 
-    T = 0;
-    for (i_count = 0; i_count < n; i_count++)
-    {
-      T += t[i_count];
-      if (sequence[i_count] < 10)
-        Planet_Ephemerides_Analytical(T, sequence[i_count],
-                                      r[i_count], v[i_count]); //r and  v in heliocentric coordinate system
-      else
-      {
-        Custom_Eph(T + 2451544.5, cust_obj.epoch, cust_obj.keplerian, r[i_count], v[i_count]);
-      }
-    }
+// Solves the Lambert arcs of all legs of the decision vector t. The first leg
+// uses the porkchop table, if the plan has one
+void mga_lambert(const double *t, const mgaplan &problem, const double *r,
+                 const double *tof, const bool *long_way,
+                 double *v_departure, double *v_arrival, pass::lambert_error *errors)
+{
+  const int legs = problem.n - 1;
 
-    vett(r[0], r[1], Dum_Vec);
+  if (!problem.first_leg)
+  {
+    // All legs only depend on the ephemerides, so they are solved together
+    mga_solve_lambert(problem, r, r + 3, tof, long_way, legs, // INPUT
+                      v_departure, v_arrival, errors);        // OUTPUT
+    return;
+  }
 
-    if (Dum_Vec[2] > 0)
-      lw = (rev_flag[0] == 0) ? 0 : 1;
-    else
-      lw = (rev_flag[0] == 0) ? 1 : 0;
+  errors[0] = problem.first_leg->solve(t[0], t[1], r, r + 3, long_way[0], v_departure, v_arrival);
+  mga_solve_lambert(problem, r + 3, r + 6, tof + 1, long_way + 1, legs - 1,
+                    v_departure + 3, v_arrival + 3, errors + 1);
+}
 
-    LambertI(r[0], r[1], t[1] * 24 * 60 * 60, MU[0], lw,     // INPUT
-             V_Lamb[0][0], V_Lamb[0][1], a, p, theta, iter); // OUTPUT
-    DV[0] = norm(V_Lamb[0][0], v[0]);                        // Earth launch
+// Evaluates the fly-by at the body i_count, between the legs i_count - 1 and
+// i_count. Writes its delta V into DV[i_count] and its pericenter radius into
+// rp[i_count - 1]
+template <typename Scalar>
+void mga_swing_by(const mgaplan &problem, const Scalar *v,
+                  const Scalar *v_departure, const Scalar *v_arrival,
+                  const int i_count, Scalar *rp, Scalar *DV)
+{
+  Scalar Vin, Vout;
+  Scalar dot_prod;
+  Scalar alfa;
 
-    for (i_count = 1; i_count <= n - 2; i_count++)
-    {
-      vett(r[i_count], r[i_count + 1], Dum_Vec);
-
-      if (Dum_Vec[2] > 0)
-        lw = (rev_flag[i_count] == 0) ? 0 : 1;
-      else
-        lw = (rev_flag[i_count] == 0) ? 1 : 0;
-
-      /*if (i_count%2 != 0)	{*/
-      LambertI(r[i_count], r[i_count + 1], t[i_count + 1] * 24 * 60 * 60, MU[0], lw, // INPUT
-               V_Lamb[1][0], V_Lamb[1][1], a, p, theta, iter);                       // OUTPUT
-
-      // norm first perform the subtraction of vet1-vet2 and the evaluate ||...||
-      Vin = norm(V_Lamb[0][1], v[i_count]);
-      Vout = norm(V_Lamb[1][0], v[i_count]);
-
-      dot_prod = 0.0;
-      for (int i = 0; i < 3; i++)
-      {
-        dot_prod += (V_Lamb[0][1][i] - v[i_count][i]) * (V_Lamb[1][0][i] - v[i_count][i]);
-      }
-      alfa = acos(dot_prod / (Vin * Vout));
-
-      // calculation of delta V at pericenter
-      pass::pow_swing_by_inv(Vin, Vout, alfa, DV[i_count], rp[i_count - 1]);
-
-      rp[i_count - 1] *= MU[sequence[i_count]];
-
-      if (i_count != n - 2) //swap
-        for (j_count = 0; j_count < 3; j_count++)
-        {
-          V_Lamb[0][0][j_count] = V_Lamb[1][0][j_count]; // [j_count];
-          V_Lamb[0][1][j_count] = V_Lamb[1][1][j_count]; // [j_count];
-        }
-    }
-  }
-  else
+  // arrival of the previous leg and departure of the next one
+  const Scalar *v_in = v_arrival + 3 * (i_count - 1);
+  const Scalar *v_out = v_departure + 3 * i_count;
+  const Scalar *v_body = v + 3 * i_count;
+
+  // norm first perform the subtraction of vet1-vet2 and the evaluate ||...||
+  Vin = norm(v_in, v_body);
+  Vout = norm(v_out, v_body);
+
+  dot_prod = 0.0;
+  for (int i = 0; i < 3; i++)
   {
-    return -1;
+    dot_prod += (v_in[i] - v_body[i]) * (v_out[i] - v_body[i]);
   }
+  alfa = acos(dot_prod / (Vin * Vout));
+
+  // calculation of delta V at pericenter
+  if (problem.fidelity == pass::fidelity::low)
+    pass::pow_swing_by_inv<pass::low_fidelity>(Vin, Vout, alfa, DV[i_count], rp[i_count - 1]);
+  else
+    pass::pow_swing_by_inv<pass::high_fidelity>(Vin, Vout, alfa, DV[i_count], rp[i_count - 1]);
+
+  rp[i_count - 1] *= problem.mu[i_count];
+}
+
+// Evaluates the objective function, given the solved Lambert arcs of all legs
+// and the evaluated fly-bys
+template <typename Scalar>
+int mga_total(const mgaplan &problem, const Scalar *v,
+              const Scalar *v_departure, const Scalar *v_arrival,
+              const Scalar *rp, Scalar *DV, Scalar &obj_funct)
+{
+  const int n = problem.n;
+  const double *mu = problem.mu;
+
+  Scalar DVtot = 0;
+  Scalar Dum_Vec[3];
+  Scalar dot_prod;
+  Scalar DVrel, DVarr = 0;
+
+  //only used for orbit insertion (ex: cassini)
+  Scalar DVper, DVper2;
+  const double rp_target = problem.rp;
+  const double e_target = problem.e;
+  const double DVlaunch = problem.DVlaunch;
+
+  //only used for asteroid impact (ex: gtoc1)
+  const double initial_mass = problem.mass; // Satellite initial mass [Kg]
+  Scalar final_mass;                        // satelite final mass
+  const double Isp = problem.Isp;           // Satellite specific impulse [s]
+  const double g = 9.80665 / 1000.0;        // Gravity
+
+  int i_count;
+
+  DV[0] = norm(v_departure, v); // Earth launch
+  DV[n - 1] = 0.0;
 
   for (i_count = 0; i_count < 3; i_count++)
-    Dum_Vec[i_count] = v[n - 1][i_count] - V_Lamb[1][1][i_count];
+    Dum_Vec[i_count] = v[3 * (n - 1) + i_count] - v_arrival[3 * (n - 2) + i_count];
 
   DVrel = norm2(Dum_Vec);
 
   if (problem.type == total_DV_orbit_insertion)
   {
-    DVper = sqrt(DVrel * DVrel + 2 * MU[sequence[n - 1]] / rp_target);
-    DVper2 = sqrt(2 * MU[sequence[n - 1]] / rp_target - MU[sequence[n - 1]] / rp_target * (1 - e_target));
+    DVper = sqrt(DVrel * DVrel + 2 * mu[n - 1] / rp_target);
+    DVper2 = sqrt(2 * mu[n - 1] / rp_target - mu[n - 1] / rp_target * (1 - e_target));
     DVarr = fabs(DVper - DVper2);
   }
 
@@ -209,8 +313,8 @@ int MGA(vector<double> t, // it is the vector which provides time in modified ju
 
   // Build Penalty
   for (i_count = 0; i_count < n - 2; i_count++)
-    if (rp[i_count] < penalty[sequence[i_count + 1]])
-      DVtot += penalty_coeffs[sequence[i_count + 1]] * fabs(rp[i_count] - penalty[sequence[i_count + 1]]);
+    if (rp[i_count] < problem.penalty[i_count + 1])
+      DVtot += problem.penalty_coeffs[i_count + 1] * fabs(rp[i_count] - problem.penalty[i_count + 1]);
 
   // Launcher Constraint
   if (DV[0] > DVlaunch)
@@ -227,22 +331,278 @@ int MGA(vector<double> t, // it is the vector which provides time in modified ju
 
     // V asteroid - V satellite
     for (i_count = 0; i_count < 3; i_count++)
-      Dum_Vec[i_count] = v[n - 1][i_count] - V_Lamb[1][1][i_count]; // arrival relative velocity at the asteroid;
+      Dum_Vec[i_count] = v[3 * (n - 1) + i_count] - v_arrival[3 * (n - 2) + i_count]; // arrival relative velocity at the asteroid;
 
     dot_prod = 0;
     for (i_count = 0; i_count < 3; i_count++)
-      dot_prod += Dum_Vec[i_count] * v[n - 1][i_count];
+      dot_prod += Dum_Vec[i_count] * v[3 * (n - 1) + i_count];
 
     obj_funct = -(final_mass)*fabs(dot_prod);
   }
 
-  // final clean
-  for (i_count = 0; i_count < n; i_count++)
+  return 0;
+}
+
+// Evaluates the fly-bys and the objective function, given the solved Lambert
+// arcs of all legs
+template <typename Scalar>
+int mga_objective(const mgaplan &problem, const Scalar *v,
+                  const Scalar *v_departure, const Scalar *v_arrival,
+                  const pass::lambert_error *errors,
+                  Scalar *rp, Scalar *DV, Scalar &obj_funct)
+{
+  const int n = problem.n;
+
+  for (int i_count = 0; i_count < n - 1; i_count++)
   {
-    delete[] r[i_count];
-    delete[] v[i_count];
+    if (errors[i_count] != pass::lambert_error::none)
+    {
+      obj_funct = std::numeric_limits<double>::infinity();
+      return -1;
+    }
   }
-  r.clear();
-  v.clear();
-  return 0;
+
+  for (int i_count = 1; i_count <= n - 2; i_count++)
+    mga_swing_by(problem, v, v_departure, v_arrival, i_count, rp, DV);
+
+  return mga_total(problem, v, v_departure, v_arrival, rp, DV, obj_funct);
+}
+} // namespace
+
+void get_celobj_r_and_v(const mgaplan &problem, const double T, const int i_count, double *r, double *v)
+{
+  if (problem.ephemerides[i_count])
+    problem.ephemerides[i_count]->evaluate(T, r, v);
+  else if (problem.sequence[i_count] < 10)
+    Planet_Ephemerides_Analytical(T, problem.sequence[i_count],
+                                  r, v); //r and  v in heliocentric coordinate system
+  else
+  {
+    Custom_Eph(T + 2451544.5, problem.asteroid.epoch, problem.asteroid.keplerian, r, v);
+  }
+}
+
+void get_celobj_r_and_v(const mgaplan &problem, const pass::gradient_dual T, const int i_count,
+                        pass::gradient_dual *r, pass::gradient_dual *v)
+{
+  if (problem.sequence[i_count] < 10)
+    Planet_Ephemerides_Analytical(T, problem.sequence[i_count], r, v);
+  else
+    Custom_Eph(T + 2451544.5, problem.asteroid.epoch, problem.asteroid.keplerian, r, v);
+}
+
+//the function return 0 if the input is right or -1 it there is something wrong
+
+int MGA(const double *t, // it is the vector which provides time in modified julian date 2000.
+                         // The first entry is launch date, the next entries represent the time needed to
+                         // fly from last swing-by to current swing-by.
+        const mgaplan &problem,
+
+        /* OUTPUT values: */
+        double *rp,        // periplanets radius
+        double *DV,        // final delta-Vs
+        double &obj_funct) //objective function
+
+{
+  const int n = problem.n;
+
+  if (n < 2 || n > max_sequence_length)
+  {
+    return -1;
+  }
+
+  // {0...n-1} position and velocity, so that r and r + 3 are the departure and
+  // arrival positions of all legs
+  double r[3 * max_sequence_length];
+  double v[3 * max_sequence_length];
+
+  // Lambert arcs of the legs {0...n-2}; departure and arrival velocities
+  double tof[max_sequence_length - 1];
+  bool long_way[max_sequence_length - 1];
+  double v_departure[3 * (max_sequence_length - 1)], v_arrival[3 * (max_sequence_length - 1)];
+  pass::lambert_error errors[max_sequence_length - 1];
+
+  mga_ephemerides(t, problem, r, v);
+  mga_legs(t, problem, r, tof, long_way);
+
+  mga_lambert(t, problem, r, tof, long_way, v_departure, v_arrival, errors);
+
+  return mga_objective(problem, v, v_departure, v_arrival, errors, rp, DV, obj_funct);
+}
+
+int MGA(const double *t, const mgaplan &problem, const double cutoff, double &obj_funct)
+{
+  const int n = problem.n;
+
+  double rp[max_sequence_length];
+  double DV[max_sequence_length];
+
+  // Only the delta Vs of total_DV_orbit_insertion add up to the objective function
+  if (problem.type != total_DV_orbit_insertion || n < 2 || n > max_sequence_length)
+  {
+    return MGA(t, problem, rp, DV, obj_funct);
+  }
+
+  double r[3 * max_sequence_length];
+  double v[3 * max_sequence_length];
+
+  double tof[max_sequence_length - 1];
+  bool long_way[max_sequence_length - 1];
+  double v_departure[3 * (max_sequence_length - 1)], v_arrival[3 * (max_sequence_length - 1)];
+
+  mga_ephemerides(t, problem, r, v);
+  mga_legs(t, problem, r, tof, long_way);
+
+  pass::lambert_error errors[max_sequence_length - 1];
+
+  // The first leg decides the launcher constraint, a lower bound of the
+  // objective function
+  errors[0] = mga_lambert_first_leg(t, problem, r, tof, long_way, v_departure, v_arrival);
+  if (errors[0] != pass::lambert_error::none)
+  {
+    obj_funct = std::numeric_limits<double>::infinity();
+    return -1;
+  }
+
+  double lower_bound = 0;
+  const double DVdeparture = norm(v_departure, v);
+  if (DVdeparture > problem.DVlaunch)
+    lower_bound += DVdeparture - problem.DVlaunch;
+
+  if (lower_bound > cutoff)
+  {
+    obj_funct = lower_bound;
+    return 1;
+  }
+
+  // The remaining legs are solved together, which is faster than alternating
+  // them with the fly-bys
+  mga_solve_lambert(problem, r + 3, r + 6, tof + 1, long_way + 1, n - 2, // INPUT
+                    v_departure + 3, v_arrival + 3, errors + 1);      // OUTPUT
+
+  for (int i_count = 1; i_count < n - 1; i_count++)
+  {
+    if (errors[i_count] != pass::lambert_error::none)
+    {
+      obj_funct = std::numeric_limits<double>::infinity();
+      return -1;
+    }
+  }
+
+  // The fly-bys and their penalties add up to the lower bound
+  for (int i_count = 1; i_count < n - 1; i_count++)
+  {
+    mga_swing_by(problem, v, v_departure, v_arrival, i_count, rp, DV);
+
+    lower_bound += DV[i_count];
+    if (rp[i_count - 1] < problem.penalty[i_count])
+      lower_bound += problem.penalty_coeffs[i_count] * fabs(rp[i_count - 1] - problem.penalty[i_count]);
+
+    if (lower_bound > cutoff)
+    {
+      obj_funct = lower_bound;
+      return 1;
+    }
+  }
+
+  return mga_total(problem, v, v_departure, v_arrival, rp, DV, obj_funct);
+}
+
+int MGA(const double *t, const mgaplan &problem, mgastate &state, double &obj_funct)
+{
+  const int n = problem.n;
+
+  if (n < 2 || n > max_sequence_length)
+  {
+    return -1;
+  }
+
+  // Changing t[k] moves the bodies {k...n-1}, and so changes the legs
+  // {k-1...n-2} and the fly-bys at the bodies {k-1...n-2}
+  int first_body = 0;
+  if (state.plan == &problem && state.fidelity == problem.fidelity && state.first_leg == problem.first_leg.get())
+  {
+    while (first_body < n && t[first_body] == state.t[first_body])
+      first_body++;
+  }
+  else
+  {
+    state.plan = &problem;
+    state.fidelity = problem.fidelity;
+    state.first_leg = problem.first_leg.get();
+    state.fly_bys = 0;
+  }
+
+  for (int i_count = first_body; i_count < n; i_count++)
+    state.t[i_count] = t[i_count];
+
+  const int first_leg = std::max(first_body - 1, 0);
+  const int first_fly_by = std::min(std::max(first_leg, 1), state.fly_bys + 1);
+
+  double tof[max_sequence_length - 1];
+  bool long_way[max_sequence_length - 1];
+
+  mga_ephemerides(t, problem, first_body, state.dates, state.r, state.v);
+  mga_legs(t, problem, state.r, tof, long_way);
+
+  int first_batch_leg = first_leg;
+  if (first_leg == 0 && n > 1)
+  {
+    state.errors[0] = mga_lambert_first_leg(t, problem, state.r, tof, long_way,
+                                            state.v_departure, state.v_arrival);
+    first_batch_leg = 1;
+  }
+
+  mga_solve_lambert(problem, state.r + 3 * first_batch_leg, state.r + 3 * (first_batch_leg + 1),
+                    tof + first_batch_leg, long_way + first_batch_leg, n - 1 - first_batch_leg,   // INPUT
+                    state.v_departure + 3 * first_batch_leg, state.v_arrival + 3 * first_batch_leg, // OUTPUT
+                    state.errors + first_batch_leg);
+
+  for (int i_count = 0; i_count < n - 1; i_count++)
+  {
+    if (state.errors[i_count] != pass::lambert_error::none)
+    {
+      state.fly_bys = first_fly_by - 1;
+      obj_funct = std::numeric_limits<double>::infinity();
+      return -1;
+    }
+  }
+
+  for (int i_count = first_fly_by; i_count <= n - 2; i_count++)
+    mga_swing_by(problem, state.v, state.v_departure, state.v_arrival, i_count, state.rp, state.DV);
+  state.fly_bys = n - 2;
+
+  return mga_total(problem, state.v, state.v_departure, state.v_arrival, state.rp, state.DV, obj_funct);
+}
+
+int MGA(const pass::gradient_dual *t, const mgaplan &problem, pass::gradient_dual &obj_funct)
+{
+  const int n = problem.n;
+
+  if (n < 2 || n > max_sequence_length)
+  {
+    return -1;
+  }
+
+  pass::gradient_dual r[3 * max_sequence_length];
+  pass::gradient_dual v[3 * max_sequence_length];
+
+  pass::gradient_dual tof[max_sequence_length - 1];
+  bool long_way[max_sequence_length - 1];
+  pass::gradient_dual v_departure[3 * (max_sequence_length - 1)], v_arrival[3 * (max_sequence_length - 1)];
+  pass::lambert_error errors[max_sequence_length - 1];
+
+  pass::gradient_dual rp[max_sequence_length];
+  pass::gradient_dual DV[max_sequence_length];
+
+  mga_ephemerides(t, problem, r, v);
+  mga_legs(t, problem, r, tof, long_way);
+
+  for (int i_count = 0; i_count < n - 1; i_count++)
+  {
+    errors[i_count] = mga_solve_lambert(problem, r + 3 * i_count, r + 3 * (i_count + 1), tof[i_count],
+                                        long_way[i_count], v_departure + 3 * i_count, v_arrival + 3 * i_count);
+  }
+
+  return mga_objective(problem, v, v_departure, v_arrival, errors, rp, DV, obj_funct);
 }
@@ -10,9 +10,14 @@
 
 #include "pass_bits/helper/astro_problems/astro_functions.hpp"
 #include "pass_bits/helper/astro_problems/lambert.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
 #include "pass_bits/helper/astro_problems/mga_dsm.hpp"
 #include "pass_bits/helper/astro_problems/pl_eph_an.hpp"
 #include "pass_bits/helper/astro_problems/propagate_kep.hpp"
+#include "pass_bits/helper/astro_problems/propagate_universal.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 const double MU[9] = {
     1.32712428e11,      // SUN                                  = 0
@@ -36,9 +41,10 @@ const double RPL[6] = {
     60330  // Saturn
 };
 
-void vector_normalize(const double in[3], double out[3])
+template <typename Scalar>
+void vector_normalize(const Scalar in[3], Scalar out[3])
 {
-  double norm = norm2(in);
+  Scalar norm = norm2(in);
   for (int i = 0; i < 3; i++)
   {
     out[i] = in[i] / norm;
@@ -54,9 +60,13 @@ void vector_normalize(const double in[3], double out[3])
  * r       - [output] object's position
  * v       - [output] object's velocity
  */
-void get_celobj_r_and_v(const mgadsmproblem &problem, const double T, const int i_count, double *r, double *v)
+void get_celobj_r_and_v(const mgadsmplan &problem, const double T, const int i_count, double *r, double *v)
 {
-  if (problem.sequence[i_count] < 10)
+  if (problem.ephemerides[i_count])
+  { //precomputed
+    problem.ephemerides[i_count]->evaluate(T, r, v);
+  }
+  else if (problem.sequence[i_count] < 10)
   { //normal planet
     Planet_Ephemerides_Analytical(T, problem.sequence[i_count],
                                   r, v); // r and  v in heliocentric coordinate system
@@ -69,19 +79,42 @@ void get_celobj_r_and_v(const mgadsmproblem &problem, const double T, const int
 }
 
 /**
- * Precomputes all velocities and positions of celestial objects of interest for the problem.
- * Before calling this function, r and v verctors must be pre-allocated with sufficient amount of entries.
+ * Like above, in dual numbers. Always evaluates the analytical ephemerides, as
+ * the precomputed ones aren't differentiated.
+ */
+void get_celobj_r_and_v(const mgadsmplan &problem, const pass::gradient_dual T, const int i_count,
+                        pass::gradient_dual *r, pass::gradient_dual *v)
+{
+  if (problem.sequence[i_count] < 10)
+  {
+    Planet_Ephemerides_Analytical(T, problem.sequence[i_count], r, v);
+  }
+  else
+  {
+    Custom_Eph(T + 2451544.5, problem.asteroid.epoch, problem.asteroid.keplerian, r, v);
+  }
+}
+
+/**
+ * Precomputes the velocities and positions of the celestial objects of interest
+ * from `first_body` on. r, v and dates must provide an entry for each body of
+ * the sequence.
  *
- * problem - concerned problem
- * r       - [output] array of position vectors
- * v       - [output] array of velocity vectors
+ * problem    - concerned problem
+ * first_body - first body to compute; the dates of the bodies before must be set
+ * dates      - [output] array of dates (MJD2000)
+ * r          - [output] array of position vectors
+ * v          - [output] array of velocity vectors
  */
-void precalculate_ers_and_vees(const std::vector<double> &t, const mgadsmproblem &problem, std::vector<double *> &r, std::vector<double *> &v)
+template <typename Scalar>
+void precalculate_ers_and_vees(const Scalar *t, const mgadsmplan &problem, const int first_body,
+                               Scalar *dates, Scalar (*r)[3], Scalar (*v)[3])
 {
-  double T = t[0]; //time of departure
+  Scalar T = first_body > 0 ? dates[first_body - 1] + t[3 + first_body] : t[0]; //time of departure
 
-  for (unsigned int i_count = 0; i_count < problem.sequence.size(); i_count++)
+  for (int i_count = first_body; i_count < problem.n; i_count++)
   {
+    dates[i_count] = T;
     get_celobj_r_and_v(problem, T, i_count, r[i_count], v[i_count]);
     T += t[4 + i_count]; //time of flight
   }
@@ -93,15 +126,66 @@ void precalculate_ers_and_vees(const std::vector<double> &t, const mgadsmproblem
  * problem - concerned problem
  * i_count - hop number (starting from 0)
  */
-double get_celobj_mu(const mgadsmproblem &problem, const int i_count)
+double get_celobj_mu(const mgadsmplan &problem, const int i_count)
 {
-  if (problem.sequence[i_count] < 10)
-  { //normal planet
-    return MU[problem.sequence[i_count]];
+  return problem.mu[i_count]; // resolved by compile_mga_dsm
+}
+
+/**
+ * The propagator of the arcs up to the DSMs. The low fidelity always uses the
+ * universal variables, which skip the conversions to and from the orbital
+ * elements.
+ */
+pass::kepler_propagator dsm_propagator(const mgadsmplan &problem)
+{
+  return problem.fidelity == pass::fidelity::low ? pass::kepler_propagator::universal_variables
+                                                 : problem.propagator;
+}
+
+/**
+ * Solves the Lambert arc from a DSM to the next body with the fidelity of the
+ * problem. Like `LambertI`, the velocities are NaN if there is no solution.
+ */
+void dsm_lambert(const mgadsmplan &problem, const double *r1, const double *r2, const double t, const int lw,
+                 double *v1, double *v2)
+{
+  if (problem.fidelity == pass::fidelity::high)
+  {
+    double a, p, theta;
+    int iter_unused; // [MR] unused variable
+    LambertI(r1, r2, t, MU[0], lw, v1, v2, a, p, theta, iter_unused);
+    return;
   }
-  else
-  { //asteroid
-    return problem.asteroid.mu;
+
+  if (pass::solve_lambert<pass::low_fidelity>(r1, r2, t, MU[0], lw != 0, v1, v2) != pass::lambert_error::none)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      v1[i] = std::numeric_limits<double>::quiet_NaN();
+      v2[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+}
+
+/**
+ * Like above, in dual numbers. `LambertI` delegates to
+ * `pass::solve_lambert`, so this solves the same problem.
+ */
+void dsm_lambert(const mgadsmplan &problem, const pass::gradient_dual *r1, const pass::gradient_dual *r2,
+                 const pass::gradient_dual t, const int lw, pass::gradient_dual *v1, pass::gradient_dual *v2)
+{
+  const pass::lambert_error error =
+      problem.fidelity == pass::fidelity::high
+          ? pass::solve_lambert<pass::high_fidelity>(r1, r2, t, MU[0], lw != 0, v1, v2)
+          : pass::solve_lambert<pass::low_fidelity>(r1, r2, t, MU[0], lw != 0, v1, v2);
+
+  if (error != pass::lambert_error::none)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      v1[i] = std::numeric_limits<double>::quiet_NaN();
+      v2[i] = std::numeric_limits<double>::quiet_NaN();
+    }
   }
 }
 
@@ -114,42 +198,43 @@ double get_celobj_mu(const mgadsmproblem &problem, const int i_count)
  * DV         - [output] velocity contributions table
  * v_sc_pl_in - [output] next hop input speed
  */
-void first_block(const std::vector<double> &t, const mgadsmproblem &problem, const std::vector<double *> &r, std::vector<double *> &v, std::vector<double> &DV, double v_sc_nextpl_in[3])
+template <typename Scalar>
+void first_block(const Scalar *t, const mgadsmplan &problem, const Scalar (*r)[3], const Scalar (*v)[3], Scalar *DV, Scalar v_sc_nextpl_in[3])
 {
   //First, some helper constants to make code more readable
-  const int n = problem.sequence.size();
-  const double VINF = t[1]; // Hyperbolic escape velocity (km/sec)
-  const double udir = t[2]; // Hyperbolic escape velocity var1 (non dim)
-  const double vdir = t[3]; // Hyperbolic escape velocity var2 (non dim)
+  const int n = problem.n;
+  const Scalar VINF = t[1]; // Hyperbolic escape velocity (km/sec)
+  const Scalar udir = t[2]; // Hyperbolic escape velocity var1 (non dim)
+  const Scalar vdir = t[3]; // Hyperbolic escape velocity var2 (non dim)
   // [MR] {LITTLE HACKER TRICK} Instead of copying (!) arrays let's just introduce pointers to appropriate positions in the decision vector.
-  const double *tof = &t[4];
-  const double *alpha = &t[n + 3];
+  const Scalar *tof = &t[4];
+  const Scalar *alpha = &t[n + 3];
 
   int i; //loop counter
 
   // Spacecraft position and velocity at departure
-  double vtemp[3];
+  Scalar vtemp[3];
   cross(r[0], v[0], vtemp);
 
-  double zP1[3];
+  Scalar zP1[3];
   vector_normalize(vtemp, zP1);
 
-  double iP1[3];
+  Scalar iP1[3];
   vector_normalize(v[0], iP1);
 
-  double jP1[3];
+  Scalar jP1[3];
   cross(zP1, iP1, jP1);
 
-  double theta, phi;
+  Scalar theta, phi;
   theta = 2 * M_PI * udir;             // See Picking a Point on a Sphere
   phi = acos(2 * vdir - 1) - M_PI / 2; // In this way: -pi/2<phi<pi/2 so phi can be used as out-of-plane rotation
 
-  double vinf[3];
+  Scalar vinf[3];
   for (i = 0; i < 3; i++)
     vinf[i] = VINF * (cos(theta) * cos(phi) * iP1[i] + sin(theta) * cos(phi) * jP1[i] + sin(phi) * zP1[i]);
 
   //double v_sc_pl_in[3];  // Spacecraft absolute incoming velocity at P1 [MR] not needed?
-  double v_sc_pl_out[3]; // Spacecraft absolute outgoing velocity at P1
+  Scalar v_sc_pl_out[3]; // Spacecraft absolute outgoing velocity at P1
 
   for (i = 0; i < 3; i++)
   {
@@ -158,23 +243,21 @@ void first_block(const std::vector<double> &t, const mgadsmproblem &problem, con
   }
 
   // Computing S/C position and absolute incoming velocity at DSM1
-  double rd[3], v_sc_dsm_in[3];
+  Scalar rd[3], v_sc_dsm_in[3];
 
-  propagateKEP(r[0], v_sc_pl_out, alpha[0] * tof[0] * 86400, MU[0],
-               rd, v_sc_dsm_in); // [MR] last two are output.
+  pass::propagate_kepler(dsm_propagator(problem), r[0], v_sc_pl_out, alpha[0] * tof[0] * 86400, MU[0],
+                         rd, v_sc_dsm_in); // [MR] last two are output.
 
   // Evaluating the Lambert arc from DSM1 to P2
-  double Dum_Vec[3]; // [MR] Rename it to something sensible...
+  Scalar Dum_Vec[3]; // [MR] Rename it to something sensible...
   vett(rd, r[1], Dum_Vec);
 
   int lw = (Dum_Vec[2] > 0) ? 0 : 1;
-  double a, p, theta2;
-  int iter_unused; // [MR] unused variable
 
-  double v_sc_dsm_out[3]; // DSM output speed
+  Scalar v_sc_dsm_out[3]; // DSM output speed
 
-  LambertI(rd, r[1], tof[0] * (1 - alpha[0]) * 86400, MU[0], lw,
-           v_sc_dsm_out, v_sc_nextpl_in, a, p, theta2, iter_unused); // [MR] last 6 are output
+  dsm_lambert(problem, rd, r[1], tof[0] * (1 - alpha[0]) * 86400, lw,
+              v_sc_dsm_out, v_sc_nextpl_in); // [MR] last 2 are output
 
   // First Contribution to DV (the 1st deep space maneuver)
   for (i = 0; i < 3; i++)
@@ -188,22 +271,22 @@ void first_block(const std::vector<double> &t, const mgadsmproblem &problem, con
 // ------
 // INTERMEDIATE BLOCK
 // WARNING: i_count starts from 0
-void intermediate_block(const std::vector<double> &t, const mgadsmproblem &problem, const std::vector<double *> &r, const std::vector<double *> &v, int i_count, const double v_sc_pl_in[], std::vector<double> &DV, double *v_sc_nextpl_in)
+template <typename Scalar>
+void intermediate_block(const Scalar *t, const mgadsmplan &problem, const Scalar (*r)[3], const Scalar (*v)[3], int i_count, const Scalar v_sc_pl_in[], Scalar *DV, Scalar *v_sc_nextpl_in)
 {
   //[MR] A bunch of helper variables to simplify the code
-  const int n = problem.sequence.size();
+  const int n = problem.n;
   // [MR] {LITTLE HACKER TRICK} Instead of copying (!) arrays let's just introduce pointers to appropriate positions in the decision vector.
-  const double *tof = &t[4];
-  const double *alpha = &t[n + 3];
-  const double *rp_non_dim = &t[2 * n + 2]; // non-dim perigee fly-by radius of planets P2..Pn(-1) (i=1 refers to the second planet)
-  const double *gamma = &t[3 * n];          // rotation of the bplane-component of the swingby outgoing
-  const std::vector<int> &sequence = problem.sequence;
+  const Scalar *tof = &t[4];
+  const Scalar *alpha = &t[n + 3];
+  const Scalar *rp_non_dim = &t[2 * n + 2]; // non-dim perigee fly-by radius of planets P2..Pn(-1) (i=1 refers to the second planet)
+  const Scalar *gamma = &t[3 * n];          // rotation of the bplane-component of the swingby outgoing
 
   int i; //loop counter
 
   // Evaluation of the state immediately after Pi
-  double v_rel_in[3];
-  double vrelin = 0.0;
+  Scalar v_rel_in[3];
+  Scalar vrelin = 0.0;
 
   for (i = 0; i < 3; i++)
   {
@@ -214,52 +297,50 @@ void intermediate_block(const std::vector<double> &t, const mgadsmproblem &probl
   // Hop object's gravitional constant
   double hopobj_mu = get_celobj_mu(problem, i_count + 1);
 
-  double e = 1.0 + rp_non_dim[i_count] * RPL[sequence[i_count + 1] - 1] * vrelin / hopobj_mu;
+  Scalar e = 1.0 + rp_non_dim[i_count] * problem.radius[i_count + 1] * vrelin / hopobj_mu;
 
-  double beta_rot = 2 * asin(1 / e); // velocity rotation
+  Scalar beta_rot = 2 * asin(1 / e); // velocity rotation
 
-  double ix[3];
+  Scalar ix[3];
   vector_normalize(v_rel_in, ix);
 
-  double vpervnorm[3];
+  Scalar vpervnorm[3];
   vector_normalize(v[i_count + 1], vpervnorm);
 
-  double iy[3];
+  Scalar iy[3];
   vett(ix, vpervnorm, iy);
   vector_normalize(iy, iy); // [MR]this *might* not work properly...
 
-  double iz[3];
+  Scalar iz[3];
   vett(ix, iy, iz);
 
-  double v_rel_in_norm = norm2(v_rel_in);
+  Scalar v_rel_in_norm = norm2(v_rel_in);
 
-  double v_sc_pl_out[3]; // TODO: document me!
+  Scalar v_sc_pl_out[3]; // TODO: document me!
 
   for (i = 0; i < 3; i++)
   {
-    double iVout = cos(beta_rot) * ix[i] + cos(gamma[i_count]) * sin(beta_rot) * iy[i] + sin(gamma[i_count]) * sin(beta_rot) * iz[i];
-    double v_rel_out = v_rel_in_norm * iVout;
+    Scalar iVout = cos(beta_rot) * ix[i] + cos(gamma[i_count]) * sin(beta_rot) * iy[i] + sin(gamma[i_count]) * sin(beta_rot) * iz[i];
+    Scalar v_rel_out = v_rel_in_norm * iVout;
     v_sc_pl_out[i] = v[i_count + 1][i] + v_rel_out;
   }
 
   // Computing S/C position and absolute incoming velocity at DSMi
-  double rd[3], v_sc_dsm_in[3];
+  Scalar rd[3], v_sc_dsm_in[3];
 
-  propagateKEP(r[i_count + 1], v_sc_pl_out, alpha[i_count + 1] * tof[i_count + 1] * 86400, MU[0],
-               rd, v_sc_dsm_in); // [MR] last two are output
+  pass::propagate_kepler(dsm_propagator(problem), r[i_count + 1], v_sc_pl_out, alpha[i_count + 1] * tof[i_count + 1] * 86400, MU[0],
+                         rd, v_sc_dsm_in); // [MR] last two are output
 
   // Evaluating the Lambert arc from DSMi to Pi+1
-  double Dum_Vec[3]; // [MR] Rename it to something sensible...
+  Scalar Dum_Vec[3]; // [MR] Rename it to something sensible...
   vett(rd, r[i_count + 2], Dum_Vec);
 
   int lw = (Dum_Vec[2] > 0) ? 0 : 1;
-  double a, p, theta;
-  int iter_unused; // [MR] unused variable
 
-  double v_sc_dsm_out[3]; // DSM output speed
+  Scalar v_sc_dsm_out[3]; // DSM output speed
 
-  LambertI(rd, r[i_count + 2], tof[i_count + 1] * (1 - alpha[i_count + 1]) * 86400, MU[0], lw,
-           v_sc_dsm_out, v_sc_nextpl_in, a, p, theta, iter_unused); // [MR] last 6 are output.
+  dsm_lambert(problem, rd, r[i_count + 2], tof[i_count + 1] * (1 - alpha[i_count + 1]) * 86400, lw,
+              v_sc_dsm_out, v_sc_nextpl_in); // [MR] last 2 are output.
 
   // DV contribution
   for (i = 0; i < 3; i++)
@@ -272,30 +353,31 @@ void intermediate_block(const std::vector<double> &t, const mgadsmproblem &probl
 
 // FINAL BLOCK
 //
-void final_block(const mgadsmproblem &problem, const std::vector<double *> &v, const double v_sc_pl_in[], std::vector<double> &DV)
+template <typename Scalar>
+void final_block(const mgadsmplan &problem, const Scalar (*v)[3], const Scalar v_sc_pl_in[], Scalar *DV)
 {
   //[MR] A bunch of helper variables to simplify the code
-  const int n = problem.sequence.size();
+  const int n = problem.n;
   const double rp_target = problem.rp;
   const double e_target = problem.e;
-  const std::vector<int> &sequence = problem.sequence;
+  const double *mu = problem.mu;
 
   int i; //loop counter
 
   // Evaluation of the arrival DV
-  double Dum_Vec[3];
+  Scalar Dum_Vec[3];
   for (i = 0; i < 3; i++)
   {
     Dum_Vec[i] = v[n - 1][i] - v_sc_pl_in[i];
   }
 
-  double DVrel, DVarr;
+  Scalar DVrel, DVarr;
   DVrel = norm2(Dum_Vec); // Relative velocity at target planet
 
   if ((problem.type == orbit_insertion) || (problem.type == total_DV_orbit_insertion))
   {
-    double DVper = sqrt(DVrel * DVrel + 2 * MU[sequence[n - 1]] / rp_target); //[MR] should MU be changed to get_... ?
-    double DVper2 = sqrt(2 * MU[sequence[n - 1]] / rp_target - MU[sequence[n - 1]] / rp_target * (1 - e_target));
+    Scalar DVper = sqrt(DVrel * DVrel + 2 * mu[n - 1] / rp_target);
+    Scalar DVper2 = sqrt(2 * mu[n - 1] / rp_target - mu[n - 1] / rp_target * (1 - e_target));
     DVarr = fabs(DVper - DVper2);
   }
   else if (problem.type == rndv)
@@ -314,28 +396,29 @@ void final_block(const mgadsmproblem &problem, const std::vector<double *> &v, c
   DV[n - 1] = DVarr;
 }
 
-double time2distance(const double *r0, const double *v0, double rtarget)
+template <typename Scalar>
+Scalar time2distance(const Scalar *r0, const Scalar *v0, double rtarget)
 {
-  double E[6];
-  double r0norm = norm2(r0);
-  double E0, p, ni, Et;
+  Scalar E[6];
+  Scalar r0norm = norm2(r0);
+  Scalar E0, p, ni, Et;
 
   if (r0norm < rtarget)
   {
-    double temp = 0.0;
+    Scalar temp = 0.0;
 
     for (int i = 0; i < 3; i++)
       temp += r0[i] * v0[i];
 
     IC2par(r0, v0, 1, E);
-    double a = E[0];
-    double e = E[1];
+    Scalar a = E[0];
+    Scalar e = E[1];
     E0 = E[5];
     p = a * (1 - e * e);
     // If the solution is an ellipse
     if (e < 1)
     {
-      double ra = a * (1 + e);
+      Scalar ra = a * (1 + e);
       if (rtarget > ra)
         return -1; // NaN;
       else         // we find the anomaly where the target distance is reached
@@ -370,58 +453,126 @@ double time2distance(const double *r0, const double *v0, double rtarget)
     return 12;
 }
 
-int MGA_DSM(
-    /* INPUT values: */    //[MR] make this parameters const, if they are not modified and possibly references (especially 'problem').
-    std::vector<double> t, // it is the vector which provides time in modified julian date 2000. [MR] ??? Isn't it the decision vetor ???
-    mgadsmproblem &problem,
+mgadsmplan compile_mga_dsm(const mgadsmproblem &problem)
+{
+  const int n = problem.sequence.size();
+  if (n < 2 || n > max_sequence_length)
+    throw std::invalid_argument("The fly-by sequence must contain between 2 and `max_sequence_length` bodies.");
+  if (!problem.ephemerides.empty() && static_cast<int>(problem.ephemerides.size()) != n)
+    throw std::invalid_argument("`ephemerides` must be empty or contain an entry for each body.");
+  if (problem.type == asteroid_impact)
+    throw std::invalid_argument("MGA_DSM doesn't support the type `asteroid_impact`.");
+
+  mgadsmplan plan;
+  plan.type = problem.type;
+  plan.n = n;
+  plan.asteroid = problem.asteroid;
+  plan.e = problem.e;
+  plan.rp = problem.rp;
+  plan.AUdist = problem.AUdist;
+  plan.DVtotal = problem.DVtotal;
+  plan.DVonboard = problem.DVonboard;
+  plan.propagator = problem.propagator;
+  plan.fidelity = problem.fidelity;
+
+  for (int i_count = 0; i_count < n; i_count++)
+  {
+    const int body = problem.sequence[i_count];
+    if (body < 10 && (body < 1 || body > 8))
+      throw std::invalid_argument("The fly-by sequence may only contain the planets 1 to 8 or a custom object (10).");
+
+    plan.sequence[i_count] = body;
+    plan.mu[i_count] = body < 10 ? MU[body] : problem.asteroid.mu;
+    plan.radius[i_count] = body <= 6 ? RPL[body - 1] : 0.0;
+    plan.ephemerides[i_count] = problem.ephemerides.empty() ? nullptr : problem.ephemerides[i_count];
+  }
 
-    /* OUTPUT values: */
-    double &J // output
-)
+  return plan;
+}
+
+namespace
+{
+// MGA_DSM, which stops once the DVs of the legs so far exceed `cutoff` (see
+// the overload with cutoff). Only the bodies {first_body...n-1} and the legs
+// {first_leg...n-2} are evaluated; the others are taken from the arrays of the
+// state (see mgadsmstate), which are passed one by one, so that they may hold
+// dual numbers as well
+template <typename Scalar>
+int mga_dsm(const Scalar *t, const mgadsmplan &problem, const double cutoff,
+            const int first_body, const int first_leg,
+            Scalar *dates, Scalar (*r)[3], Scalar (*v)[3], Scalar *leg_DV,
+            Scalar (*v_arrival)[3], int &legs, Scalar *DV_out, Scalar &J)
 {
   //[MR] A bunch of helper variables to simplify the code
-  const int n = problem.sequence.size();
+  const int n = problem.n;
 
   int i; //loop counter
 
-  //References to objects pre-allocated in the mgadsm struct
-  std::vector<double *> &r = problem.r;
-  std::vector<double *> &v = problem.v;
+  //DV contributions
+  Scalar DV[max_sequence_length + 1];
 
-  std::vector<double> &DV = problem.DV; //DV contributions
+  if (n < 2 || n > max_sequence_length)
+  {
+    return -1;
+  }
 
-  precalculate_ers_and_vees(t, problem, r, v);
+  precalculate_ers_and_vees(t, problem, first_body, dates, r, v);
 
-  double inter_pl_in_v[3], inter_pl_out_v[3]; //inter-hop velocities
+  // The objective function of all types except time2AUs is the sum of the
+  // DVs, plus the escape velocity for the total_DV types. So, the DVs of the
+  // legs so far are a lower bound
+  const bool is_cumulative = problem.type != time2AUs;
+  Scalar DVsum = (problem.type == total_DV_orbit_insertion || problem.type == total_DV_rndv) ? t[1] : Scalar(0.0);
+
+  for (i = 0; i < first_leg; i++)
+  {
+    DVsum += leg_DV[i];
+  }
 
   // FIRST BLOCK
-  first_block(t, problem, r, v,
-              DV, inter_pl_out_v); // [MR] output
+  if (first_leg == 0)
+  {
+    first_block(t, problem, r, v,
+                leg_DV, v_arrival[0]); // [MR] output
+    legs = 1;
+
+    DVsum += leg_DV[0];
+    if (is_cumulative && DVsum > cutoff)
+    {
+      J = DVsum;
+      return 1;
+    }
+  }
 
   // INTERMEDIATE BLOCK
-  for (int i_count = 0; i_count < n - 2; i_count++)
+  for (int i_count = std::max(first_leg - 1, 0); i_count < n - 2; i_count++)
   {
-    //copy previous output velocity to current input velocity
-    inter_pl_in_v[0] = inter_pl_out_v[0];
-    inter_pl_in_v[1] = inter_pl_out_v[1];
-    inter_pl_in_v[2] = inter_pl_out_v[2];
+    intermediate_block(t, problem, r, v, i_count, v_arrival[i_count],
+                       leg_DV, v_arrival[i_count + 1]);
+    legs = i_count + 2;
 
-    intermediate_block(t, problem, r, v, i_count, inter_pl_in_v,
-                       DV, inter_pl_out_v);
+    DVsum += leg_DV[i_count + 1];
+    if (is_cumulative && DVsum > cutoff)
+    {
+      J = DVsum;
+      return 1;
+    }
   }
 
-  //copy previous output velocity to current input velocity
-  inter_pl_in_v[0] = inter_pl_out_v[0];
-  inter_pl_in_v[1] = inter_pl_out_v[1];
-  inter_pl_in_v[2] = inter_pl_out_v[2];
+  const Scalar *inter_pl_in_v = v_arrival[n - 2]; //velocity at the last body
   // FINAL BLOCK
   final_block(problem, v, inter_pl_in_v,
-              DV);
+              leg_DV);
+
+  for (i = 0; i < n; i++)
+  {
+    DV[i] = leg_DV[i];
+  }
 
   // **************************************************************************
   // Evaluation of total DV spent by the propulsion system
   // **************************************************************************
-  double DVtot = 0.0;
+  Scalar DVtot = 0.0;
 
   for (i = 0; i < n; i++)
   {
@@ -431,7 +582,7 @@ int MGA_DSM(
   // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
   //[MR] Calculation of the actual procedure output (DVvec and J)
 
-  const double &VINF = t[1]; // Variable renaming: Hyperbolic escape velocity (km/sec)
+  const Scalar &VINF = t[1]; // Variable renaming: Hyperbolic escape velocity (km/sec)
 
   for (i = n; i > 0; i--)
   {
@@ -460,13 +611,12 @@ int MGA_DSM(
   else if (problem.type == time2AUs)
   { // [MR] TODO: extract method
     // [MR] helper constants
-    const std::vector<int> &sequence = problem.sequence;
-    const double *rp_non_dim = &t[2 * n + 2]; // non-dim perigee fly-by radius of planets P2..Pn(-1) (i=1 refers to the second planet)
-    const double *gamma = &t[3 * n];          // rotation of the bplane-component of the swingby outgoing
+    const Scalar *rp_non_dim = &t[2 * n + 2]; // non-dim perigee fly-by radius of planets P2..Pn(-1) (i=1 refers to the second planet)
+    const Scalar *gamma = &t[3 * n];          // rotation of the bplane-component of the swingby outgoing
     const double AUdist = problem.AUdist;
     const double DVtotal = problem.DVtotal;
     const double DVonboard = problem.DVonboard;
-    const double *tof = &t[4];
+    const Scalar *tof = &t[4];
 
     // non dimensional units
     const double AU = 149597870.66;
@@ -474,65 +624,65 @@ int MGA_DSM(
     const double T = AU / V;
 
     //evaluate the state of the spacecraft after the last fly-by
-    double vrelin = 0.0;
-    double v_rel_in[3];
+    Scalar vrelin = 0.0;
+    Scalar v_rel_in[3];
     for (i = 0; i < 3; i++)
     {
       v_rel_in[i] = inter_pl_in_v[i] - v[n - 1][i];
       vrelin += v_rel_in[i] * v_rel_in[i];
     }
 
-    double e = 1.0 + rp_non_dim[n - 2] * RPL[sequence[n - 2 + 1] - 1] * vrelin / get_celobj_mu(problem, n - 1); //I hope the planet index (n - 1) is OK
+    Scalar e = 1.0 + rp_non_dim[n - 2] * problem.radius[n - 1] * vrelin / get_celobj_mu(problem, n - 1); //I hope the planet index (n - 1) is OK
 
-    double beta_rot = 2 * asin(1 / e); // velocity rotation
+    Scalar beta_rot = 2 * asin(1 / e); // velocity rotation
 
-    double vrelinn = norm2(v_rel_in);
-    double ix[3];
+    Scalar vrelinn = norm2(v_rel_in);
+    Scalar ix[3];
     for (i = 0; i < 3; i++)
       ix[i] = v_rel_in[i] / vrelinn;
     // ix=r_rel_in/norm(v_rel_in);  // activating this line and disactivating the one above
     // shifts the singularity for r_rel_in parallel to v_rel_in
 
-    double vnorm = norm2(v[n - 1]);
+    Scalar vnorm = norm2(v[n - 1]);
 
-    double vtemp[3];
+    Scalar vtemp[3];
     for (i = 0; i < 3; i++)
       vtemp[i] = v[n - 1][i] / vnorm;
 
-    double iy[3];
+    Scalar iy[3];
     vett(ix, vtemp, iy);
 
-    double iynorm = norm2(iy);
+    Scalar iynorm = norm2(iy);
     for (i = 0; i < 3; i++)
       iy[i] = iy[i] / iynorm;
 
-    double iz[3];
+    Scalar iz[3];
     vett(ix, iy, iz);
-    double v_rel_in_norm = norm2(v_rel_in);
+    Scalar v_rel_in_norm = norm2(v_rel_in);
 
-    double v_sc_pl_out[3]; // TODO: document me!
+    Scalar v_sc_pl_out[3]; // TODO: document me!
     for (i = 0; i < 3; i++)
     {
-      double iVout = cos(beta_rot) * ix[i] + cos(gamma[n - 2]) * sin(beta_rot) * iy[i] + sin(gamma[n - 2]) * sin(beta_rot) * iz[i];
-      double v_rel_out = v_rel_in_norm * iVout;
+      Scalar iVout = cos(beta_rot) * ix[i] + cos(gamma[n - 2]) * sin(beta_rot) * iy[i] + sin(gamma[n - 2]) * sin(beta_rot) * iz[i];
+      Scalar v_rel_out = v_rel_in_norm * iVout;
       v_sc_pl_out[i] = v[n - 1][i] + v_rel_out;
     }
 
-    double r_per_AU[3];
-    double v_sc_pl_out_per_V[3];
+    Scalar r_per_AU[3];
+    Scalar v_sc_pl_out_per_V[3];
     for (i = 0; i < 3; i++)
     {
       r_per_AU[i] = r[n - 1][i] / AU;
       v_sc_pl_out_per_V[i] = v_sc_pl_out[i] / V;
     }
 
-    double time = time2distance(r_per_AU, v_sc_pl_out_per_V, AUdist);
+    Scalar time = time2distance(r_per_AU, v_sc_pl_out_per_V, AUdist);
     // if (time == -1) cout << " ERROR" << endl;
 
     if (time != -1)
     {
-      double DVpen = 0;
-      double sum = 0.0;
+      Scalar DVpen = 0;
+      Scalar sum = 0.0;
 
       for (i = 0; i < n + 1; i++)
         sum += DV[i];
@@ -557,5 +707,121 @@ int MGA_DSM(
       J = 100000; // there was an ERROR in time2distance
   }               // time2AU
 
+  if (DV_out != nullptr)
+  {
+    for (i = 0; i < n + 1; i++)
+      DV_out[i] = DV[i];
+  }
+
   return 0;
 }
+} // namespace
+
+int MGA_DSM(
+    /* INPUT values: */
+    const double *t, // it is the decision vector
+    const mgadsmplan &problem,
+
+    /* OUTPUT values: */
+    double *DV_out, // impulsive DVs, may be nullptr
+    double &J       // output
+)
+{
+  mgadsmstate state;
+  return mga_dsm(t, problem, std::numeric_limits<double>::infinity(), 0, 0,
+                 state.dates, state.r, state.v, state.DV, state.v_arrival, state.legs, DV_out, J);
+}
+
+int MGA_DSM(const double *t, const mgadsmplan &problem, const double cutoff, double &J)
+{
+  mgadsmstate state;
+  return mga_dsm(t, problem, cutoff, 0, 0, state.dates, state.r, state.v, state.DV, state.v_arrival,
+                 state.legs, static_cast<double *>(nullptr), J);
+}
+
+int MGA_DSM(const double *t, const mgadsmplan &problem, mgadsmstate &state, double &J)
+{
+  const int n = problem.n;
+
+  if (n < 2 || n > max_sequence_length)
+  {
+    return -1;
+  }
+
+  // The first body and the first leg that depend on the changed entries of the
+  // decision vector. A leg depends on its time of flight and DSM timing, the
+  // fly-by before it, and all entries the previous legs depend on
+  int first_body = 0;
+  int first_leg = 0;
+
+  if (state.plan == &problem && state.fidelity == problem.fidelity)
+  {
+    const int dimension = 4 * n - (problem.type == time2AUs ? 1 : 2);
+
+    first_body = n;
+    first_leg = state.legs;
+
+    for (int k = 0; k < dimension; k++)
+    {
+      if (t[k] == state.t[k])
+      {
+        continue;
+      }
+
+      int body = n;
+      int leg;
+      if (k == 0) // launch date
+      {
+        body = 0;
+        leg = 0;
+      }
+      else if (k < 4) // escape velocity
+        leg = 0;
+      else if (k < n + 3) // times of flight
+      {
+        body = k - 3;
+        leg = k - 4;
+      }
+      else if (k < 2 * n + 2) // DSM timings
+        leg = k - n - 3;
+      else if (k < 3 * n) // pericenter radii of the fly-bys
+        leg = k - 2 * n - 1;
+      else // b-plane angles of the fly-bys; the last one of time2AUs only affects J
+        leg = std::min(k - 3 * n + 1, n - 1);
+
+      first_body = std::min(first_body, body);
+      first_leg = std::min(first_leg, leg);
+    }
+
+    for (int k = 0; k < dimension; k++)
+    {
+      state.t[k] = t[k];
+    }
+  }
+  else
+  {
+    state.plan = &problem;
+    state.fidelity = problem.fidelity;
+    for (int k = 0; k < 4 * n - (problem.type == time2AUs ? 1 : 2); k++)
+    {
+      state.t[k] = t[k];
+    }
+  }
+
+  return mga_dsm(t, problem, std::numeric_limits<double>::infinity(), first_body, first_leg,
+                 state.dates, state.r, state.v, state.DV, state.v_arrival, state.legs,
+                 static_cast<double *>(nullptr), J);
+}
+
+int MGA_DSM(const pass::gradient_dual *t, const mgadsmplan &problem, pass::gradient_dual &J)
+{
+  pass::gradient_dual dates[max_sequence_length];
+  pass::gradient_dual r[max_sequence_length][3];
+  pass::gradient_dual v[max_sequence_length][3];
+  pass::gradient_dual DV[max_sequence_length];
+  pass::gradient_dual v_arrival[max_sequence_length - 1][3];
+  int legs = 0;
+
+  return mga_dsm(t, problem, std::numeric_limits<double>::infinity(), 0, 0, dates, r, v, DV, v_arrival,
+                 legs, static_cast<pass::gradient_dual *>(nullptr), J);
+}
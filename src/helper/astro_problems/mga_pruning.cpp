@@ -0,0 +1,187 @@
+#include "pass_bits/helper/astro_problems/mga_pruning.hpp"
+#include "pass_bits/helper/astro_problems/astro_functions.hpp"
+#include "pass_bits/helper/astro_problems/constants.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
+#include "pass_bits/helper/astro_problems/pow_swing_by_inv.hpp"
+#include <algorithm> // std::nth_element, std::max
+#include <array>     // std::array
+#include <cmath>     // std::acos, std::sqrt, std::fabs
+#include <limits>    // std::numeric_limits
+#include <stdexcept> // std::invalid_argument
+
+namespace
+{
+/**
+ * A cell whose legs up to the current one survived.
+ */
+struct cell
+{
+  arma::vec lower_bounds;
+  arma::vec upper_bounds;
+  /**
+   * Arrival date (MJD2000) and velocity at the end of the last pruned leg,
+   * evaluated at the centre of the cell.
+   */
+  double arrival_date;
+  std::array<double, 3> arrival_velocity;
+  /**
+   * The accumulated DV of all pruned legs.
+   */
+  double cost;
+};
+
+/**
+ * Returns the DV that the leg `leg` of `parent`, refined to
+ * [`lower_bound`, `upper_bound`] in the leg duration, adds to the mission, and
+ * sets the arrival state of `child`. Returns infinity if the Lambert arc
+ * can't be solved.
+ */
+double leg_cost(const mgaplan &plan, const int leg, const cell &parent,
+                const double lower_bound, const double upper_bound, cell &child)
+{
+  const double duration = (lower_bound + upper_bound) / 2.0;
+
+  double r1[3], v1[3], r2[3], v2[3];
+  get_celobj_r_and_v(plan, parent.arrival_date, leg, r1, v1);
+  get_celobj_r_and_v(plan, parent.arrival_date + duration, leg + 1, r2, v2);
+
+  // Same direction as in `MGA`
+  double normal[3];
+  vett(r1, r2, normal);
+  const bool long_way = normal[2] > 0 ? plan.rev_flag[leg] != 0 : plan.rev_flag[leg] == 0;
+
+  double v_departure[3];
+  if (pass::solve_lambert(r1, r2, duration * 24 * 60 * 60, pass::celestial_body::SUN.mu,
+                          long_way, v_departure, child.arrival_velocity.data()) != pass::lambert_error::none)
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+  child.arrival_date = parent.arrival_date + duration;
+
+  double cost = 0.0;
+  if (leg == 0)
+  {
+    // Launch
+    cost = std::max(0.0, norm(v_departure, v1) - plan.DVlaunch);
+  }
+  else
+  {
+    // Swing-by at the departure body, including its pericenter penalty
+    const double Vin = norm(parent.arrival_velocity.data(), v1);
+    const double Vout = norm(v_departure, v1);
+
+    double dot_product = 0.0;
+    for (int i = 0; i < 3; ++i)
+    {
+      dot_product += (parent.arrival_velocity[i] - v1[i]) * (v_departure[i] - v1[i]);
+    }
+
+    double rp;
+    pass::pow_swing_by_inv(Vin, Vout, std::acos(dot_product / (Vin * Vout)), cost, rp);
+    rp *= plan.mu[leg];
+    if (rp < plan.penalty[leg])
+    {
+      cost += plan.penalty_coeffs[leg] * std::fabs(rp - plan.penalty[leg]);
+    }
+  }
+
+  if (leg == plan.n - 2 && plan.type == total_DV_orbit_insertion)
+  {
+    // Orbit insertion at the final body, which adds to the swing-by before it,
+    // as in `MGA`
+    const double DVrel = norm(child.arrival_velocity.data(), v2);
+    const double mu = plan.mu[leg + 1];
+    const double DVper = std::sqrt(DVrel * DVrel + 2 * mu / plan.rp);
+    const double DVper2 = std::sqrt(2 * mu / plan.rp - mu / plan.rp * (1 - plan.e));
+    cost += std::fabs(DVper - DVper2);
+  }
+
+  return cost;
+}
+} // namespace
+
+std::vector<pass::search_box> pass::prune_search_space(const mga_problem &problem,
+                                                       const double threshold,
+                                                       const arma::uword cells,
+                                                       const arma::uword maximal_boxes)
+{
+  if (cells == 0 || maximal_boxes == 0)
+  {
+    throw std::invalid_argument("prune_search_space: `cells` and `maximal_boxes` must be positive.");
+  }
+
+  const mgaplan &plan = problem.compiled_mission();
+  const arma::vec cell_width = problem.bounds_range() / cells;
+
+  // The launch date
+  std::vector<cell> survivors(cells);
+  for (arma::uword c = 0; c < cells; ++c)
+  {
+    survivors[c].lower_bounds = problem.lower_bounds;
+    survivors[c].upper_bounds = problem.upper_bounds;
+    survivors[c].lower_bounds(0) = problem.lower_bounds(0) + c * cell_width(0);
+    if (c + 1 < cells)
+    {
+      survivors[c].upper_bounds(0) = survivors[c].lower_bounds(0) + cell_width(0);
+    }
+    survivors[c].arrival_date = (survivors[c].lower_bounds(0) + survivors[c].upper_bounds(0)) / 2.0;
+    survivors[c].cost = 0.0;
+  }
+
+  // The legs, one after the other. The duration of leg `leg` is dimension `leg + 1`.
+  for (int leg = 0; leg < plan.n - 1 && !survivors.empty(); ++leg)
+  {
+    const arma::uword dimension = leg + 1;
+    std::vector<cell> children(survivors.size() * cells);
+    std::vector<char> is_alive(children.size(), 0);
+
+#if defined(SUPPORT_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (arma::uword k = 0; k < children.size(); ++k)
+    {
+      const cell &parent = survivors[k / cells];
+      const arma::uword c = k % cells;
+      const double lower_bound = problem.lower_bounds(dimension) + c * cell_width(dimension);
+      const double upper_bound = c + 1 < cells ? lower_bound + cell_width(dimension)
+                                               : problem.upper_bounds(dimension);
+
+      cell &child = children[k];
+      const double cost = leg_cost(plan, leg, parent, lower_bound, upper_bound, child);
+      if (cost <= threshold)
+      {
+        child.lower_bounds = parent.lower_bounds;
+        child.upper_bounds = parent.upper_bounds;
+        child.lower_bounds(dimension) = lower_bound;
+        child.upper_bounds(dimension) = upper_bound;
+        child.cost = parent.cost + cost;
+        is_alive[k] = 1;
+      }
+    }
+
+    survivors.clear();
+    for (arma::uword k = 0; k < children.size(); ++k)
+    {
+      if (is_alive[k])
+      {
+        survivors.push_back(std::move(children[k]));
+      }
+    }
+
+    if (survivors.size() > maximal_boxes)
+    {
+      std::nth_element(survivors.begin(), survivors.begin() + maximal_boxes, survivors.end(),
+                       [](const cell &first, const cell &second) { return first.cost < second.cost; });
+      survivors.resize(maximal_boxes);
+    }
+  }
+
+  std::vector<search_box> boxes;
+  boxes.reserve(survivors.size());
+  for (const cell &survivor : survivors)
+  {
+    boxes.push_back({survivor.lower_bounds, survivor.upper_bounds});
+  }
+
+  return boxes;
+}
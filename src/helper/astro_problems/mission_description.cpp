@@ -0,0 +1,292 @@
+#include "pass_bits/helper/astro_problems/mission_description.hpp"
+#include "pass_bits/helper/astro_problems/pl_eph_an.hpp"
+#include <algorithm> // std::copy
+#include <map>       // std::map
+#include <sstream>   // std::istringstream
+#include <stdexcept> // std::invalid_argument
+#include <utility>   // std::pair
+
+namespace
+{
+double parse_number(const std::string &token)
+{
+  if (token == "pi")
+  {
+    return arma::datum::pi;
+  }
+  if (token == "-pi")
+  {
+    return -arma::datum::pi;
+  }
+
+  std::size_t length = 0;
+  double value = 0.0;
+  try
+  {
+    value = std::stod(token, &length);
+  }
+  catch (const std::exception &)
+  {
+    length = 0;
+  }
+  if (length == 0 || length != token.size())
+  {
+    throw std::invalid_argument("mission_description: `" + token + "` is not a number.");
+  }
+  return value;
+}
+
+int parse_type(const std::string &token)
+{
+  const std::pair<const char *, int> types[] = {
+      {"orbit_insertion", orbit_insertion},
+      {"total_DV_orbit_insertion", total_DV_orbit_insertion},
+      {"rndv", rndv},
+      {"total_DV_rndv", total_DV_rndv},
+      {"asteroid_impact", asteroid_impact},
+      {"time2AUs", time2AUs}};
+
+  for (const auto &type : types)
+  {
+    if (token == type.first)
+    {
+      return type.second;
+    }
+  }
+  throw std::invalid_argument("mission_description: Unknown problem type `" + token + "`.");
+}
+
+pass::kepler_propagator parse_propagator(const std::string &token)
+{
+  if (token == "elements")
+  {
+    return pass::kepler_propagator::elements;
+  }
+  if (token == "universal_variables")
+  {
+    return pass::kepler_propagator::universal_variables;
+  }
+  throw std::invalid_argument("mission_description: Unknown propagator `" + token + "`.");
+}
+
+std::vector<double> parse_numbers(std::istringstream &line)
+{
+  std::vector<double> numbers;
+  std::string token;
+  while (line >> token)
+  {
+    numbers.push_back(parse_number(token));
+  }
+  return numbers;
+}
+
+double parse_single_number(std::istringstream &line, const std::string &key)
+{
+  const std::vector<double> numbers = parse_numbers(line);
+  if (numbers.size() != 1)
+  {
+    throw std::invalid_argument("mission_description: `" + key + "` takes exactly one number.");
+  }
+  return numbers[0];
+}
+
+std::vector<int> parse_integers(std::istringstream &line, const std::string &key)
+{
+  std::vector<int> integers;
+  for (const double number : parse_numbers(line))
+  {
+    if (number != static_cast<int>(number))
+    {
+      throw std::invalid_argument("mission_description: `" + key + "` takes integers only.");
+    }
+    integers.push_back(static_cast<int>(number));
+  }
+  return integers;
+}
+} // namespace
+
+pass::mission_description pass::parse_mission_description(const std::string &description)
+{
+  mission_description mission;
+
+  std::istringstream lines(description);
+  std::string line;
+  while (std::getline(lines, line))
+  {
+    std::istringstream entry(line.substr(0, line.find('#')));
+    std::string key;
+    if (!(entry >> key))
+    {
+      continue;
+    }
+
+    if (key == "name")
+    {
+      std::getline(entry >> std::ws, mission.name);
+      mission.name.erase(mission.name.find_last_not_of(" \t\r") + 1);
+    }
+    else if (key == "type")
+    {
+      std::string type;
+      entry >> type;
+      mission.type = parse_type(type);
+    }
+    else if (key == "propagator")
+    {
+      std::string propagator;
+      entry >> propagator;
+      mission.propagator = parse_propagator(propagator);
+    }
+    else if (key == "sequence")
+    {
+      mission.sequence = parse_integers(entry, key);
+    }
+    else if (key == "rev_flag")
+    {
+      mission.rev_flag = parse_integers(entry, key);
+    }
+    else if (key == "asteroid")
+    {
+      const std::vector<double> numbers = parse_numbers(entry);
+      if (numbers.size() != 8)
+      {
+        throw std::invalid_argument("mission_description: `asteroid` takes 6 keplerian elements, the epoch and mu.");
+      }
+      std::copy(numbers.begin(), numbers.begin() + 6, mission.asteroid.keplerian);
+      mission.asteroid.epoch = numbers[6];
+      mission.asteroid.mu = numbers[7];
+    }
+    else if (key == "lower_bounds")
+    {
+      mission.lower_bounds = arma::vec(parse_numbers(entry));
+    }
+    else if (key == "upper_bounds")
+    {
+      mission.upper_bounds = arma::vec(parse_numbers(entry));
+    }
+    else if (key == "e")
+    {
+      mission.e = parse_single_number(entry, key);
+    }
+    else if (key == "rp")
+    {
+      mission.rp = parse_single_number(entry, key);
+    }
+    else if (key == "Isp")
+    {
+      mission.Isp = parse_single_number(entry, key);
+    }
+    else if (key == "mass")
+    {
+      mission.mass = parse_single_number(entry, key);
+    }
+    else if (key == "DVlaunch")
+    {
+      mission.DVlaunch = parse_single_number(entry, key);
+    }
+    else if (key == "AUdist")
+    {
+      mission.AUdist = parse_single_number(entry, key);
+    }
+    else if (key == "DVtotal")
+    {
+      mission.DVtotal = parse_single_number(entry, key);
+    }
+    else if (key == "DVonboard")
+    {
+      mission.DVonboard = parse_single_number(entry, key);
+    }
+    else
+    {
+      throw std::invalid_argument("mission_description: Unknown key `" + key + "`.");
+    }
+  }
+
+  if (mission.name.empty() || mission.sequence.empty() ||
+      mission.lower_bounds.is_empty() || mission.upper_bounds.is_empty())
+  {
+    throw std::invalid_argument("mission_description: `name`, `sequence`, `lower_bounds` and `upper_bounds` are required.");
+  }
+  if (mission.rev_flag.empty())
+  {
+    mission.rev_flag.assign(mission.sequence.size(), 0);
+  }
+
+  return mission;
+}
+
+std::vector<std::shared_ptr<const pass::ephemeris_table>> pass::tabulate_ephemerides(
+    const mission_description &mission, const double start, const double end)
+{
+  std::map<int, std::shared_ptr<const pass::ephemeris_table>> tables;
+  std::vector<std::shared_ptr<const pass::ephemeris_table>> ephemerides;
+
+  for (const int body : mission.sequence)
+  {
+    auto &table = tables[body];
+    if (!table && body < 10)
+    {
+      table = std::make_shared<const pass::ephemeris_table>(
+          [body](const double mjd2000, double *r, double *v) {
+            Planet_Ephemerides_Analytical(mjd2000, body, r, v);
+          },
+          start, end);
+    }
+    else if (!table)
+    {
+      const customobject object = mission.asteroid;
+      table = std::make_shared<const pass::ephemeris_table>(
+          [object](const double mjd2000, double *r, double *v) {
+            Custom_Eph(mjd2000 + 2451544.5, object.epoch, object.keplerian, r, v);
+          },
+          start, end);
+    }
+    ephemerides.push_back(table);
+  }
+
+  return ephemerides;
+}
+
+const char *const pass::missions::cassini1 = R"(
+name Cassini1
+type total_DV_orbit_insertion
+sequence 3 2 2 3 5 6
+rev_flag 0 0 0 0 0 0
+e 0.98
+rp 108950
+DVlaunch 0
+lower_bounds -1000 30 100 30 400 1000
+upper_bounds 0 400 470 400 2000 6000
+)";
+
+const char *const pass::missions::gtoc1 = R"(
+name GTOC1
+type asteroid_impact
+sequence 3 2 3 2 3 5 6 10
+rev_flag 0 0 0 0 0 0 1 0
+asteroid 2.5897261 0.2734625 6.40734 128.34711 264.78691 320.479555 53600 0
+Isp 2500
+mass 1500
+DVlaunch 2.5
+lower_bounds 3000 14 14 14 14 100 366 300
+upper_bounds 10000 2000 2000 2000 2000 9000 9000 9000
+)";
+
+const char *const pass::missions::messenger_full = R"(
+name Messenger_Full
+type orbit_insertion
+sequence 3 2 2 1 1 1 1
+e 0.704
+rp 2640
+lower_bounds 1900 2.5 0 0 100 100 100 100 100 100 0.01 0.01 0.01 0.01 0.01 0.01 1.1 1.1 1.05 1.05 1.05 -pi -pi -pi -pi -pi
+upper_bounds 2300 4.05 1 1 500 500 500 500 500 600 0.99 0.99 0.99 0.99 0.99 0.99 6 6 6 6 6 pi pi pi pi pi
+)";
+
+const char *const pass::missions::rosetta = R"(
+name Rosetta
+type rndv
+sequence 3 3 4 3 3 10
+asteroid 3.50294972836275 0.6319356 7.12723 50.92302 11.36788 0 52504.23754000012 0
+lower_bounds 1460 3 0 0 300 150 150 300 700 0.01 0.01 0.01 0.01 0.01 1.05 1.05 1.05 1.05 -pi -pi -pi -pi
+upper_bounds 1825 5 1 1 500 800 800 800 1850 0.9 0.9 0.9 0.9 0.9 9 9 9 9 pi pi pi pi
+)";
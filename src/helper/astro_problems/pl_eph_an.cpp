@@ -10,11 +10,13 @@
 
 #include "pass_bits/helper/astro_problems/astro_functions.hpp"
 #include "pass_bits/helper/astro_problems/pl_eph_an.hpp"
+#include "pass_bits/helper/dual.hpp"
 
-void Planet_Ephemerides_Analytical(const double mjd2000,
+template <typename Scalar>
+void Planet_Ephemerides_Analytical(const Scalar mjd2000,
                                    const int planet,
-                                   double *position,
-                                   double *velocity)
+                                   Scalar *position,
+                                   Scalar *velocity)
 {
   const double pi = acos(-1.0);
   const double RAD = pi / 180.0;
@@ -22,10 +24,10 @@ void Planet_Ephemerides_Analytical(const double mjd2000,
   const double KM = AU;
   //const double MuSun = 1.32712440018e+11; //Gravitational constant of Sun);
   const double MuSun = 1.327124280000000e+011; //Gravitational constant of Sun);
-  double Kepl_Par[6];
-  double XM;
+  Scalar Kepl_Par[6];
+  Scalar XM;
 
-  double T = (mjd2000 + 36525.00) / 36525.00;
+  Scalar T = (mjd2000 + 36525.00) / 36525.00;
 
   switch (planet)
   {
@@ -132,18 +134,20 @@ void Planet_Ephemerides_Analytical(const double mjd2000,
   Conversion(Kepl_Par, position, velocity, MuSun);
 }
 
-void Custom_Eph(const double jd,
+template <typename Scalar>
+void Custom_Eph(const Scalar jd,
                 const double epoch,
                 const double keplerian[],
-                double *position,
-                double *velocity)
+                Scalar *position,
+                Scalar *velocity)
 {
   const double pi = acos(-1.0);
   const double RAD = pi / 180.0;
   const double AU = 149597870.66;      // Astronomical Unit
   const double muSUN = 1.32712428e+11; // Gravitational constant of Sun
-  double a, e, i, W, w, M, jdepoch, DT, n, E;
-  double V[6];
+  double a, e, i, W, w, jdepoch, n;
+  Scalar M, DT, E;
+  Scalar V[6];
 
   a = keplerian[0] * AU; // in km
   e = keplerian[1];
@@ -158,7 +162,7 @@ void Custom_Eph(const double jd,
   M = M / 180.0 * pi;
   M += n * DT;
   M = fmod(M, 2 * pi);
-  E = Mean2Eccentric(M, e);
+  E = Mean2Eccentric<Scalar>(M, e);
   V[0] = a;
   V[1] = e;
   V[2] = i * RAD;
@@ -168,3 +172,10 @@ void Custom_Eph(const double jd,
 
   Conversion(V, position, velocity, muSUN);
 }
+
+template void Planet_Ephemerides_Analytical(const double, const int, double *, double *);
+template void Planet_Ephemerides_Analytical(const pass::gradient_dual, const int,
+                                            pass::gradient_dual *, pass::gradient_dual *);
+template void Custom_Eph(const double, const double, const double[], double *, double *);
+template void Custom_Eph(const pass::gradient_dual, const double, const double[],
+                         pass::gradient_dual *, pass::gradient_dual *);
@@ -0,0 +1,241 @@
+#include "pass_bits/helper/astro_problems/porkchop_table.hpp"
+#include <algorithm>  // std::min
+#include <cmath>      // std::isfinite
+#include <cstdint>    // std::uint64_t
+#include <cstdio>     // std::remove, std::rename
+#include <cstring>    // std::memcmp, std::memcpy
+#include <fcntl.h>    // open
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close, getpid, read, write
+
+namespace
+{
+/**
+ * Header of a cache file, followed by the nodes. Its size is a multiple of
+ * 8 bytes, so the nodes are aligned within the mapping.
+ */
+struct file_header
+{
+  char magic[8];
+  double mu;
+  double earliest_departure;
+  double latest_departure;
+  double shortest_time_of_flight;
+  double longest_time_of_flight;
+  std::uint64_t departure_points;
+  std::uint64_t time_of_flight_points;
+  /**
+   * Positions of the objects at the corners of the box, to detect tables of
+   * other objects.
+   */
+  double fingerprint[12];
+};
+
+const char magic[8] = {'P', 'A', 'S', 'S', 'P', 'K', 'C', '1'};
+
+/**
+ * Maps the nodes of `path` if its header equals `expected`, and returns
+ * `nullptr` otherwise.
+ */
+std::shared_ptr<const double> load_nodes(const std::string &path, const file_header &expected,
+                                         const std::size_t number_of_values)
+{
+  const int file = open(path.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return nullptr;
+  }
+
+  const std::size_t size = sizeof(file_header) + number_of_values * sizeof(double);
+  struct stat status;
+  file_header header;
+  if (fstat(file, &status) != 0 || static_cast<std::size_t>(status.st_size) != size ||
+      read(file, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(&header, &expected, sizeof(header)) != 0)
+  {
+    close(file);
+    return nullptr;
+  }
+
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  return std::shared_ptr<const double>(
+      reinterpret_cast<const double *>(static_cast<const char *>(mapping) + sizeof(file_header)),
+      [mapping, size](const double *) { munmap(mapping, size); });
+}
+
+/**
+ * Writes the cache file. Other processes only ever see complete files, as
+ * the file is written to a temporary name first. Failures are ignored, since
+ * the cache is optional.
+ */
+void save_nodes(const std::string &path, const file_header &header, const double *nodes,
+                const std::size_t number_of_values)
+{
+  const std::string temporary_path = path + "." + std::to_string(getpid()) + ".tmp";
+  const int file = open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file < 0)
+  {
+    return;
+  }
+
+  bool is_written = write(file, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+  const char *data = reinterpret_cast<const char *>(nodes);
+  std::size_t remaining = number_of_values * sizeof(double);
+  while (is_written && remaining > 0)
+  {
+    const ssize_t written = write(file, data, remaining);
+    is_written = written > 0;
+    if (is_written)
+    {
+      data += written;
+      remaining -= written;
+    }
+  }
+  is_written = close(file) == 0 && is_written;
+
+  if (!is_written || std::rename(temporary_path.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary_path.c_str());
+  }
+}
+} // namespace
+
+pass::porkchop_table::porkchop_table(const analytical_ephemeris &departure_object,
+                                     const analytical_ephemeris &arrival_object, const double mu,
+                                     const double earliest_departure, const double latest_departure,
+                                     const double shortest_time_of_flight, const double longest_time_of_flight,
+                                     const std::size_t departure_points,
+                                     const std::size_t time_of_flight_points,
+                                     const std::string &cache_file)
+    : mu(mu),
+      earliest_departure(earliest_departure),
+      shortest_time_of_flight(shortest_time_of_flight),
+      departure_points(departure_points),
+      time_of_flight_points(time_of_flight_points),
+      inverse_departure_step((departure_points - 1) / (latest_departure - earliest_departure)),
+      inverse_time_of_flight_step((time_of_flight_points - 1) / (longest_time_of_flight - shortest_time_of_flight)),
+      was_loaded(false),
+      nodes(nullptr)
+{
+  if (!(earliest_departure < latest_departure) || !(shortest_time_of_flight < longest_time_of_flight))
+  {
+    throw std::invalid_argument("porkchop_table: The ranges of departure dates and times of flight must not be empty.");
+  }
+  if (!(shortest_time_of_flight > 0.0))
+  {
+    throw std::invalid_argument("porkchop_table: The times of flight must be positive.");
+  }
+  if (departure_points < 2 || time_of_flight_points < 2)
+  {
+    throw std::invalid_argument("porkchop_table: At least 2 points per dimension are required.");
+  }
+
+  const std::size_t number_of_values = 2 * departure_points * time_of_flight_points;
+  const double departure_step = (latest_departure - earliest_departure) / (departure_points - 1);
+  const double time_of_flight_step = (longest_time_of_flight - shortest_time_of_flight) / (time_of_flight_points - 1);
+
+  file_header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.mu = mu;
+  header.earliest_departure = earliest_departure;
+  header.latest_departure = latest_departure;
+  header.shortest_time_of_flight = shortest_time_of_flight;
+  header.longest_time_of_flight = longest_time_of_flight;
+  header.departure_points = departure_points;
+  header.time_of_flight_points = time_of_flight_points;
+  double unused[3];
+  departure_object(earliest_departure, header.fingerprint, unused);
+  departure_object(latest_departure, header.fingerprint + 3, unused);
+  arrival_object(earliest_departure + shortest_time_of_flight, header.fingerprint + 6, unused);
+  arrival_object(latest_departure + longest_time_of_flight, header.fingerprint + 9, unused);
+
+  if (!cache_file.empty())
+  {
+    storage = load_nodes(cache_file, header, number_of_values);
+    if (storage)
+    {
+      was_loaded = true;
+      nodes = storage.get();
+      return;
+    }
+  }
+
+  std::shared_ptr<double> values(new double[number_of_values], std::default_delete<double[]>());
+  double *const data = values.get();
+
+#if defined(SUPPORT_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (std::size_t k = 0; k < departure_points * time_of_flight_points; ++k)
+  {
+    const double departure_date = earliest_departure + (k / time_of_flight_points) * departure_step;
+    const double time_of_flight = shortest_time_of_flight + (k % time_of_flight_points) * time_of_flight_step;
+
+    double r1[3], r2[3], v[3];
+    departure_object(departure_date, r1, v);
+    arrival_object(departure_date + time_of_flight, r2, v);
+
+    for (const bool long_way : {false, true})
+    {
+      double x, v1[3], v2[3];
+      data[2 * k + long_way] = solve_lambert(r1, r2, time_of_flight * 24 * 60 * 60, mu,
+                                             long_way, v1, v2, &x) == lambert_error::none
+                                   ? x
+                                   : std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  if (!cache_file.empty())
+  {
+    save_nodes(cache_file, header, data, number_of_values);
+  }
+
+  storage = values;
+  nodes = data;
+}
+
+pass::lambert_error pass::porkchop_table::solve(const double departure_date, const double time_of_flight,
+                                                const double *r1, const double *r2, const bool long_way,
+                                                double *v1, double *v2) const
+{
+  const double seconds = time_of_flight * 24 * 60 * 60;
+
+  // Position within the grid
+  const double u = (departure_date - earliest_departure) * inverse_departure_step;
+  const double w = (time_of_flight - shortest_time_of_flight) * inverse_time_of_flight_step;
+  if (!(u >= 0.0 && u <= departure_points - 1 && w >= 0.0 && w <= time_of_flight_points - 1))
+  {
+    return solve_lambert(r1, r2, seconds, mu, long_way, v1, v2);
+  }
+
+  const std::size_t i = std::min(departure_points - 2, static_cast<std::size_t>(u));
+  const std::size_t j = std::min(time_of_flight_points - 2, static_cast<std::size_t>(w));
+  const double fu = u - i;
+  const double fw = w - j;
+
+  const double *lower = nodes + 2 * (i * time_of_flight_points + j) + long_way;
+  const double *upper = lower + 2 * time_of_flight_points;
+  const double x = (1.0 - fu) * ((1.0 - fw) * lower[0] + fw * lower[2]) +
+                   fu * ((1.0 - fw) * upper[0] + fw * upper[2]);
+
+  if (!std::isfinite(x))
+  {
+    return solve_lambert(r1, r2, seconds, mu, long_way, v1, v2);
+  }
+
+  return refine_lambert(r1, r2, seconds, mu, long_way, x, 1, v1, v2);
+}
+
+bool pass::porkchop_table::is_cached() const
+{
+  return was_loaded;
+}
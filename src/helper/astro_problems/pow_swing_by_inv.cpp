@@ -9,30 +9,43 @@
 // ------------------------------------------------------------------------ //
 
 #include "pass_bits/helper/astro_problems/pow_swing_by_inv.hpp"
+#include "pass_bits/helper/dual.hpp"
 #include <cmath>
 
 void pass::pow_swing_by_inv(const double Vin, const double Vout, const double alpha,
                             double &DV, double &rp)
 {
-  const int maxiter = 30;
+  pow_swing_by_inv<high_fidelity>(Vin, Vout, alpha, DV, rp);
+}
+
+template <typename Fidelity, typename Scalar>
+void pass::pow_swing_by_inv(const Scalar Vin, const Scalar Vout, const Scalar alpha,
+                            Scalar &DV, Scalar &rp)
+{
+  using std::asin;
+  using std::fabs;
+  using std::pow;
+  using std::sqrt;
+
+  const int maxiter = Fidelity::swing_by_iterations;
   int i = 0;
   double err = 1.0;
-  const double tolerance = 1e-8;
+  const double tolerance = Fidelity::swing_by_tolerance;
 
-  double aIN = 1.0 / pow(Vin, 2);   // semimajor axis of the incoming hyperbola
-  double aOUT = 1.0 / pow(Vout, 2); // semimajor axis of the incoming hyperbola
+  Scalar aIN = 1.0 / pow(Vin, 2);   // semimajor axis of the incoming hyperbola
+  Scalar aOUT = 1.0 / pow(Vout, 2); // semimajor axis of the incoming hyperbola
 
   rp = 1.0;
   while ((err > tolerance) && (i < maxiter))
   {
     i++;
-    double f = asin(aIN / (aIN + rp)) + asin(aOUT / (aOUT + rp)) - alpha;
-    double df = -aIN / sqrt((rp + 2 * aIN) * rp) / (aIN + rp) -
+    Scalar f = asin(aIN / (aIN + rp)) + asin(aOUT / (aOUT + rp)) - alpha;
+    Scalar df = -aIN / sqrt((rp + 2 * aIN) * rp) / (aIN + rp) -
                 aOUT / sqrt((rp + 2 * aOUT) * rp) / (aOUT + rp);
-    double rp_new = rp - f / df;
+    Scalar rp_new = rp - f / df;
     if (rp_new > 0)
     {
-      err = fabs(rp_new - rp);
+      err = value_of(fabs(rp_new - rp));
       rp = rp_new;
     }
     else
@@ -42,3 +55,14 @@ void pass::pow_swing_by_inv(const double Vin, const double Vout, const double al
   // Evaluation of the DV
   DV = fabs(sqrt(Vout * Vout + (2.0 / rp)) - sqrt(Vin * Vin + (2.0 / rp)));
 }
+
+template void pass::pow_swing_by_inv<pass::high_fidelity>(const double, const double, const double,
+                                                          double &, double &);
+template void pass::pow_swing_by_inv<pass::low_fidelity>(const double, const double, const double,
+                                                         double &, double &);
+template void pass::pow_swing_by_inv<pass::high_fidelity>(const gradient_dual, const gradient_dual,
+                                                          const gradient_dual, gradient_dual &,
+                                                          gradient_dual &);
+template void pass::pow_swing_by_inv<pass::low_fidelity>(const gradient_dual, const gradient_dual,
+                                                         const gradient_dual, gradient_dual &,
+                                                         gradient_dual &);
@@ -12,6 +12,7 @@
 //
 
 #include "pass_bits/helper/astro_problems/propagate_kep.hpp"
+#include "pass_bits/helper/dual.hpp"
 
 /*
  Origin: MATLAB code programmed by Dario Izzo (ESA/ACT)
@@ -31,8 +32,9 @@
  initial condition and it propagates it as in a kepler motion analytically.
 */
 
-void propagateKEP(const double *r0_in, const double *v0_in, double t, double mu,
-                  double *r, double *v)
+template <typename Scalar>
+void propagateKEP(const Scalar *r0_in, const Scalar *v0_in, Scalar t, double mu,
+                  Scalar *r, Scalar *v)
 {
   /*
    The matrix DD will be almost always the unit matrix, except for orbits
@@ -43,12 +45,12 @@ void propagateKEP(const double *r0_in, const double *v0_in, double t, double mu,
   double DD[9] = {1, 0, 0,
                   0, 1, 0,
                   0, 0, 1};
-  double h[3];
-  double ih[3] = {0, 0, 0};
-  double temp1[3] = {0, 0, 0}, temp2[3] = {0, 0, 0};
-  double E[6];
-  double normh, M, M0;
-  double r0[3], v0[3];
+  Scalar h[3];
+  Scalar ih[3] = {0, 0, 0};
+  Scalar temp1[3] = {0, 0, 0}, temp2[3] = {0, 0, 0};
+  Scalar E[6];
+  Scalar normh, M, M0;
+  Scalar r0[3], v0[3];
 
   int i;
 
@@ -161,17 +163,18 @@ void propagateKEP(const double *r0_in, const double *v0_in, double t, double mu,
 	Mueller and White. It goes singular for zero inclination
 */
 
-void IC2par(const double *r0, const double *v0, double mu, double *E)
+template <typename Scalar>
+void IC2par(const Scalar *r0, const Scalar *v0, double mu, Scalar *E)
 {
-  double k[3];
-  double h[3];
-  double Dum_Vec[3];
-  double n[3];
-  double evett[3];
-
-  double p = 0.0;
-  double temp = 0.0;
-  double R0, ni;
+  Scalar k[3];
+  Scalar h[3];
+  Scalar Dum_Vec[3];
+  Scalar n[3];
+  Scalar evett[3];
+
+  Scalar p = 0.0;
+  Scalar temp = 0.0;
+  Scalar R0, ni;
   int i;
 
   vett(r0, v0, h);
@@ -201,7 +204,7 @@ void IC2par(const double *r0, const double *v0, double mu, double *E)
   for (i = 0; i < 3; i++)
     evett[i] = Dum_Vec[i] / mu - r0[i] / R0;
 
-  double e = 0.0;
+  Scalar e = 0.0;
   for (i = 0; i < 3; i++)
     e += pow(evett[i], 2);
 
@@ -265,17 +268,18 @@ void IC2par(const double *r0, const double *v0, double mu, double *E)
 	This function does work for hyperbolas as well.
 */
 
-void par2IC(const double *E, double mu, double *r0, double *v0)
+template <typename Scalar>
+void par2IC(const Scalar *E, double mu, Scalar *r0, Scalar *v0)
 {
-  double a = E[0];
-  double e = E[1];
-  double i = E[2];
-  double omg = E[3];
-  double omp = E[4];
-  double EA = E[5];
-  double b, n, xper, yper, xdotper, ydotper;
-  double R[3][3];
-  double cosomg, cosomp, sinomg, sinomp, cosi, sini;
+  Scalar a = E[0];
+  Scalar e = E[1];
+  Scalar i = E[2];
+  Scalar omg = E[3];
+  Scalar omp = E[4];
+  Scalar EA = E[5];
+  Scalar b, n, xper, yper, xdotper, ydotper;
+  Scalar R[3][3];
+  Scalar cosomg, cosomp, sinomg, sinomp, cosi, sini;
 
   // Grandezze definite nel piano dell'orbita
 
@@ -294,7 +298,7 @@ void par2IC(const double *E, double mu, double *r0, double *v0)
     b = -a * sqrt(e * e - 1);
     n = sqrt(-mu / (a * a * a));
 
-    double dNdZeta = e * (1 + tan(EA) * tan(EA)) - (0.5 + 0.5 * pow(tan(0.5 * EA + 0.25 * M_PI), 2)) / tan(0.5 * EA + 0.25 * M_PI);
+    Scalar dNdZeta = e * (1 + tan(EA) * tan(EA)) - (0.5 + 0.5 * pow(tan(0.5 * EA + 0.25 * M_PI), 2)) / tan(0.5 * EA + 0.25 * M_PI);
 
     xper = a / cos(EA) - a * e;
     yper = b * tan(EA);
@@ -324,8 +328,8 @@ void par2IC(const double *E, double mu, double *r0, double *v0)
 
   // Posizione nel sistema inerziale
 
-  double temp[3] = {xper, yper, 0.0};
-  double temp2[3] = {xdotper, ydotper, 0};
+  Scalar temp[3] = {xper, yper, 0.0};
+  Scalar temp2[3] = {xdotper, ydotper, 0};
 
   for (int j = 0; j < 3; j++)
   {
@@ -343,9 +347,20 @@ void par2IC(const double *E, double mu, double *r0, double *v0)
 // Returns the cross product of the vectors X and Y.
 // That is, z = X x Y.  X and Y must be 3 element
 // vectors.
-void cross(const double *x, const double *y, double *z)
+template <typename Scalar>
+void cross(const Scalar *x, const Scalar *y, Scalar *z)
 {
   z[0] = x[1] * y[2] - x[2] * y[1];
   z[1] = x[2] * y[0] - x[0] * y[2];
   z[2] = x[0] * y[1] - x[1] * y[0];
 }
+
+template void propagateKEP(const double *, const double *, double, double, double *, double *);
+template void propagateKEP(const pass::gradient_dual *, const pass::gradient_dual *, pass::gradient_dual,
+                           double, pass::gradient_dual *, pass::gradient_dual *);
+template void IC2par(const double *, const double *, double, double *);
+template void IC2par(const pass::gradient_dual *, const pass::gradient_dual *, double, pass::gradient_dual *);
+template void par2IC(const double *, double, double *, double *);
+template void par2IC(const pass::gradient_dual *, double, pass::gradient_dual *, pass::gradient_dual *);
+template void cross(const double *, const double *, double *);
+template void cross(const pass::gradient_dual *, const pass::gradient_dual *, pass::gradient_dual *);
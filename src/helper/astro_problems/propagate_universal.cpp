@@ -0,0 +1,173 @@
+#include "pass_bits/helper/astro_problems/propagate_universal.hpp"
+#include "pass_bits/helper/astro_problems/propagate_kep.hpp"
+#include "pass_bits/helper/dual.hpp"
+#include <cmath> // std::sqrt, std::cos, std::cosh, ...
+
+namespace
+{
+// Unqualified, so that dual numbers find their overloads by argument-dependent
+// lookup
+using std::cos;
+using std::cosh;
+using std::fabs;
+using std::fmax;
+using std::isfinite;
+using std::log;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+
+/**
+ * Computes the Stumpff functions C(z) and S(z). Close to zero, the closed
+ * forms cancel, so their Taylor series is used instead.
+ */
+template <typename Scalar>
+void stumpff(const Scalar z, Scalar &C, Scalar &S)
+{
+  if (z > 1e-3)
+  {
+    const Scalar sqrt_z = sqrt(z);
+    C = (1.0 - cos(sqrt_z)) / z;
+    S = (sqrt_z - sin(sqrt_z)) / (z * sqrt_z);
+  }
+  else if (z < -1e-3)
+  {
+    const Scalar sqrt_z = sqrt(-z);
+    C = (cosh(sqrt_z) - 1.0) / -z;
+    S = (sinh(sqrt_z) - sqrt_z) / (-z * sqrt_z);
+  }
+  else
+  {
+    C = 1.0 / 2.0 - z * (1.0 / 24.0 - z * (1.0 / 720.0 - z / 40320.0));
+    S = 1.0 / 6.0 - z * (1.0 / 120.0 - z * (1.0 / 5040.0 - z / 362880.0));
+  }
+}
+
+/**
+ * See `pass::propagate_universal`.
+ */
+template <typename Scalar>
+void propagate(const Scalar *r0, const Scalar *v0, const Scalar t, const double mu,
+               Scalar *r, Scalar *v)
+{
+  const double sqrt_mu = sqrt(mu);
+  const Scalar R0 = sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
+  const Scalar V0_squared = v0[0] * v0[0] + v0[1] * v0[1] + v0[2] * v0[2];
+  const Scalar r0_dot_v0 = r0[0] * v0[0] + r0[1] * v0[1] + r0[2] * v0[2];
+  const Scalar sigma0 = r0_dot_v0 / sqrt_mu;
+  // Reciprocal of the semi-major axis; negative for hyperbolas
+  const Scalar alpha = 2.0 / R0 - V0_squared / mu;
+
+  // Initial guess (Vallado, "Fundamentals of Astrodynamics and Applications")
+  Scalar chi;
+  if (alpha > 1e-12)
+  {
+    chi = sqrt_mu * t * alpha;
+  }
+  else if (alpha < -1e-12)
+  {
+    const Scalar a = 1.0 / alpha;
+    const double direction = t < 0.0 ? -1.0 : 1.0;
+    chi = direction * sqrt(-a) *
+          log(-2.0 * mu * alpha * t /
+              (r0_dot_v0 + direction * sqrt(-mu * a) * (1.0 - R0 * alpha)));
+    if (!isfinite(chi))
+    {
+      chi = sqrt_mu * t / R0;
+    }
+  }
+  else
+  {
+    chi = sqrt_mu * t / R0;
+  }
+
+  // Laguerre-Conway iterations on the universal Kepler equation F(chi) = 0,
+  // which converge from almost any initial guess
+  const double n = 5.0;
+  Scalar C, S;
+  for (int iteration = 0; iteration < 50; ++iteration)
+  {
+    const Scalar chi_squared = chi * chi;
+    const Scalar z = alpha * chi_squared;
+    stumpff(z, C, S);
+
+    const Scalar F = sigma0 * chi_squared * C + (1.0 - alpha * R0) * chi_squared * chi * S +
+                     R0 * chi - sqrt_mu * t;
+    // F' is the radius at chi
+    const Scalar dF = sigma0 * chi * (1.0 - z * S) + (1.0 - alpha * R0) * chi_squared * C + R0;
+    const Scalar ddF = sigma0 * (1.0 - z * C) + (1.0 - alpha * R0) * chi * (1.0 - z * S);
+
+    const Scalar root = sqrt(fabs((n - 1.0) * (n - 1.0) * dF * dF - n * (n - 1.0) * F * ddF));
+    const Scalar step = n * F / (dF + (dF < 0.0 ? -root : root));
+    chi -= step;
+
+    if (fabs(step) <= 1e-13 * fmax(1.0, fabs(chi)))
+    {
+      break;
+    }
+  }
+
+  // Lagrange coefficients
+  const Scalar chi_squared = chi * chi;
+  const Scalar z = alpha * chi_squared;
+  stumpff(z, C, S);
+
+  const Scalar f = 1.0 - chi_squared / R0 * C;
+  const Scalar g = t - chi_squared * chi / sqrt_mu * S;
+  for (int i = 0; i < 3; ++i)
+  {
+    r[i] = f * r0[i] + g * v0[i];
+  }
+
+  const Scalar R = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+  const Scalar df = sqrt_mu / (R * R0) * chi * (z * S - 1.0);
+  const Scalar dg = 1.0 - chi_squared / R * C;
+  for (int i = 0; i < 3; ++i)
+  {
+    v[i] = df * r0[i] + dg * v0[i];
+  }
+}
+} // namespace
+
+template <typename Scalar>
+void pass::propagate_universal(const Scalar *r0, const Scalar *v0, const Scalar t,
+                               const double mu, Scalar *r, Scalar *v)
+{
+  propagate(r0, v0, t, mu, r, v);
+}
+
+void pass::propagate_universal(const double *r0, const double *v0, const double *t,
+                               const double mu, const std::size_t n, double *r,
+                               double *v)
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    propagate(r0 + 3 * i, v0 + 3 * i, t[i], mu, r + 3 * i, v + 3 * i);
+  }
+}
+
+template <typename Scalar>
+void pass::propagate_kepler(const kepler_propagator propagator, const Scalar *r0,
+                            const Scalar *v0, const Scalar t, const double mu,
+                            Scalar *r, Scalar *v)
+{
+  if (propagator == kepler_propagator::universal_variables)
+  {
+    propagate(r0, v0, t, mu, r, v);
+  }
+  else
+  {
+    propagateKEP(r0, v0, t, mu, r, v);
+  }
+}
+
+template void pass::propagate_universal(const double *, const double *, const double,
+                                        const double, double *, double *);
+template void pass::propagate_universal(const gradient_dual *, const gradient_dual *,
+                                        const gradient_dual, const double, gradient_dual *,
+                                        gradient_dual *);
+template void pass::propagate_kepler(const kepler_propagator, const double *, const double *,
+                                     const double, const double, double *, double *);
+template void pass::propagate_kepler(const kepler_propagator, const gradient_dual *,
+                                     const gradient_dual *, const gradient_dual, const double,
+                                     gradient_dual *, gradient_dual *);
@@ -0,0 +1,290 @@
+#include "pass_bits/helper/local_search.hpp"
+#include <algorithm> // std::min, std::max
+
+void pass::bounded_lbfgs(optimise_result &result, const arma::uword maximal_evaluations,
+                         const std::chrono::nanoseconds maximal_duration)
+{
+  const pass::problem &problem = result.problem;
+
+  pass::stopwatch stopwatch;
+  stopwatch.start();
+
+  const arma::uword first_evaluation = result.evaluations;
+
+  // A gradient by automatic differentiation costs about as much as an
+  // evaluation per 8 dimensions, one by central differences 2 evaluations per
+  // dimension.
+  const arma::uword gradient_cost = problem.has_gradient() ? (problem.dimension() + 7) / 8 : 2 * problem.dimension();
+  // Gradients are only computed if the remaining evaluations can pay for them
+  const auto can_afford_gradient = [&]() {
+    return result.evaluations - first_evaluation + gradient_cost <= maximal_evaluations;
+  };
+
+  // The last pairs of steps and gradient differences, stored column-wise in a
+  // ring buffer; `newest` is the column of the last pair.
+  const arma::uword memory = 5;
+  arma::mat steps(problem.dimension(), memory);
+  arma::mat gradient_differences(problem.dimension(), memory);
+  arma::vec inverse_curvatures(memory);
+  arma::vec alphas(memory);
+  arma::uword stored = 0;
+  arma::uword newest = memory - 1;
+
+  if (!can_afford_gradient())
+  {
+    return;
+  }
+
+  arma::vec gradient = problem.normalised_gradient(result.normalised_agent);
+  ++result.gradient_evaluations;
+  result.evaluations += gradient_cost;
+
+  arma::vec is_free(problem.dimension());
+
+  while (result.evaluations - first_evaluation < maximal_evaluations &&
+         stopwatch.get_elapsed() < maximal_duration && !result.solved())
+  {
+    const arma::vec &agent = result.normalised_agent;
+
+    if (!gradient.is_finite())
+    {
+      break;
+    }
+
+    // The projected gradient vanishes at a stationary point within the bounds
+    if (arma::abs(arma::clamp(agent - gradient, 0.0, 1.0) - agent).max() < 1e-8)
+    {
+      break;
+    }
+
+    for (arma::uword k = 0; k < problem.dimension(); ++k)
+    {
+      is_free(k) = (agent(k) <= 0.0 && gradient(k) > 0.0) || (agent(k) >= 1.0 && gradient(k) < 0.0) ? 0.0 : 1.0;
+    }
+
+    // Two-loop recursion, from the newest to the oldest pair and back
+    arma::vec direction = -gradient;
+    for (arma::uword i = 0; i < stored; ++i)
+    {
+      const arma::uword j = (newest + memory - i) % memory;
+      alphas(j) = inverse_curvatures(j) * arma::dot(steps.col(j), direction);
+      direction -= alphas(j) * gradient_differences.col(j);
+    }
+    if (stored > 0)
+    {
+      direction *= arma::dot(steps.col(newest), gradient_differences.col(newest)) /
+                   arma::dot(gradient_differences.col(newest), gradient_differences.col(newest));
+    }
+    for (arma::uword i = stored; i > 0; --i)
+    {
+      const arma::uword j = (newest + memory + 1 - i) % memory;
+      const double beta = inverse_curvatures(j) * arma::dot(gradient_differences.col(j), direction);
+      direction += (alphas(j) - beta) * steps.col(j);
+    }
+    direction %= is_free;
+
+    // Restarts with steepest descent, if the fixed variables spoilt the direction
+    if (!(arma::dot(direction, gradient) < 0.0))
+    {
+      direction = -gradient % is_free;
+      stored = 0;
+    }
+
+    // Without curvature information, the first step moves by at most 10% of
+    // the bounds.
+    double step_length = 1.0;
+    if (stored == 0)
+    {
+      step_length = std::min(1.0, 0.1 / arma::abs(direction).max());
+    }
+
+    arma::vec candidate;
+    double candidate_fitness_value = 0.0;
+    bool is_accepted = false;
+    for (arma::uword backtracking = 0; backtracking < 30 &&
+                                       result.evaluations - first_evaluation < maximal_evaluations;
+         ++backtracking, step_length *= 0.5)
+    {
+      candidate = arma::clamp(agent + step_length * direction, 0.0, 1.0);
+      candidate_fitness_value = problem.evaluate_normalised(candidate);
+      ++result.evaluations;
+
+      // NaN fails both comparisons
+      if (candidate_fitness_value < result.fitness_value &&
+          candidate_fitness_value <= result.fitness_value + 1e-4 * arma::dot(gradient, candidate - agent))
+      {
+        is_accepted = true;
+        break;
+      }
+    }
+
+    if (!is_accepted)
+    {
+      break;
+    }
+
+    // The last affordable step is kept, without its gradient
+    if (!can_afford_gradient())
+    {
+      result.normalised_agent = candidate;
+      result.fitness_value = candidate_fitness_value;
+      break;
+    }
+
+    const arma::vec candidate_gradient = problem.normalised_gradient(candidate);
+    ++result.gradient_evaluations;
+    result.evaluations += gradient_cost;
+
+    // Pairs without positive curvature would make the update indefinite
+    const arma::vec step = candidate - agent;
+    const arma::vec gradient_difference = candidate_gradient - gradient;
+    const double curvature = arma::dot(step, gradient_difference);
+    if (curvature > 1e-10 * arma::dot(gradient_difference, gradient_difference))
+    {
+      newest = (newest + 1) % memory;
+      steps.col(newest) = step;
+      gradient_differences.col(newest) = gradient_difference;
+      inverse_curvatures(newest) = 1.0 / curvature;
+      stored = std::min(stored + 1, memory);
+    }
+
+    result.normalised_agent = candidate;
+    result.fitness_value = candidate_fitness_value;
+    gradient = candidate_gradient;
+  }
+}
+
+void pass::pattern_search(optimise_result &result, const double step_size,
+                          const arma::uword maximal_evaluations,
+                          const std::chrono::nanoseconds maximal_duration)
+{
+  const pass::problem &problem = result.problem;
+
+  pass::stopwatch stopwatch;
+  stopwatch.start();
+
+  const arma::uword first_evaluation = result.evaluations;
+
+  // Each neighbour changes a single coordinate. With delta evaluations, it
+  // is evaluated relative to the agent in `state`, e.g. in O(1) for separable
+  // problems. Otherwise, the neighbours are built and evaluated in batches of
+  // at most `batch_size`, so that a poll needs O(dimension) memory instead of
+  // O(dimension^2).
+  const bool is_delta = problem.has_delta_evaluation();
+  const arma::uword batch_size = 64;
+  const arma::uword number_of_directions = 2 * problem.dimension();
+  arma::mat neighbours(problem.dimension(), is_delta ? 0 : std::min(batch_size, number_of_directions));
+  arma::uvec batch_directions(neighbours.n_cols);
+  double step = step_size;
+
+  pass::problem::delta_state state;
+  if (is_delta)
+  {
+    if (result.evaluations - first_evaluation >= maximal_evaluations)
+    {
+      return;
+    }
+    problem.initialise_delta_state(result.normalised_agent % problem.bounds_range() + problem.lower_bounds, state);
+    ++result.evaluations;
+  }
+
+  // Direction 2k moves coordinate k down, direction 2k + 1 up. Neighbours
+  // beyond a bound are moved onto it, and skipped if the agent already lies
+  // there.
+  const auto neighbour_coordinate = [&](const arma::uword direction) {
+    return std::min(1.0, std::max(0.0, result.normalised_agent(direction / 2) +
+                                           (direction % 2 == 0 ? -step : step)));
+  };
+  const auto denormalised = [&](const arma::uword index, const double coordinate) {
+    return problem.lower_bounds(index) + coordinate * (problem.upper_bounds(index) - problem.lower_bounds(index));
+  };
+
+  while (step >= 1e-9 && stopwatch.get_elapsed() < maximal_duration && !result.solved())
+  {
+    arma::uword number_of_neighbours = 0;
+    for (arma::uword direction = 0; direction < number_of_directions; ++direction)
+    {
+      if (neighbour_coordinate(direction) != result.normalised_agent(direction / 2))
+      {
+        ++number_of_neighbours;
+      }
+    }
+
+    if (number_of_neighbours == 0 ||
+        result.evaluations - first_evaluation + number_of_neighbours > maximal_evaluations)
+    {
+      break;
+    }
+
+    arma::uword best_direction = number_of_directions;
+    double best_fitness_value = result.fitness_value;
+    if (is_delta)
+    {
+      for (arma::uword direction = 0; direction < number_of_directions; ++direction)
+      {
+        const arma::uword index = direction / 2;
+        const double coordinate = neighbour_coordinate(direction);
+        if (coordinate != result.normalised_agent(index))
+        {
+          const double fitness_value =
+              problem.evaluate_delta(state, arma::uvec({index}), arma::vec({denormalised(index, coordinate)}));
+          if (fitness_value < best_fitness_value)
+          {
+            best_direction = direction;
+            best_fitness_value = fitness_value;
+          }
+        }
+      }
+    }
+    else
+    {
+      for (arma::uword direction = 0; direction < number_of_directions;)
+      {
+        arma::uword batch_neighbours = 0;
+        for (; direction < number_of_directions && batch_neighbours < neighbours.n_cols; ++direction)
+        {
+          const double coordinate = neighbour_coordinate(direction);
+          if (coordinate != result.normalised_agent(direction / 2))
+          {
+            neighbours.col(batch_neighbours) = result.normalised_agent;
+            neighbours(direction / 2, batch_neighbours) = coordinate;
+            batch_directions(batch_neighbours) = direction;
+            ++batch_neighbours;
+          }
+        }
+
+        if (batch_neighbours == 0)
+        {
+          continue;
+        }
+
+        const arma::rowvec fitness_values = problem.evaluate_normalised_batch(neighbours.head_cols(batch_neighbours));
+        for (arma::uword n = 0; n < batch_neighbours; ++n)
+        {
+          if (fitness_values(n) < best_fitness_value)
+          {
+            best_direction = batch_directions(n);
+            best_fitness_value = fitness_values(n);
+          }
+        }
+      }
+    }
+    result.evaluations += number_of_neighbours;
+
+    if (best_direction < number_of_directions)
+    {
+      const arma::uword index = best_direction / 2;
+      const double coordinate = neighbour_coordinate(best_direction);
+      if (is_delta)
+      {
+        problem.update_delta_state(state, arma::uvec({index}), arma::vec({denormalised(index, coordinate)}));
+      }
+      result.normalised_agent(index) = coordinate;
+      result.fitness_value = best_fitness_value;
+    }
+    else
+    {
+      step *= 0.5;
+    }
+  }
+}
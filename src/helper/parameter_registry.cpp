@@ -0,0 +1,229 @@
+#include "pass_bits/helper/parameter_registry.hpp"
+#include "pass_bits/helper/profile_cache.hpp"
+#include "pass_bits/helper/regression.hpp"
+#include <algorithm> // std::lower_bound, std::copy_n
+#include <array>     // std::array
+#include <cmath>     // std::log
+#include <cstdio>    // std::rename
+#include <cstring>   // std::strncpy, std::memcmp
+#include <fstream>   // std::ifstream, std::ofstream
+#include <tuple>     // std::tie
+#include <vector>    // std::vector
+
+namespace
+{
+const char registry_magic[8] = {'P', 'A', 'S', 'S', 'R', 'E', 'G', '1'};
+
+/**
+ * One profile, as stored in the registry file.
+ */
+struct record
+{
+  std::array<char, 64> problem_name;
+  std::array<char, 64> optimiser_name;
+  std::array<char, 64> host;
+  arma::uword dimension;
+  std::array<double, pass::parameter_registry::parameters_per_profile> parameters;
+
+  bool operator<(const record &other) const
+  {
+    return std::tie(problem_name, optimiser_name, host, dimension) <
+           std::tie(other.problem_name, other.optimiser_name, other.host, other.dimension);
+  }
+
+  bool same_key(const record &other) const
+  {
+    return !(*this < other) && !(other < *this);
+  }
+};
+
+static_assert(sizeof(record) == 3 * 64 + sizeof(arma::uword) + pass::parameter_registry::parameters_per_profile * sizeof(double),
+              "The records of the registry must not contain padding");
+
+std::array<char, 64> to_key(const std::string &name)
+{
+  std::array<char, 64> key = {};
+  std::strncpy(key.data(), name.c_str(), key.size() - 1);
+  return key;
+}
+
+record make_record(const std::string &problem_name, const std::string &optimiser_name,
+                   const std::string &host, const arma::uword dimension)
+{
+  record profile = {};
+  profile.problem_name = to_key(problem_name);
+  profile.optimiser_name = to_key(optimiser_name);
+  profile.host = to_key(host);
+  profile.dimension = dimension;
+  return profile;
+}
+
+/**
+ * Returns all records of the registry file (sorted), or none if the file does
+ * not exist or is not a registry.
+ */
+std::vector<record> load_records(const std::string &file_name)
+{
+  std::ifstream file(file_name, std::ios::binary);
+
+  char magic[sizeof(registry_magic)];
+  arma::uword count = 0;
+
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, registry_magic, sizeof(magic)) != 0 ||
+      !file.read(reinterpret_cast<char *>(&count), sizeof(count)))
+  {
+    return {};
+  }
+
+  std::vector<record> records(count);
+  if (!file.read(reinterpret_cast<char *>(records.data()), count * sizeof(record)))
+  {
+    return {};
+  }
+
+  return records;
+}
+
+/**
+ * Writes the (sorted) `records` to a temporary file, which then replaces the
+ * registry file, so that readers never see a partially written registry.
+ */
+void save_records(const std::string &file_name, const std::vector<record> &records)
+{
+  const std::string temporary_file_name = file_name + ".tmp";
+
+  {
+    std::ofstream file(temporary_file_name, std::ios::binary | std::ios::trunc);
+    const arma::uword count = records.size();
+
+    file.write(registry_magic, sizeof(registry_magic));
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char *>(records.data()), count * sizeof(record));
+
+    if (!file)
+    {
+      throw std::runtime_error("parameter_registry: Could not write " + temporary_file_name);
+    }
+  }
+
+  if (std::rename(temporary_file_name.c_str(), file_name.c_str()) != 0)
+  {
+    throw std::runtime_error("parameter_registry: Could not replace " + file_name);
+  }
+}
+} // namespace
+
+constexpr arma::uword pass::parameter_registry::parameters_per_profile;
+
+pass::parameter_registry::parameter_registry()
+    : parameter_registry(pass::profile_directory() + "/parameter_registry.pass")
+{
+}
+
+pass::parameter_registry::parameter_registry(const std::string &file_name)
+    : file_name(file_name)
+{
+}
+
+void pass::parameter_registry::store(const std::string &problem_name, const std::string &optimiser_name,
+                                     const arma::uword dimension, const arma::vec &parameters) const
+{
+  assert(parameters.n_elem == parameters_per_profile && "`parameters` has incompatible dimension");
+
+  record profile = make_record(problem_name, optimiser_name, pass::host_name(), dimension);
+  std::copy_n(parameters.memptr(), parameters_per_profile, profile.parameters.begin());
+
+  std::vector<record> records = load_records(file_name);
+  auto position = std::lower_bound(records.begin(), records.end(), profile);
+
+  if (position != records.end() && position->same_key(profile))
+  {
+    *position = profile;
+  }
+  else
+  {
+    records.insert(position, profile);
+  }
+
+  save_records(file_name, records);
+}
+
+bool pass::parameter_registry::find(const std::string &problem_name, const std::string &optimiser_name,
+                                    const arma::uword dimension, arma::vec &parameters) const
+{
+  const record key = make_record(problem_name, optimiser_name, pass::host_name(), dimension);
+  const std::vector<record> records = load_records(file_name);
+  auto position = std::lower_bound(records.begin(), records.end(), key);
+
+  if (position == records.end() || !position->same_key(key))
+  {
+    return false;
+  }
+
+  parameters = arma::vec(position->parameters.data(), parameters_per_profile);
+  return true;
+}
+
+bool pass::parameter_registry::predict(const std::string &problem_name, const std::string &optimiser_name,
+                                       const arma::uword dimension, arma::vec &parameters) const
+{
+  if (find(problem_name, optimiser_name, dimension, parameters))
+  {
+    return true;
+  }
+
+  const std::array<char, 64> problem_key = to_key(problem_name);
+  const std::array<char, 64> optimiser_key = to_key(optimiser_name);
+  const std::array<char, 64> host_key = to_key(pass::host_name());
+
+  // The records are sorted, so all profiles of the problem and optimiser are adjacent
+  std::vector<record> records = load_records(file_name);
+  std::vector<record> same_host;
+  std::vector<record> all_hosts;
+
+  for (const record &profile : records)
+  {
+    if (profile.problem_name == problem_key && profile.optimiser_name == optimiser_key)
+    {
+      all_hosts.push_back(profile);
+      if (profile.host == host_key)
+      {
+        same_host.push_back(profile);
+      }
+    }
+  }
+
+  const std::vector<record> &profiles = same_host.empty() ? all_hosts : same_host;
+
+  if (profiles.empty())
+  {
+    return false;
+  }
+
+  arma::rowvec dimensions(profiles.size());
+  arma::mat values(parameters_per_profile, profiles.size());
+
+  for (arma::uword n = 0; n < profiles.size(); ++n)
+  {
+    dimensions(n) = std::log(static_cast<double>(profiles[n].dimension));
+    values.col(n) = arma::vec(profiles[n].parameters.data(), parameters_per_profile);
+  }
+
+  parameters.set_size(parameters_per_profile);
+
+  // A regression needs at least two different dimensions
+  if (arma::all(dimensions == dimensions(0)))
+  {
+    parameters = arma::mean(values, 1);
+    return true;
+  }
+
+  pass::regression regression;
+  for (arma::uword k = 0; k < parameters_per_profile; ++k)
+  {
+    const arma::rowvec model = regression.linear_model(dimensions, values.row(k));
+    parameters(k) = regression.predict_linear(std::log(static_cast<double>(dimension)), model.head(2));
+  }
+
+  return true;
+}
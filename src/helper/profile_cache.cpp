@@ -0,0 +1,49 @@
+#include "pass_bits/helper/profile_cache.hpp"
+#include <cstdlib>    // std::getenv
+#include <cerrno>     // errno
+#include <sys/stat.h> // mkdir
+#include <unistd.h>   // gethostname
+
+std::string pass::host_name()
+{
+  char name[256] = {};
+
+  if (gethostname(name, sizeof(name) - 1) != 0 || name[0] == '\0')
+  {
+    return "localhost";
+  }
+
+  return name;
+}
+
+std::string pass::profile_directory()
+{
+  std::string directory;
+
+  if (const char *environment = std::getenv("PASS_PROFILE_DIRECTORY"))
+  {
+    directory = environment;
+  }
+  else if (const char *home = std::getenv("HOME"))
+  {
+    directory = std::string(home) + "/.pass";
+  }
+
+  if (directory.empty())
+  {
+    return ".";
+  }
+
+  // An already existing directory is fine; anything else falls back to the current directory.
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+  {
+    return ".";
+  }
+
+  return directory;
+}
+
+std::string pass::profile_path(const std::string &name)
+{
+  return profile_directory() + "/" + name + "_" + host_name() + ".pass";
+}
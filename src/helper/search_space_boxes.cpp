@@ -0,0 +1,57 @@
+#include "pass_bits/helper/search_space_boxes.hpp"
+#include <algorithm> // std::upper_bound
+#include <stdexcept> // std::invalid_argument
+
+pass::search_space_boxes::search_space_boxes(const pass::problem &wrapped_problem,
+                                             const std::vector<search_box> &boxes)
+    : problem(arma::zeros<arma::vec>(wrapped_problem.dimension()),
+              arma::ones<arma::vec>(wrapped_problem.dimension()),
+              wrapped_problem.name + " (" + std::to_string(boxes.size()) + " boxes)"),
+      wrapped_problem(wrapped_problem),
+      boxes(boxes),
+      cumulative_volumes(boxes.size())
+{
+  if (boxes.empty())
+  {
+    throw std::invalid_argument("search_space_boxes: At least one box is required.");
+  }
+
+  double volume = 0.0;
+  for (arma::uword n = 0; n < boxes.size(); ++n)
+  {
+    if (boxes[n].lower_bounds.n_elem != dimension() ||
+        boxes[n].upper_bounds.n_elem != dimension() ||
+        arma::any(boxes[n].lower_bounds >= boxes[n].upper_bounds))
+    {
+      throw std::invalid_argument("search_space_boxes: Each box must match the dimension of the problem and have a volume.");
+    }
+
+    // Relative to the bounds of the wrapped problem, to avoid overflows
+    volume += arma::prod((boxes[n].upper_bounds - boxes[n].lower_bounds) / wrapped_problem.bounds_range());
+    cumulative_volumes(n) = volume;
+  }
+  cumulative_volumes /= volume;
+  cumulative_volumes(boxes.size() - 1) = 1.0;
+}
+
+double pass::search_space_boxes::evaluate(const arma::vec &agent) const
+{
+  return wrapped_problem.evaluate(wrapped_agent(agent));
+}
+
+arma::vec pass::search_space_boxes::wrapped_agent(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  const arma::uword box = std::min<arma::uword>(
+      boxes.size() - 1,
+      static_cast<arma::uword>(std::upper_bound(cumulative_volumes.begin(), cumulative_volumes.end(), agent(0)) -
+                               cumulative_volumes.begin()));
+  const double start = box > 0 ? cumulative_volumes(box - 1) : 0.0;
+
+  arma::vec position = agent;
+  position(0) = (agent(0) - start) / (cumulative_volumes(box) - start);
+
+  return boxes[box].lower_bounds + position % (boxes[box].upper_bounds - boxes[box].lower_bounds);
+}
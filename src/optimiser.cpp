@@ -8,6 +8,10 @@ pass::optimise_result::optimise_result(const pass::problem &problem, const doubl
       problem(problem),
       iterations(0),
       evaluations(0),
+      low_fidelity_evaluations(0),
+      screened_out_agents(0),
+      aborted_evaluations(0),
+      gradient_evaluations(0),
       duration(std::chrono::nanoseconds(0)) {}
 
 bool pass::optimise_result::solved() const
@@ -15,6 +19,15 @@ bool pass::optimise_result::solved() const
   return fitness_value <= acceptable_fitness_value;
 }
 
+double pass::optimise_result::screening_rate() const
+{
+  if (low_fidelity_evaluations == 0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(screened_out_agents) / static_cast<double>(low_fidelity_evaluations);
+}
+
 arma::vec pass::optimise_result::agent() const
 {
   return normalised_agent % problem.bounds_range() + problem.lower_bounds;
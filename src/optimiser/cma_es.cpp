@@ -0,0 +1,259 @@
+#include "pass_bits/optimiser/cma_es.hpp"
+#include <algorithm> // std::min, std::max
+#include <cmath>     // std::log, std::sqrt, std::exp, std::pow, std::fmod
+#include <deque>     // std::deque
+
+namespace
+{
+/**
+ * Mirrors `coordinate` at the bounds 0 and 1 until it lies within [0, 1].
+ */
+double mirror(const double coordinate)
+{
+  const double reflected = std::fmod(std::abs(coordinate), 2.0);
+  return reflected > 1.0 ? 2.0 - reflected : reflected;
+}
+} // namespace
+
+pass::cma_es::cma_es() noexcept
+    : optimiser("CMA_ES"),
+      population_size(0),
+      initial_step_size(0.3),
+      population_growth(2.0)
+#if defined(SUPPORT_MPI)
+      ,
+      communicator(MPI_COMM_WORLD)
+#endif
+#if defined(SUPPORT_OPENMP)
+      ,
+      number_threads(pass::number_of_threads())
+#endif
+{
+}
+
+pass::optimise_result pass::cma_es::optimise(const pass::problem &problem)
+{
+  assert((population_size == 0 || population_size >= 2) && "'population_size' should be 0 or greater or equal than 2");
+  assert(initial_step_size > 0.0 && "'initial_step_size' should be greater than 0.0");
+  assert(population_growth >= 1.0 && "'population_growth' should be greater or equal than 1.0");
+#if defined(SUPPORT_OPENMP)
+  assert(number_threads > 0 && "The number of threads should be greater than 0");
+#endif
+
+  pass::stopwatch stopwatch;
+  stopwatch.start();
+
+  pass::optimise_result result(problem, acceptable_fitness_value);
+
+  const arma::uword dimension = problem.dimension();
+  const double n = static_cast<double>(dimension);
+  // Expected norm of a normally distributed vector
+  const double expected_norm = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+  // The ranks evaluate consecutive blocks of each generation. Rank 0 samples
+  // the offspring and decides when to stop, so that all ranks stay in step,
+  // even if their clocks or floating point results differ.
+  arma::uword rank = 0;
+  arma::uword number_of_ranks = 1;
+#if defined(SUPPORT_MPI)
+  int mpi_rank;
+  int mpi_size;
+  MPI_Comm_rank(communicator, &mpi_rank);
+  MPI_Comm_size(communicator, &mpi_size);
+  rank = static_cast<arma::uword>(mpi_rank);
+  number_of_ranks = static_cast<arma::uword>(mpi_size);
+#endif
+
+  const auto is_terminated = [&](const bool is_converged) {
+    int terminate = is_converged || stopwatch.get_elapsed() >= maximal_duration ||
+                    result.iterations >= maximal_iterations || result.evaluations >= maximal_evaluations ||
+                    result.solved();
+#if defined(SUPPORT_MPI)
+    MPI_Bcast(&terminate, 1, MPI_INT, 0, communicator);
+#endif
+    return terminate != 0;
+  };
+
+  arma::uword offspring_count = population_size > 0
+                                    ? population_size
+                                    : 4 + static_cast<arma::uword>(std::floor(3.0 * std::log(n)));
+
+  // Each iteration is a run, with a larger population than the last one
+  while (!is_terminated(false))
+  {
+    // Strategy parameters, as recommended by Hansen
+    const arma::uword parents = offspring_count / 2;
+    arma::vec weights = std::log(static_cast<double>(parents) + 0.5) -
+                        arma::log(arma::linspace<arma::vec>(1.0, static_cast<double>(parents), parents));
+    weights /= arma::accu(weights);
+    const double effective_parents = 1.0 / arma::accu(arma::square(weights));
+
+    const double path_learning_rate = (4.0 + effective_parents / n) / (n + 4.0 + 2.0 * effective_parents / n);
+    const double step_size_learning_rate = (effective_parents + 2.0) / (n + effective_parents + 5.0);
+    const double rank_one_learning_rate = 2.0 / ((n + 1.3) * (n + 1.3) + effective_parents);
+    const double rank_mu_learning_rate = std::min(
+        1.0 - rank_one_learning_rate,
+        2.0 * (effective_parents - 2.0 + 1.0 / effective_parents) / ((n + 2.0) * (n + 2.0) + effective_parents));
+    const double step_size_damping = 1.0 + 2.0 * std::max(0.0, std::sqrt((effective_parents - 1.0) / (n + 1.0)) - 1.0) +
+                                     step_size_learning_rate;
+
+    // The decomposition costs O(n^3), so it is amortised over
+    // O(n / population) generations.
+    const arma::uword decomposition_stall = std::max<arma::uword>(
+        1, static_cast<arma::uword>(static_cast<double>(offspring_count) /
+                                    (10.0 * n * (rank_one_learning_rate + rank_mu_learning_rate))));
+    const arma::uword history_length = 10 + static_cast<arma::uword>(std::ceil(30.0 * n / static_cast<double>(offspring_count)));
+
+    // The state of the run
+    arma::vec mean = problem.normalised_random_agents(1);
+#if defined(SUPPORT_MPI)
+    MPI_Bcast(mean.memptr(), mean.n_elem, MPI_DOUBLE, 0, communicator);
+#endif
+    double step_size = initial_step_size;
+    arma::mat covariance(dimension, dimension, arma::fill::eye);
+    arma::mat eigenvectors(dimension, dimension, arma::fill::eye);
+    arma::vec deviations(dimension, arma::fill::ones);
+    // B * D and C^(-1/2), with the eigenvectors B and the square roots D of
+    // the eigenvalues of the covariance matrix C
+    arma::mat transformation(dimension, dimension, arma::fill::eye);
+    arma::mat inverse_square_root(dimension, dimension, arma::fill::eye);
+    arma::vec evolution_path(dimension, arma::fill::zeros);
+    arma::vec conjugate_evolution_path(dimension, arma::fill::zeros);
+    std::deque<double> best_fitness_values;
+    arma::uword generation = 0;
+    arma::uword last_decomposition = 0;
+
+    arma::mat offspring(dimension, offspring_count);
+    arma::rowvec fitness_values(offspring_count);
+
+    bool is_converged = false;
+    while (!is_terminated(is_converged))
+    {
+      // Sample all offspring with a single matrix product
+      if (rank == 0)
+      {
+        offspring = step_size * (transformation * arma::randn<arma::mat>(dimension, offspring_count));
+        offspring.each_col() += mean;
+        for (arma::uword i = 0; i < offspring.n_elem; ++i)
+        {
+          offspring(i) = mirror(offspring(i));
+        }
+      }
+#if defined(SUPPORT_MPI)
+      MPI_Bcast(offspring.memptr(), offspring.n_elem, MPI_DOUBLE, 0, communicator);
+#endif
+
+      // Evaluate the block of this rank, split into a batch per thread
+      fitness_values.zeros();
+      const arma::uword first_offspring = offspring_count * rank / number_of_ranks;
+      const arma::uword last_offspring = offspring_count * (rank + 1) / number_of_ranks;
+#if defined(SUPPORT_OPENMP)
+#pragma omp parallel proc_bind(close) num_threads(number_threads) if (number_threads > 1)
+#endif
+      {
+        arma::uword thread = 0;
+        arma::uword number_of_threads = 1;
+#if defined(SUPPORT_OPENMP)
+        thread = static_cast<arma::uword>(omp_get_thread_num());
+        number_of_threads = static_cast<arma::uword>(omp_get_num_threads());
+#endif
+        const arma::uword first = first_offspring + (last_offspring - first_offspring) * thread / number_of_threads;
+        const arma::uword last = first_offspring + (last_offspring - first_offspring) * (thread + 1) / number_of_threads;
+        if (last > first)
+        {
+          fitness_values.subvec(first, last - 1) = problem.evaluate_normalised_batch(offspring.cols(first, last - 1));
+        }
+      }
+#if defined(SUPPORT_MPI)
+      MPI_Allreduce(MPI_IN_PLACE, fitness_values.memptr(), fitness_values.n_elem, MPI_DOUBLE, MPI_SUM, communicator);
+#endif
+      fitness_values.replace(arma::datum::nan, arma::datum::inf);
+
+      ++result.iterations;
+      ++generation;
+      result.evaluations += offspring_count;
+
+      const arma::uvec ranking = arma::sort_index(fitness_values);
+      if (fitness_values(ranking(0)) < result.fitness_value)
+      {
+        result.normalised_agent = offspring.col(ranking(0));
+        result.fitness_value = fitness_values(ranking(0));
+      }
+
+      // The steps of the mirrored offspring, as they were evaluated
+      arma::mat selected_steps = offspring.cols(ranking.head(parents));
+      selected_steps.each_col() -= mean;
+      selected_steps /= step_size;
+      const arma::vec mean_step = selected_steps * weights;
+      mean += step_size * mean_step;
+
+      conjugate_evolution_path = (1.0 - step_size_learning_rate) * conjugate_evolution_path +
+                                 std::sqrt(step_size_learning_rate * (2.0 - step_size_learning_rate) * effective_parents) *
+                                     (inverse_square_root * mean_step);
+      const double conjugate_norm = arma::norm(conjugate_evolution_path);
+
+      // Stalls the evolution path while the step size grows quickly, so that
+      // the covariance doesn't grow too fast along it
+      const bool is_stalled = conjugate_norm / std::sqrt(1.0 - std::pow(1.0 - step_size_learning_rate, 2.0 * generation)) >=
+                              (1.4 + 2.0 / (n + 1.0)) * expected_norm;
+      evolution_path = (1.0 - path_learning_rate) * evolution_path;
+      if (!is_stalled)
+      {
+        evolution_path += std::sqrt(path_learning_rate * (2.0 - path_learning_rate) * effective_parents) * mean_step;
+      }
+
+      // Rank-one and rank-mu update; the latter is a single matrix product
+      const double stall_correction = is_stalled ? rank_one_learning_rate * path_learning_rate * (2.0 - path_learning_rate) : 0.0;
+      covariance = (1.0 - rank_one_learning_rate - rank_mu_learning_rate + stall_correction) * covariance +
+                   rank_one_learning_rate * (evolution_path * evolution_path.t()) +
+                   rank_mu_learning_rate * ((selected_steps.each_row() % weights.t()) * selected_steps.t());
+
+      step_size *= std::exp(step_size_learning_rate / step_size_damping * (conjugate_norm / expected_norm - 1.0));
+
+      if (generation - last_decomposition >= decomposition_stall)
+      {
+        last_decomposition = generation;
+        covariance = arma::symmatu(covariance);
+
+        arma::vec eigenvalues;
+        if (!arma::eig_sym(eigenvalues, eigenvectors, covariance) || !(eigenvalues.min() > 0.0))
+        {
+          is_converged = true;
+          continue;
+        }
+
+        deviations = arma::sqrt(eigenvalues);
+        transformation = eigenvectors * arma::diagmat(deviations);
+        inverse_square_root = eigenvectors * arma::diagmat(1.0 / deviations) * eigenvectors.t();
+      }
+
+      // Restart criteria
+      best_fitness_values.push_back(fitness_values(ranking(0)));
+      if (best_fitness_values.size() > history_length)
+      {
+        best_fitness_values.pop_front();
+      }
+      const auto history_range = std::minmax_element(best_fitness_values.begin(), best_fitness_values.end());
+      // The worst finite fitness value of this generation; infeasible
+      // offspring would otherwise prevent the restart.
+      arma::uword worst = offspring_count - 1;
+      while (worst > 0 && !std::isfinite(fitness_values(ranking(worst))))
+      {
+        --worst;
+      }
+
+      is_converged = !std::isfinite(step_size) ||
+                     step_size * std::sqrt(arma::max(covariance.diag())) < 1e-12 ||
+                     arma::max(deviations) > 1e7 * arma::min(deviations) ||
+                     (best_fitness_values.size() == history_length &&
+                      std::max(*history_range.second, fitness_values(ranking(worst))) -
+                              *history_range.first <
+                          1e-12);
+    }
+
+    offspring_count = static_cast<arma::uword>(std::ceil(population_growth * static_cast<double>(offspring_count)));
+  }
+
+  result.duration = stopwatch.get_elapsed();
+  return result;
+}
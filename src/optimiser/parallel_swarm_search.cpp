@@ -1,6 +1,123 @@
 #include "pass_bits/optimiser/parallel_swarm_search.hpp"
+#include "pass_bits/helper/local_search.hpp"
+#include "pass_bits/helper/parameter_registry.hpp"
 #include "pass_bits/helper/random.hpp"
-#include <cmath> // std::pow
+#include <algorithm> // std::min, std::max
+#include <cmath>     // std::pow, std::ceil, std::round, std::abs
+#include <vector>    // std::vector
+
+#if defined(SUPPORT_OPENMP)
+namespace
+{
+/**
+ * Returns the smallest number of threads that needs as many rounds as
+ * `threads` threads to process `swarm_size` particles, i.e. the number of
+ * threads without idle threads in the last round.
+ */
+int balanced_number_of_threads(const arma::uword swarm_size, const int threads)
+{
+  const arma::uword rounds = (swarm_size + threads - 1) / threads;
+  return static_cast<int>((swarm_size + rounds - 1) / rounds);
+}
+} // namespace
+#endif
+
+namespace
+{
+/**
+ * Draws the parameters of each particle (one particle per column of
+ * `particle_parameters`) around a randomly chosen entry of the success
+ * `history`. The rows are inertia, cognitive acceleration, social
+ * acceleration and neighbourhood probability.
+ *
+ * As in SHADE, the accelerations are Cauchy distributed and the other
+ * parameters normally distributed, with a scale of 0.1.
+ */
+void sample_particle_parameters(const arma::mat &history, arma::mat &particle_parameters)
+{
+  for (arma::uword n = 0; n < particle_parameters.n_cols; ++n)
+  {
+    const arma::uword entry = pass::random_integer_uniform_in_range(0, history.n_cols - 1);
+
+    particle_parameters(0, n) = std::min(1.0, std::max(-1.0, history(0, entry) + 0.1 * arma::arma_rng::randn<double>()));
+
+    for (arma::uword k = 1; k <= 2; ++k)
+    {
+      double acceleration;
+      do
+      {
+        acceleration = history(k, entry) + 0.1 * std::tan(arma::datum::pi * (arma::arma_rng::randu<double>() - 0.5));
+      } while (acceleration <= 0.0);
+
+      particle_parameters(k, n) = std::min(2.5, acceleration);
+    }
+
+    particle_parameters(3, n) = std::min(1.0, std::max(1e-3, history(3, entry) + 0.1 * arma::arma_rng::randn<double>()));
+  }
+}
+
+/**
+ * Stores the mean parameters of the particles that improved in the last
+ * iteration in the success history at `position`, weighted by their
+ * improvement, and advances `position`. The accelerations use the Lehmer
+ * mean, as in SHADE. Nothing happens if no particle improved.
+ */
+void update_parameter_history(const arma::mat &particle_parameters, const arma::rowvec &improvements,
+                              arma::mat &history, arma::uword &position)
+{
+  const double total_improvement = arma::accu(improvements);
+
+  if (!(total_improvement > 0.0) || !std::isfinite(total_improvement))
+  {
+    return;
+  }
+
+  for (arma::uword k = 0; k < history.n_rows; ++k)
+  {
+    double weighted_sum = 0.0;
+    double weighted_squared_sum = 0.0;
+
+    for (arma::uword n = 0; n < particle_parameters.n_cols; ++n)
+    {
+      const double weight = improvements(n) / total_improvement;
+      weighted_sum += weight * particle_parameters(k, n);
+      weighted_squared_sum += weight * particle_parameters(k, n) * particle_parameters(k, n);
+    }
+
+    history(k, position) = (k == 1 || k == 2) ? weighted_squared_sum / weighted_sum : weighted_sum;
+  }
+
+  position = (position + 1) % history.n_cols;
+}
+
+/**
+ * The coordinates `group` of `problem`, while all other coordinates are fixed
+ * to the agent of `context`. Evaluated by `problem::evaluate_delta`.
+ */
+class group_problem : public pass::problem
+{
+public:
+  group_problem(const pass::problem &problem, const pass::problem::delta_state &context,
+                const arma::uvec &group)
+      : pass::problem(problem.lower_bounds.elem(group), problem.upper_bounds.elem(group),
+                      problem.name + "_Group"),
+        full_problem(problem),
+        context(context),
+        group(group)
+  {
+  }
+
+  double evaluate(const arma::vec &agent) const override
+  {
+    return full_problem.evaluate_delta(context, group, agent);
+  }
+
+private:
+  const pass::problem &full_problem;
+  const pass::problem::delta_state &context;
+  const arma::uvec group;
+};
+} // namespace
 
 pass::parallel_swarm_search::parallel_swarm_search() noexcept
     : optimiser("Parallel_Swarm_Search"),
@@ -9,13 +126,23 @@ pass::parallel_swarm_search::parallel_swarm_search() noexcept
       cognitive_acceleration(0.5 + std::log(2.0)),
       social_acceleration(cognitive_acceleration),
       neighbourhood_probability(1.0 -
-                                std::pow(1.0 - 1.0 / static_cast<double>(swarm_size), 3.0))
+                                std::pow(1.0 - 1.0 / static_cast<double>(swarm_size), 3.0)),
+      self_adaptive(false),
+      multi_fidelity(false),
+      screening_tolerance(0.01),
+      coevolution_group_size(0),
+      coevolution_iterations(20),
+      polishing_stall(0),
+      polishing_candidates(1),
+      polishing_evaluations(1000)
 #if defined(SUPPORT_MPI)
       ,
-      migration_stall(0)
+      migration_stall(0),
+      communicator(MPI_COMM_WORLD)
 #endif
 #if defined(SUPPORT_OPENMP)
       ,
+      adaptive_parallelism(true),
       number_threads(pass::number_of_threads())
 #endif
 {
@@ -30,6 +157,8 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
   assert(neighbourhood_probability > 0.0 && neighbourhood_probability <= 1.0 &&
          "'neighbourhood_probability' should be a value between 0.0 and 1.0");
   assert(swarm_size > 0 && "Can't generate 0 agents");
+  assert(screening_tolerance >= 0.0 && "'screening_tolerance' should be greater or equal than 0.0");
+  assert(polishing_candidates > 0 && "'polishing_candidates' should be greater than 0");
 #if defined(SUPPORT_OPENMP)
   assert(number_threads > 0 && "The number of threads should be greater than 0");
 #endif
@@ -37,6 +166,12 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
   assert(migration_stall >= 0 && "The number of threads should be greater or equal than 0");
 #endif
 
+  if (coevolution_group_size > 0 && coevolution_group_size < problem.dimension() &&
+      problem.has_delta_evaluation())
+  {
+    return optimise_cooperatively(problem);
+  }
+
   // Variables used to analyse the behavior of a particle
   arma::mat verbose(maximal_iterations + 1, 3);
 
@@ -63,6 +198,80 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 
   double fitness_value;
 
+  // The parameters of each particle (one per column): inertia, cognitive
+  // acceleration, social acceleration and neighbourhood probability.
+  // Without `self_adaptive`, all particles use the parameters of the optimiser.
+  arma::mat particle_parameters(4, swarm_size);
+  for (arma::uword n = 0; n < swarm_size; ++n)
+  {
+    particle_parameters(0, n) = inertia;
+    particle_parameters(1, n) = cognitive_acceleration;
+    particle_parameters(2, n) = social_acceleration;
+    particle_parameters(3, n) = neighbourhood_probability;
+  }
+
+  // Success history of the self-adaptive mode, starting with the parameters of
+  // the optimiser. The improvement of each particle in the last iteration
+  // weights its parameters.
+  const arma::uword history_size = 5;
+  arma::mat parameter_history(4, history_size);
+  for (arma::uword entry = 0; entry < history_size; ++entry)
+  {
+    parameter_history.col(entry) = particle_parameters.col(0);
+  }
+  arma::uword history_position = 0;
+  arma::rowvec improvements(swarm_size, arma::fill::zeros);
+
+  // Particles whose low-fidelity value can't improve their personal best are
+  // marked here during an iteration and skip the exact evaluation.
+  // Screening only pays off while a low-fidelity evaluation costs less than
+  // the exact evaluations it saves per particle. Both are timed while
+  // screening, and it is turned off for the rest of the run once it doesn't.
+  bool screen_particles = multi_fidelity && problem.has_low_fidelity();
+  arma::uvec is_screened_out(swarm_size, arma::fill::zeros);
+  arma::rowvec low_fidelity_times(swarm_size, arma::fill::zeros);
+  arma::rowvec exact_times(swarm_size, arma::fill::zeros);
+  double low_fidelity_time = 0.0;
+  double exact_time = 0.0;
+  arma::uword screening_iterations = 0;
+
+  // Particles whose evaluation was aborted, as they couldn't improve their
+  // personal best
+  arma::uvec is_aborted(swarm_size, arma::fill::zeros);
+
+  // Particles whose personal best was polished and didn't change since; the
+  // swarm is polished after `polishing_stall` iterations without improvement.
+  arma::uvec is_polished(swarm_size, arma::fill::zeros);
+  double last_best_fitness_value = std::numeric_limits<double>::infinity();
+  arma::uword last_improvement_iteration = 0;
+
+#if defined(SUPPORT_OPENMP)
+  // The parallel execution is tuned at runtime, if `adaptive_parallelism` is set.
+  // The schedule of the calling thread is restored at the end.
+  omp_sched_t previous_schedule_kind;
+  int previous_schedule_chunk_size;
+  omp_get_schedule(&previous_schedule_kind, &previous_schedule_chunk_size);
+  omp_set_schedule(omp_sched_static, 0);
+
+  int active_threads = number_threads;
+
+  // Evaluation times of the initial swarm
+  arma::rowvec evaluation_times(swarm_size);
+
+  // Calibration of the number of threads, by halving it while the iterations get faster
+  bool calibrate_threads = adaptive_parallelism && number_threads > 1;
+  int calibrated_threads = active_threads;
+  double calibrated_iteration_time = std::numeric_limits<double>::infinity();
+  const arma::uword calibration_iterations = 3;
+  arma::rowvec iteration_times(calibration_iterations);
+  arma::uword iteration_count = 0;
+
+  if (adaptive_parallelism)
+  {
+    active_threads = balanced_number_of_threads(swarm_size, number_threads);
+  }
+#endif
+
   // Initialise the positions and the velocities
   // Particle data, stored column-wise.
 
@@ -84,14 +293,21 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 // Compute the fitness.
 // Begin with the previous best set to this initial position
 #if defined(SUPPORT_OPENMP)
-#pragma omp parallel proc_bind(close) num_threads(number_threads)
+#pragma omp parallel proc_bind(close) num_threads(active_threads) if (active_threads > 1)
   { //parallel region start
 #pragma omp for private(fitness_value) schedule(static)
 #endif
     for (arma::uword n = 0; n < swarm_size; ++n)
     {
+#if defined(SUPPORT_OPENMP)
+      pass::stopwatch evaluation_stopwatch;
+      evaluation_stopwatch.start();
+#endif
       fitness_value = problem.evaluate_normalised(positions.col(n));
       personal_best_fitness_values(n) = fitness_value;
+#if defined(SUPPORT_OPENMP)
+      evaluation_times(n) = evaluation_stopwatch.get_elapsed().count();
+#endif
 #if defined(SUPPORT_OPENMP)
 #pragma omp critical
       { // critical region start
@@ -110,6 +326,22 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 #endif
 
   ++result.iterations;
+  result.evaluations = swarm_size;
+
+#if defined(SUPPORT_OPENMP)
+  // Varying evaluation times (coefficient of variation above 0.5) would leave
+  // threads idle with equally sized chunks, so the particles are handed out
+  // one by one instead.
+  if (adaptive_parallelism && swarm_size > 1)
+  {
+    const double mean_evaluation_time = arma::mean(evaluation_times);
+
+    if (mean_evaluation_time > 0.0 && arma::stddev(evaluation_times) / mean_evaluation_time > 0.5)
+    {
+      omp_set_schedule(omp_sched_dynamic, 1);
+    }
+  }
+#endif
 
 // Island model for PSO
 // Synchronise MPI after the initialisation if the problem is immediately solved
@@ -120,29 +352,37 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
     int best_rank;
   } mpi;
 
-  mpi.best_rank = pass::node_rank();
-  mpi.fitness_value = result.fitness_value;
+  int island_rank;
+  int number_of_islands;
+  MPI_Comm_rank(communicator, &island_rank);
+  MPI_Comm_size(communicator, &number_of_islands);
 
-  /**
-      * All Reduce returns the minimum value of Fitness_value and the rank of the process that owns it.
-      */
-  MPI_Allreduce(MPI_IN_PLACE, &mpi, 2, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+  if (number_of_islands > 1)
+  {
+    mpi.best_rank = island_rank;
+    mpi.fitness_value = result.fitness_value;
 
-  /**
-      * The rank with the minimum Fitness_value broadcast his agent to the others
-      */
-  MPI_Bcast(result.normalised_agent.memptr(), result.normalised_agent.n_elem, MPI_DOUBLE, mpi.best_rank, MPI_COMM_WORLD);
+    /**
+        * All Reduce returns the minimum value of Fitness_value and the rank of the process that owns it.
+        */
+    MPI_Allreduce(MPI_IN_PLACE, &mpi, 2, MPI_DOUBLE_INT, MPI_MINLOC, communicator);
 
-  result.fitness_value = mpi.fitness_value;
+    /**
+        * The rank with the minimum Fitness_value broadcast his agent to the others
+        */
+    MPI_Bcast(result.normalised_agent.memptr(), result.normalised_agent.n_elem, MPI_DOUBLE, mpi.best_rank, communicator);
 
-  if (pass::node_rank() != mpi.best_rank)
-  {
-    // Find the worst agent and replace it with the best one
-    arma::uword min_index = personal_best_fitness_values.index_min();
+    result.fitness_value = mpi.fitness_value;
 
-    personal_best_positions.col(min_index) = result.normalised_agent;
-    positions.col(min_index) = result.normalised_agent;
-    personal_best_fitness_values(min_index) = result.fitness_value;
+    if (island_rank != mpi.best_rank)
+    {
+      // Find the worst agent and replace it with the best one
+      arma::uword min_index = personal_best_fitness_values.index_min();
+
+      personal_best_positions.col(min_index) = result.normalised_agent;
+      positions.col(min_index) = result.normalised_agent;
+      personal_best_fitness_values(min_index) = result.fitness_value;
+    }
   }
 #endif
 
@@ -176,13 +416,32 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
   while (stopwatch.get_elapsed() < maximal_duration &&
          result.iterations < maximal_iterations && result.evaluations < maximal_evaluations && !result.solved())
   {
+    if (self_adaptive)
+    {
+      sample_particle_parameters(parameter_history, particle_parameters);
+    }
+
     if (randomize_topology)
     {
-      topology = (arma::mat(swarm_size, swarm_size,
-                            arma::fill::randu) < neighbourhood_probability);
-      // When searching for the best neighbour, we begin with the particles
-      // personal best value; We don't need to visit it twice.
-      topology.diag().fill(0);
+      if (self_adaptive)
+      {
+        // Each particle informs itself with its own neighbourhood probability
+        for (arma::uword i = 0; i < swarm_size; ++i)
+        {
+          for (arma::uword n = 0; n < swarm_size; ++n)
+          {
+            topology(n, i) = n != i && arma::arma_rng::randu<double>() < particle_parameters(3, n);
+          }
+        }
+      }
+      else
+      {
+        topology = (arma::mat(swarm_size, swarm_size,
+                              arma::fill::randu) < neighbourhood_probability);
+        // When searching for the best neighbour, we begin with the particles
+        // personal best value; We don't need to visit it twice.
+        topology.diag().fill(0);
+      }
     }
     randomize_topology = true;
 
@@ -192,9 +451,12 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 #endif
 
 #if defined(SUPPORT_OPENMP)
-#pragma omp parallel proc_bind(close) num_threads(number_threads)
+      pass::stopwatch iteration_stopwatch;
+      iteration_stopwatch.start();
+
+#pragma omp parallel proc_bind(close) num_threads(active_threads) if (active_threads > 1)
       { //parallel region start
-#pragma omp for private(local_best_position, local_best_fitness_value, attraction_center, weighted_personal_attraction, weighted_local_attraction, fitness_value) firstprivate(topology) schedule(static)
+#pragma omp for private(local_best_position, local_best_fitness_value, attraction_center, weighted_personal_attraction, weighted_local_attraction, fitness_value) firstprivate(topology) schedule(runtime)
 #endif
 
         // iterate over the particles
@@ -216,12 +478,12 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 
           //p_i
           weighted_personal_attraction = positions.col(n) +
-                                         random_double_uniform_in_range(0.0, cognitive_acceleration) *
+                                         random_double_uniform_in_range(0.0, particle_parameters(1, n)) *
                                              (personal_best_positions.col(n) - positions.col(n));
 
           // l_i
           weighted_local_attraction = positions.col(n) +
-                                      random_double_uniform_in_range(0.0, social_acceleration) *
+                                      random_double_uniform_in_range(0.0, particle_parameters(2, n)) *
                                           (local_best_position - positions.col(n));
 
           // If the best informant is the particle itself, define the gravity center G as the middle of x-p'
@@ -234,7 +496,7 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
             attraction_center = (positions.col(n) + weighted_personal_attraction + weighted_local_attraction) / 3.0;
           }
 
-          velocities.col(n) = inertia * velocities.col(n) +
+          velocities.col(n) = particle_parameters(0, n) * velocities.col(n) +
                               random_neighbour(attraction_center, 0.0, arma::norm(attraction_center - positions.col(n))) -
                               positions.col(n);
 
@@ -256,13 +518,42 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
             }
           }
 
-          // evaluate the new position
-          fitness_value = problem.evaluate_normalised(positions.col(n));
+          // screen the new position with the low fidelity
+          pass::stopwatch evaluation_stopwatch;
+          if (screen_particles)
+          {
+            evaluation_stopwatch.start();
+            const double approximated_fitness_value = problem.evaluate_normalised_low_fidelity(positions.col(n));
+            low_fidelity_times(n) = evaluation_stopwatch.get_elapsed().count();
+            const double personal_best_fitness_value = personal_best_fitness_values(n);
+
+            // NaN can't improve anything either
+            if (!(approximated_fitness_value <
+                  personal_best_fitness_value + screening_tolerance * std::abs(personal_best_fitness_value)))
+            {
+              is_screened_out(n) = 1;
+              continue;
+            }
+
+            evaluation_stopwatch.start();
+          }
+
+          // evaluate the new position; the problem may stop early once
+          // it can't improve the personal best
+          bool is_aborted_evaluation;
+          fitness_value = problem.evaluate_normalised(positions.col(n), personal_best_fitness_values(n), is_aborted_evaluation);
+          is_aborted(n) = is_aborted_evaluation;
+          if (screen_particles)
+          {
+            exact_times(n) = evaluation_stopwatch.get_elapsed().count();
+          }
 
           if (fitness_value < personal_best_fitness_values(n))
           {
+            improvements(n) = personal_best_fitness_values(n) - fitness_value;
             personal_best_positions.col(n) = positions.col(n);
             personal_best_fitness_values(n) = fitness_value;
+            is_polished(n) = 0;
 
 #if defined(SUPPORT_OPENMP)
 #pragma omp critical
@@ -282,10 +573,71 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
         }
 #if defined(SUPPORT_OPENMP)
       } //parallel region end
+
+      if (calibrate_threads)
+      {
+        iteration_times(iteration_count++) = iteration_stopwatch.get_elapsed().count();
+
+        if (iteration_count == calibration_iterations)
+        {
+          iteration_count = 0;
+          const double iteration_time = arma::median(iteration_times);
+
+          // Keep halving the number of threads while it pays off noticeably
+          if (iteration_time < 0.95 * calibrated_iteration_time)
+          {
+            calibrated_threads = active_threads;
+            calibrated_iteration_time = iteration_time;
+          }
+
+          if (calibrated_threads == active_threads && active_threads > 1)
+          {
+            active_threads = balanced_number_of_threads(swarm_size, (active_threads + 1) / 2);
+          }
+          else
+          {
+            active_threads = calibrated_threads;
+            calibrate_threads = false;
+          }
+        }
+      }
 #endif
 
+      if (self_adaptive)
+      {
+        update_parameter_history(particle_parameters, improvements, parameter_history, history_position);
+        improvements.zeros();
+      }
+
       ++result.iterations;
-      result.evaluations = result.iterations * swarm_size;
+
+      const arma::uword screened_out_particles = arma::accu(is_screened_out);
+      result.evaluations += swarm_size - screened_out_particles;
+      result.aborted_evaluations += arma::accu(is_aborted);
+      is_aborted.zeros();
+      if (screen_particles)
+      {
+        result.low_fidelity_evaluations += swarm_size;
+        result.screened_out_agents += screened_out_particles;
+        is_screened_out.zeros();
+
+        low_fidelity_time += arma::accu(low_fidelity_times);
+        exact_time += arma::accu(exact_times);
+        exact_times.zeros();
+        ++screening_iterations;
+
+        // Screening saves `screening_rate * exact_cost` per particle at the
+        // price of `low_fidelity_cost`. The first few iterations only
+        // gather timings, as single ones are too noisy.
+        const arma::uword exact_evaluations = result.low_fidelity_evaluations - result.screened_out_agents;
+        if (screening_iterations >= 5 && exact_evaluations > 0)
+        {
+          const double low_fidelity_cost = low_fidelity_time / result.low_fidelity_evaluations;
+          const double exact_cost = exact_time / exact_evaluations;
+          const double screening_rate = static_cast<double>(result.screened_out_agents) / result.low_fidelity_evaluations;
+          screen_particles = low_fidelity_cost < screening_rate * exact_cost;
+        }
+      }
 
 #if defined(SUPPORT_MPI)
       if (stopwatch.get_elapsed() > maximal_duration ||
@@ -298,31 +650,103 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 
 #if defined(SUPPORT_MPI)
     // Island model for PSO
-    mpi.best_rank = pass::node_rank();
-    mpi.fitness_value = result.fitness_value;
+    if (number_of_islands > 1)
+    {
+      mpi.best_rank = island_rank;
+      mpi.fitness_value = result.fitness_value;
 
-    /**
-      * All Reduce returns the minimum value of Fitness_value and the rank of the process that owns it.
-      */
-    MPI_Allreduce(MPI_IN_PLACE, &mpi, 2, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+      /**
+        * All Reduce returns the minimum value of Fitness_value and the rank of the process that owns it.
+        */
+      MPI_Allreduce(MPI_IN_PLACE, &mpi, 2, MPI_DOUBLE_INT, MPI_MINLOC, communicator);
 
-    /**
-      * The rank with the minimum Fitness_value broadcast his agent to the others
-      */
-    MPI_Bcast(result.normalised_agent.memptr(), result.normalised_agent.n_elem, MPI_DOUBLE, mpi.best_rank, MPI_COMM_WORLD);
+      /**
+        * The rank with the minimum Fitness_value broadcast his agent to the others
+        */
+      MPI_Bcast(result.normalised_agent.memptr(), result.normalised_agent.n_elem, MPI_DOUBLE, mpi.best_rank, communicator);
 
-    result.fitness_value = mpi.fitness_value;
+      result.fitness_value = mpi.fitness_value;
 
-    if (pass::node_rank() != mpi.best_rank)
-    {
-      // Find the worst agent and replace it with the best one
-      arma::uword min_index = personal_best_fitness_values.index_min();
+      if (island_rank != mpi.best_rank)
+      {
+        // Find the worst agent and replace it with the best one
+        arma::uword min_index = personal_best_fitness_values.index_min();
 
-      personal_best_positions.col(min_index) = result.normalised_agent;
-      positions.col(min_index) = result.normalised_agent;
-      personal_best_fitness_values(min_index) = result.fitness_value;
+        personal_best_positions.col(min_index) = result.normalised_agent;
+        positions.col(min_index) = result.normalised_agent;
+        personal_best_fitness_values(min_index) = result.fitness_value;
+      }
+    }
+#endif
+
+    if (result.fitness_value < last_best_fitness_value)
+    {
+      last_best_fitness_value = result.fitness_value;
+      last_improvement_iteration = result.iterations;
     }
+
+    // Polish the best personal bests once the swarm stagnates
+    if (polishing_stall > 0 && result.iterations - last_improvement_iteration >= polishing_stall &&
+        stopwatch.get_elapsed() < maximal_duration && result.evaluations < maximal_evaluations &&
+        !result.solved())
+    {
+      const arma::uvec ranking = arma::sort_index(personal_best_fitness_values);
+      std::vector<arma::uword> particles;
+      std::vector<pass::optimise_result> candidates;
+      for (arma::uword i = 0; i < swarm_size && particles.size() < polishing_candidates; ++i)
+      {
+        const arma::uword n = ranking(i);
+        if (!is_polished(n) && std::isfinite(personal_best_fitness_values(n)))
+        {
+          particles.push_back(n);
+          candidates.emplace_back(problem, acceptable_fitness_value);
+          candidates.back().normalised_agent = personal_best_positions.col(n);
+          candidates.back().fitness_value = personal_best_fitness_values(n);
+        }
+      }
+
+      // Within the basin the swarm converged to, its spread is the scale of
+      // the first steps.
+      const double step_size = std::min(0.1, std::max(1e-6, arma::mean(arma::stddev(personal_best_positions, 0, 1))));
+      const arma::uword candidate_evaluations = std::min(
+          polishing_evaluations,
+          std::max<arma::uword>(1, (maximal_evaluations - result.evaluations) / std::max<arma::uword>(1, candidates.size())));
+      const std::chrono::nanoseconds remaining_duration = maximal_duration - stopwatch.get_elapsed();
+
+#if defined(SUPPORT_OPENMP)
+      const int polishing_threads = std::min(active_threads, static_cast<int>(candidates.size()));
+#pragma omp parallel for num_threads(polishing_threads) schedule(dynamic, 1) if (polishing_threads > 1)
 #endif
+      for (arma::uword i = 0; i < candidates.size(); ++i)
+      {
+        if (problem.has_gradient())
+        {
+          pass::bounded_lbfgs(candidates[i], candidate_evaluations, remaining_duration);
+        }
+        else
+        {
+          pass::pattern_search(candidates[i], step_size, candidate_evaluations, remaining_duration);
+        }
+      }
+
+      for (arma::uword i = 0; i < candidates.size(); ++i)
+      {
+        const arma::uword n = particles[i];
+        personal_best_positions.col(n) = candidates[i].normalised_agent;
+        personal_best_fitness_values(n) = candidates[i].fitness_value;
+        is_polished(n) = 1;
+
+        result.evaluations += candidates[i].evaluations;
+        result.gradient_evaluations += candidates[i].gradient_evaluations;
+        if (candidates[i].fitness_value < result.fitness_value)
+        {
+          result.normalised_agent = candidates[i].normalised_agent;
+          result.fitness_value = candidates[i].fitness_value;
+        }
+      }
+
+      last_improvement_iteration = result.iterations;
+    }
 
     /*
      * +------------+---------------+----------+
@@ -342,6 +766,10 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 
   result.duration = stopwatch.get_elapsed();
 
+#if defined(SUPPORT_OPENMP)
+  omp_set_schedule(previous_schedule_kind, previous_schedule_chunk_size);
+#endif
+
   // Save the file
   if (pass::is_verbose)
   {
@@ -354,3 +782,165 @@ pass::optimise_result pass::parallel_swarm_search::optimise(
 
   return result;
 }
+
+pass::optimise_result pass::parallel_swarm_search::optimise_cooperatively(
+    const pass::problem &problem)
+{
+  assert(coevolution_iterations > 0 && "'coevolution_iterations' should be greater than 0");
+
+  pass::stopwatch stopwatch;
+  stopwatch.start();
+
+  pass::optimise_result result(problem, acceptable_fitness_value);
+
+  // The ranks share the context and optimise different groups at the same
+  // time. Rank 0 draws the random numbers and decides when to stop, so that
+  // all ranks stay in step.
+  arma::uword rank = 0;
+  arma::uword number_of_ranks = 1;
+#if defined(SUPPORT_MPI)
+  int mpi_rank;
+  int mpi_size;
+  MPI_Comm_rank(communicator, &mpi_rank);
+  MPI_Comm_size(communicator, &mpi_size);
+  rank = static_cast<arma::uword>(mpi_rank);
+  number_of_ranks = static_cast<arma::uword>(mpi_size);
+#endif
+
+  const auto is_terminated = [&]() {
+    int terminate = stopwatch.get_elapsed() >= maximal_duration || result.iterations >= maximal_iterations ||
+                    result.evaluations >= maximal_evaluations || result.solved();
+#if defined(SUPPORT_MPI)
+    MPI_Bcast(&terminate, 1, MPI_INT, 0, communicator);
+#endif
+    return terminate != 0;
+  };
+
+  // The context: the best agent found so far, with its partial results
+  result.normalised_agent = problem.normalised_random_agents(1);
+#if defined(SUPPORT_MPI)
+  MPI_Bcast(result.normalised_agent.memptr(), result.normalised_agent.n_elem, MPI_DOUBLE, 0, communicator);
+#endif
+  pass::problem::delta_state context;
+  result.fitness_value = problem.initialise_delta_state(
+      result.normalised_agent % problem.bounds_range() + problem.lower_bounds, context);
+  ++result.iterations;
+  result.evaluations = 1;
+
+  // Each group is optimised by a copy of this optimiser
+  pass::parallel_swarm_search group_optimiser = *this;
+  group_optimiser.coevolution_group_size = 0;
+#if defined(SUPPORT_MPI)
+  group_optimiser.communicator = MPI_COMM_SELF;
+#endif
+
+  // Each round optimises one group per rank. Column r holds the normalised
+  // group agent found by rank r, followed by its fitness value (infinite if
+  // it didn't improve the context).
+  arma::mat round_agents(coevolution_group_size + 1, number_of_ranks);
+  // The iterations and evaluations of all ranks in a round
+  arma::vec round_costs(2);
+
+  while (!is_terminated())
+  {
+    arma::uvec dimensions = arma::randperm(problem.dimension());
+#if defined(SUPPORT_MPI)
+    MPI_Bcast(dimensions.memptr(), dimensions.n_elem * sizeof(arma::uword), MPI_BYTE, 0, communicator);
+#endif
+
+    for (arma::uword first_of_round = 0; first_of_round < problem.dimension();
+         first_of_round += number_of_ranks * coevolution_group_size)
+    {
+      if (is_terminated())
+      {
+        break;
+      }
+
+      round_agents.row(coevolution_group_size).fill(arma::datum::inf);
+      round_costs.zeros();
+
+      const arma::uword first = first_of_round + rank * coevolution_group_size;
+      if (first < problem.dimension())
+      {
+        const arma::uvec group = dimensions.subvec(
+            first, std::min(first + coevolution_group_size, problem.dimension()) - 1);
+        const group_problem subproblem(problem, context, group);
+
+        // The remaining evaluations are shared by the ranks of this round
+        group_optimiser.maximal_iterations = std::min(coevolution_iterations, maximal_iterations - result.iterations);
+        group_optimiser.maximal_evaluations =
+            std::max<arma::uword>(1, (maximal_evaluations - result.evaluations) / number_of_ranks);
+        group_optimiser.maximal_duration = maximal_duration - stopwatch.get_elapsed();
+
+        const pass::optimise_result group_result = group_optimiser.optimise(subproblem);
+        round_costs(0) = static_cast<double>(group_result.iterations);
+        round_costs(1) = static_cast<double>(group_result.evaluations);
+
+        if (group_result.fitness_value < result.fitness_value)
+        {
+          round_agents.col(rank).head(group.n_elem) = group_result.normalised_agent;
+          round_agents(coevolution_group_size, rank) = group_result.fitness_value;
+        }
+      }
+
+#if defined(SUPPORT_MPI)
+      MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, round_agents.memptr(), round_agents.n_rows, MPI_DOUBLE,
+                    communicator);
+      MPI_Allreduce(MPI_IN_PLACE, round_costs.memptr(), round_costs.n_elem, MPI_DOUBLE, MPI_SUM, communicator);
+#endif
+      result.iterations += static_cast<arma::uword>(round_costs(0));
+      result.evaluations += static_cast<arma::uword>(round_costs(1));
+
+      // The groups were optimised against the same context, so each
+      // improvement is only kept if it still improves the context with the
+      // improvements of the previous ranks. All ranks apply them in the same
+      // order and end up with the same context.
+      for (arma::uword r = 0; r < number_of_ranks; ++r)
+      {
+        const arma::uword first_of_rank = first_of_round + r * coevolution_group_size;
+        if (first_of_rank >= problem.dimension() || !(round_agents(coevolution_group_size, r) < result.fitness_value))
+        {
+          continue;
+        }
+
+        const arma::uvec group = dimensions.subvec(
+            first_of_rank, std::min(first_of_rank + coevolution_group_size, problem.dimension()) - 1);
+        const arma::vec normalised_group_agent = round_agents.col(r).head(group.n_elem);
+        const arma::vec group_agent =
+            normalised_group_agent % (problem.upper_bounds.elem(group) - problem.lower_bounds.elem(group)) +
+            problem.lower_bounds.elem(group);
+
+        // Checked in O(group size), without copying the context or the bounds
+        if (problem.evaluate_delta(context, group, group_agent) < result.fitness_value)
+        {
+          problem.update_delta_state(context, group, group_agent);
+          result.normalised_agent.elem(group) = normalised_group_agent;
+          result.fitness_value = context.fitness_value;
+        }
+      }
+    }
+  }
+
+  result.duration = stopwatch.get_elapsed();
+  return result;
+}
+
+bool pass::parallel_swarm_search::load_profile(const pass::problem &problem)
+{
+  arma::vec parameters;
+
+  if (!pass::parameter_registry().predict(problem.name, name, problem.dimension(), parameters))
+  {
+    return false;
+  }
+
+  // Predictions may leave the valid ranges. The accelerations stay positive,
+  // as the velocity update draws from [0, acceleration).
+  swarm_size = static_cast<arma::uword>(std::max(1.0, std::round(parameters(0))));
+  neighbourhood_probability = std::min(1.0, std::max(1e-6, parameters(1)));
+  inertia = std::min(1.0, std::max(-1.0, parameters(2)));
+  cognitive_acceleration = std::max(1e-3, parameters(3));
+  social_acceleration = std::max(1e-3, parameters(4));
+
+  return true;
+}
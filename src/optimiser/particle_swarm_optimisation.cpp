@@ -47,16 +47,16 @@ pass::optimise_result pass::particle_swarm_optimisation::optimise(
 
   // Memory containing the previous/personal best and its fitness value
   arma::mat personal_best_positions = positions;
-  arma::rowvec personal_best_fitness_values(swarm_size);
+  arma::rowvec personal_best_fitness_values;
 
   // Evaluate the initial positions.
   // Compute the fitness.
   // Begin with the previous best set to this initial position
+  personal_best_fitness_values = problem.evaluate_normalised_batch(positions);
   for (arma::uword n = 0; n < swarm_size; ++n)
   {
-    const double fitness_value = problem.evaluate_normalised(positions.col(n));
+    const double fitness_value = personal_best_fitness_values(n);
     ++result.evaluations;
-    personal_best_fitness_values(n) = fitness_value;
 
     if (fitness_value <= result.fitness_value)
     {
@@ -168,9 +168,15 @@ pass::optimise_result pass::particle_swarm_optimisation::optimise(
         }
       }
 
-      // evaluate the new position
-      const double fitness_value = problem.evaluate_normalised(positions.col(n));
+      // evaluate the new position; the problem may stop early once it can't
+      // improve the personal best
+      bool is_aborted;
+      const double fitness_value = problem.evaluate_normalised(positions.col(n), personal_best_fitness_values(n), is_aborted);
       ++result.evaluations;
+      if (is_aborted)
+      {
+        ++result.aborted_evaluations;
+      }
 
       if (fitness_value < personal_best_fitness_values(n))
       {
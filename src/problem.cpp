@@ -1,6 +1,7 @@
 #include "pass_bits/problem.hpp"
 #include "pass_bits/helper/random.hpp"
 #include "pass_bits/helper/prime_numbers.hpp"
+#include <limits> // std::numeric_limits
 
 arma::vec pass::problem::bounds_range() const noexcept
 {
@@ -36,11 +37,120 @@ pass::problem::problem(const arma::vec &lower_bounds,
          "each dimension");
 }
 
+double pass::problem::evaluate(const arma::vec &agent, const double, bool &is_aborted) const
+{
+  is_aborted = false;
+  return evaluate(agent);
+}
+
+arma::rowvec pass::problem::evaluate_batch(const arma::mat &agents) const
+{
+  arma::rowvec fitness_values(agents.n_cols);
+  for (arma::uword n = 0; n < agents.n_cols; ++n)
+  {
+    fitness_values(n) = evaluate(agents.col(n));
+  }
+  return fitness_values;
+}
+
+bool pass::problem::has_low_fidelity() const
+{
+  return false;
+}
+
+double pass::problem::evaluate_low_fidelity(const arma::vec &agent) const
+{
+  return evaluate(agent);
+}
+
+bool pass::problem::has_delta_evaluation() const
+{
+  return false;
+}
+
+double pass::problem::initialise_delta_state(const arma::vec &agent, delta_state &state) const
+{
+  state.agent = agent;
+  state.fitness_value = evaluate(agent);
+  state.partial_results.reset();
+  state.updates = 0;
+  return state.fitness_value;
+}
+
+double pass::problem::evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                     const arma::vec &new_values) const
+{
+  arma::vec agent = state.agent;
+  agent.elem(changed_indices) = new_values;
+  return evaluate(agent);
+}
+
+void pass::problem::update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                       const arma::vec &new_values) const
+{
+  state.agent.elem(changed_indices) = new_values;
+  state.fitness_value = evaluate(state.agent);
+}
+
+bool pass::problem::has_gradient() const
+{
+  return false;
+}
+
+arma::vec pass::problem::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  arma::vec shifted_agent = agent;
+
+  for (arma::uword n = 0; n < dimension(); ++n)
+  {
+    // The cube root of the machine epsilon balances the truncation and the
+    // rounding errors of central differences.
+    const double step = std::cbrt(std::numeric_limits<double>::epsilon()) * std::max(1.0, std::abs(agent(n)));
+
+    shifted_agent(n) = agent(n) + step;
+    const double forward_value = evaluate(shifted_agent);
+    shifted_agent(n) = agent(n) - step;
+    const double backward_value = evaluate(shifted_agent);
+    shifted_agent(n) = agent(n);
+
+    gradient(n) = (forward_value - backward_value) / (2.0 * step);
+  }
+
+  return gradient;
+}
+
 double pass::problem::evaluate_normalised(const arma::vec &normalised_agent) const
 {
   return evaluate(normalised_agent % bounds_range() + lower_bounds);
 }
 
+double pass::problem::evaluate_normalised(const arma::vec &normalised_agent, const double cutoff,
+                                          bool &is_aborted) const
+{
+  return evaluate(normalised_agent % bounds_range() + lower_bounds, cutoff, is_aborted);
+}
+
+arma::rowvec pass::problem::evaluate_normalised_batch(const arma::mat &normalised_agents) const
+{
+  arma::mat agents = normalised_agents.each_col() % bounds_range();
+  agents.each_col() += lower_bounds;
+  return evaluate_batch(agents);
+}
+
+double pass::problem::evaluate_normalised_low_fidelity(const arma::vec &normalised_agent) const
+{
+  return evaluate_low_fidelity(normalised_agent % bounds_range() + lower_bounds);
+}
+
+arma::vec pass::problem::normalised_gradient(const arma::vec &normalised_agent) const
+{
+  return gradient(normalised_agent % bounds_range() + lower_bounds) % bounds_range();
+}
+
 arma::mat pass::problem::normalised_random_agents(const arma::uword count) const
 {
   assert(count >= 1 && "Can't generate 0 agents");
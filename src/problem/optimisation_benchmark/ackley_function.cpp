@@ -1,4 +1,32 @@
 #include "pass_bits/problem/optimisation_benchmark/ackley_function.hpp"
+#include "pass_bits/helper/dual.hpp"
+
+namespace
+{
+/**
+ * The Ackley function of the `dimension` coordinates of `agent`, for any
+ * scalar type (see `pass::dual`).
+ */
+template <typename T>
+T ackley(const T *agent, const arma::uword dimension)
+{
+  using std::cos;
+  using std::exp;
+  using std::sqrt;
+
+  T sum_of_squares = 0.0;
+  T sum_of_cosines = 0.0;
+  for (arma::uword n = 0; n < dimension; ++n)
+  {
+    sum_of_squares += agent[n] * agent[n];
+    sum_of_cosines += cos(2.0 * arma::datum::pi * agent[n]);
+  }
+
+  return -20.0 * exp(-0.2 * sqrt(1.0 / dimension * sum_of_squares)) -
+         exp(1.0 / dimension * sum_of_cosines) +
+         20.0 + std::exp(1.0);
+}
+} // namespace
 
 pass::ackley_function::ackley_function(const arma::uword dimension)
     : problem(dimension, -32.768, 32.768, "Ackley_Function") {}
@@ -7,13 +35,21 @@ double pass::ackley_function::evaluate(const arma::vec &agent) const
 {
   assert(agent.n_elem == dimension() &&
          "`agent` has incompatible dimension");
-  return -20.0 * std::exp(-0.2 * std::sqrt(1.0 / dimension() *
-                                           arma::sum(agent % agent))) -
-         std::exp(1.0 / dimension() *
-                  std::accumulate(
-                      agent.cbegin(), agent.cend(), 0.0,
-                      [](const double sum, const double element) {
-                        return sum + std::cos(2.0 * arma::datum::pi * element);
-                      })) +
-         20.0 + std::exp(1.0);
+  return ackley(agent.memptr(), dimension());
+}
+
+bool pass::ackley_function::has_gradient() const
+{
+  return true;
+}
+
+arma::vec pass::ackley_function::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  forward_gradient([this](const gradient_dual *x) { return ackley(x, dimension()); },
+                   agent.memptr(), dimension(), gradient.memptr());
+  return gradient;
 }
@@ -1,14 +1,26 @@
 #include "pass_bits/problem/optimisation_benchmark/de_jong_function.hpp"
 
+namespace
+{
+/**
+ * The term of a coordinate, for any scalar type (see `pass::dual`).
+ */
+template <typename T>
+T de_jong_term(const T &value)
+{
+  return value * value;
+}
+} // namespace
+
 pass::de_jong_function::de_jong_function(const arma::uword dimension)
-    : problem(dimension, -5.12, 5.12, "De_Jong_Function") {}
+    : separable_function(dimension, -5.12, 5.12, "De_Jong_Function", 0.0, 1.0) {}
+
+double pass::de_jong_function::term(const arma::uword, const double value) const
+{
+  return de_jong_term(value);
+}
 
-double pass::de_jong_function::evaluate(const arma::vec &agent) const
+double pass::de_jong_function::term_derivative(const arma::uword, const double value) const
 {
-  assert(agent.n_elem == dimension() &&
-         "`agent` has incompatible dimension");
-  return std::accumulate(agent.begin(), agent.end(), 0.0,
-                         [](const double sum, const double element) {
-                           return sum + std::pow(element, 2.0);
-                         });
+  return pass::derivative([](const pass::dual<1> &x) { return de_jong_term(x); }, value);
 }
@@ -1,4 +1,37 @@
 #include "pass_bits/problem/optimisation_benchmark/griewank_function.hpp"
+#include "pass_bits/helper/dual.hpp"
+
+namespace
+{
+/**
+ * The factor of the coordinate `index` of the product.
+ */
+double cosine_factor(const arma::uword index, const double value)
+{
+  return std::cos(value / std::sqrt(static_cast<double>(index) + 1.0));
+}
+
+/**
+ * The Griewank function of the `dimension` coordinates of `agent`, for any
+ * scalar type (see `pass::dual`).
+ */
+template <typename T>
+T griewank(const T *agent, const arma::uword dimension)
+{
+  using std::cos;
+
+  T product = 1.0;
+  T sum = 0.0;
+
+  for (arma::uword i = 0; i < dimension; ++i)
+  {
+    sum = sum + agent[i] * agent[i];
+    product = product * cos(agent[i] / std::sqrt(static_cast<double>(i) + 1.0));
+  }
+
+  return sum / 4000.0 - product + 1.0;
+}
+} // namespace
 
 pass::griewank_function::griewank_function(const arma::uword dimension)
     : problem(dimension, -600.00, 600.00, "Griewank_Function") {}
@@ -7,15 +40,142 @@ double pass::griewank_function::evaluate(const arma::vec &agent) const
 {
   assert(agent.n_elem == dimension() &&
          "`agent` has incompatible dimension");
+  return griewank(agent.memptr(), dimension());
+}
 
-  double product = 1.0;
-  double sum = 0.0;
+bool pass::griewank_function::has_gradient() const
+{
+  return true;
+}
 
-  for (arma::uword i = 0; i < agent.n_elem; ++i)
+arma::vec pass::griewank_function::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  forward_gradient([this](const gradient_dual *x) { return griewank(x, dimension()); },
+                   agent.memptr(), dimension(), gradient.memptr());
+  return gradient;
+}
+
+bool pass::griewank_function::has_delta_evaluation() const
+{
+  return true;
+}
+
+double pass::griewank_function::initialise_delta_state(const arma::vec &agent, delta_state &state) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  state.agent = agent;
+  state.partial_results = partial_results(agent);
+  state.updates = 0;
+  state.fitness_value = fitness_value(state.partial_results);
+  return state.fitness_value;
+}
+
+double pass::griewank_function::evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                               const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  arma::vec results = state.partial_results;
+  for (arma::uword n = 0; n < changed_indices.n_elem; ++n)
   {
-    sum = sum + agent(i) * agent(i);
-    product = product * std::cos(agent(i) / std::sqrt(static_cast<double>(i) + 1.0));
+    replace(results, changed_indices(n), state.agent(changed_indices(n)), new_values(n));
   }
+  return fitness_value(results);
+}
 
-  return sum / 4000.0 - product + 1.0;
+void pass::griewank_function::update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                                 const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  for (arma::uword n = 0; n < changed_indices.n_elem; ++n)
+  {
+    const arma::uword index = changed_indices(n);
+    replace(state.partial_results, index, state.agent(index), new_values(n));
+    state.agent(index) = new_values(n);
+  }
+
+  // Recomputed from scratch from time to time, so that rounding errors don't
+  // accumulate (see `separable_function::update_delta_state`)
+  state.updates += changed_indices.n_elem;
+  if (state.updates >= dimension())
+  {
+    state.partial_results = partial_results(state.agent);
+    state.updates = 0;
+  }
+
+  state.fitness_value = fitness_value(state.partial_results);
+}
+
+void pass::griewank_function::replace(arma::vec &results, const arma::uword index,
+                                      const double old_value, const double new_value) const
+{
+  results(0) += new_value * new_value - old_value * old_value;
+
+  const double old_factor = cosine_factor(index, old_value);
+  const double new_factor = cosine_factor(index, new_value);
+
+  if (old_factor == 0.0)
+  {
+    results(2) -= 1.0;
+  }
+  else
+  {
+    results(1) -= std::log(std::abs(old_factor));
+    results(3) -= old_factor < 0.0 ? 1.0 : 0.0;
+  }
+
+  if (new_factor == 0.0)
+  {
+    results(2) += 1.0;
+  }
+  else
+  {
+    results(1) += std::log(std::abs(new_factor));
+    results(3) += new_factor < 0.0 ? 1.0 : 0.0;
+  }
+}
+
+double pass::griewank_function::fitness_value(const arma::vec &results) const
+{
+  double product = 0.0;
+  if (results(2) == 0.0)
+  {
+    product = std::exp(results(1));
+    if (std::fmod(results(3), 2.0) != 0.0)
+    {
+      product = -product;
+    }
+  }
+
+  return results(0) / 4000.0 - product + 1.0;
+}
+
+arma::vec pass::griewank_function::partial_results(const arma::vec &agent) const
+{
+  arma::vec results(4, arma::fill::zeros);
+  for (arma::uword i = 0; i < agent.n_elem; ++i)
+  {
+    results(0) += agent(i) * agent(i);
+
+    const double factor = cosine_factor(i, agent(i));
+    if (factor == 0.0)
+    {
+      results(2) += 1.0;
+    }
+    else
+    {
+      results(1) += std::log(std::abs(factor));
+      results(3) += factor < 0.0 ? 1.0 : 0.0;
+    }
+  }
+  return results;
 }
@@ -1,17 +1,27 @@
 #include "pass_bits/problem/optimisation_benchmark/rastrigin_function.hpp"
 
+namespace
+{
+/**
+ * The term of a coordinate, for any scalar type (see `pass::dual`).
+ */
+template <typename T>
+T rastrigin_term(const T &value)
+{
+  using std::cos;
+  return value * value - 10.0 * cos(2.0 * arma::datum::pi * value);
+}
+} // namespace
+
 pass::rastrigin_function::rastrigin_function(const arma::uword dimension)
-    : problem(dimension, -5.12, 5.12, "Rastrigin_Function") {}
+    : separable_function(dimension, -5.12, 5.12, "Rastrigin_Function", 10.0 * dimension, 1.0) {}
+
+double pass::rastrigin_function::term(const arma::uword, const double value) const
+{
+  return rastrigin_term(value);
+}
 
-double pass::rastrigin_function::evaluate(const arma::vec &agent) const
+double pass::rastrigin_function::term_derivative(const arma::uword, const double value) const
 {
-  assert(agent.n_elem == dimension() &&
-         "`agent` has incompatible dimension");
-  return 10.0 * dimension() +
-         std::accumulate(agent.cbegin(), agent.cend(), 0.0,
-                         [](const double sum, const double element) {
-                           return sum + std::pow(element, 2.0) -
-                                  10.0 *
-                                      std::cos(2.0 * arma::datum::pi * element);
-                         });
+  return pass::derivative([](const pass::dual<1> &x) { return rastrigin_term(x); }, value);
 }
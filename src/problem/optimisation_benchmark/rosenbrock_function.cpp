@@ -1,4 +1,25 @@
 #include "pass_bits/problem/optimisation_benchmark/rosenbrock_function.hpp"
+#include "pass_bits/helper/dual.hpp"
+
+namespace
+{
+/**
+ * The Rosenbrock function of the `dimension` coordinates of `agent`, for any
+ * scalar type (see `pass::dual`).
+ */
+template <typename T>
+T rosenbrock(const T *agent, const arma::uword dimension)
+{
+  T sum = 0.0;
+  for (arma::uword n = 0; n + 1 < dimension; ++n)
+  {
+    const T valley = agent[n + 1] - agent[n] * agent[n];
+    const T distance = agent[n] - 1.0;
+    sum += 100.0 * (valley * valley) + distance * distance;
+  }
+  return sum;
+}
+} // namespace
 
 pass::rosenbrock_function::rosenbrock_function(const arma::uword dimension)
     : problem(dimension, -2.048, 2.048, "Rosenbrock_Function") {}
@@ -7,11 +28,21 @@ double pass::rosenbrock_function::evaluate(const arma::vec &agent) const
 {
   assert(agent.n_elem == dimension() &&
          "`agent` has incompatible dimension");
-  return std::inner_product(
-      agent.cbegin(), std::prev(agent.cend(), 1),
-      std::next(agent.cbegin(), 1), 0.0, std::plus<double>(),
-      [](const double element, const double other_element) {
-        return 100.0 * std::pow(other_element - std::pow(element, 2.0), 2.0) +
-               std::pow(element - 1.0, 2.0);
-      });
+  return rosenbrock(agent.memptr(), dimension());
+}
+
+bool pass::rosenbrock_function::has_gradient() const
+{
+  return true;
+}
+
+arma::vec pass::rosenbrock_function::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  forward_gradient([this](const gradient_dual *x) { return rosenbrock(x, dimension()); },
+                   agent.memptr(), dimension(), gradient.memptr());
+  return gradient;
 }
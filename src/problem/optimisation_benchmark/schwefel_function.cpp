@@ -1,16 +1,29 @@
 #include "pass_bits/problem/optimisation_benchmark/schwefel_function.hpp"
 
+namespace
+{
+/**
+ * The term of a coordinate, for any scalar type (see `pass::dual`).
+ */
+template <typename T>
+T schwefel_term(const T &value)
+{
+  using std::abs;
+  using std::sin;
+  using std::sqrt;
+  return value * sin(sqrt(abs(value)));
+}
+} // namespace
+
 pass::schwefel_function::schwefel_function(const arma::uword dimension)
-    : problem(dimension, -500.0, 500.0, "Schwefel_Function") {}
+    : separable_function(dimension, -500.0, 500.0, "Schwefel_Function", 418.9828872724338 * dimension, -1.0) {}
+
+double pass::schwefel_function::term(const arma::uword, const double value) const
+{
+  return schwefel_term(value);
+}
 
-double pass::schwefel_function::evaluate(const arma::vec &agent) const
+double pass::schwefel_function::term_derivative(const arma::uword, const double value) const
 {
-  assert(agent.n_elem == dimension() &&
-         "`agent` has incompatible dimension");
-  return 418.9828872724338 * dimension() -
-         std::accumulate(agent.cbegin(), agent.cend(), 0.0,
-                         [](const double sum, const double element) {
-                           return sum + element *
-                                            std::sin(std::sqrt(std::abs(element)));
-                         });
+  return pass::derivative([](const pass::dual<1> &x) { return schwefel_term(x); }, value);
 }
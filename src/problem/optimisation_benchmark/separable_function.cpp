@@ -0,0 +1,105 @@
+#include "pass_bits/problem/optimisation_benchmark/separable_function.hpp"
+
+pass::separable_function::separable_function(const arma::uword dimension, const double lower_bound,
+                                             const double upper_bound, const std::string &name,
+                                             const double offset, const double scale)
+    : problem(dimension, lower_bound, upper_bound, name),
+      offset(offset),
+      scale(scale)
+{
+}
+
+double pass::separable_function::evaluate(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  return offset + scale * sum_of_terms(agent);
+}
+
+bool pass::separable_function::has_delta_evaluation() const
+{
+  return true;
+}
+
+double pass::separable_function::initialise_delta_state(const arma::vec &agent, delta_state &state) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  state.agent = agent;
+  state.partial_results = {sum_of_terms(agent)};
+  state.updates = 0;
+  state.fitness_value = offset + scale * state.partial_results(0);
+  return state.fitness_value;
+}
+
+double pass::separable_function::evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                                const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  double sum = state.partial_results(0);
+  for (arma::uword n = 0; n < changed_indices.n_elem; ++n)
+  {
+    const arma::uword index = changed_indices(n);
+    sum += term(index, new_values(n)) - term(index, state.agent(index));
+  }
+  return offset + scale * sum;
+}
+
+void pass::separable_function::update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                                  const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  double sum = state.partial_results(0);
+  for (arma::uword n = 0; n < changed_indices.n_elem; ++n)
+  {
+    const arma::uword index = changed_indices(n);
+    sum += term(index, new_values(n)) - term(index, state.agent(index));
+    state.agent(index) = new_values(n);
+  }
+
+  // After as many updates as there are coordinates, the sum is recomputed, so
+  // that rounding errors don't accumulate. This costs O(1) per update on average.
+  state.updates += changed_indices.n_elem;
+  if (state.updates >= dimension())
+  {
+    sum = sum_of_terms(state.agent);
+    state.updates = 0;
+  }
+
+  state.partial_results(0) = sum;
+  state.fitness_value = offset + scale * sum;
+}
+
+bool pass::separable_function::has_gradient() const
+{
+  return true;
+}
+
+arma::vec pass::separable_function::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  for (arma::uword n = 0; n < dimension(); ++n)
+  {
+    gradient(n) = scale * term_derivative(n, agent(n));
+  }
+  return gradient;
+}
+
+double pass::separable_function::sum_of_terms(const arma::vec &agent) const
+{
+  double sum = 0.0;
+  for (arma::uword n = 0; n < agent.n_elem; ++n)
+  {
+    sum += term(n, agent(n));
+  }
+  return sum;
+}
@@ -1,15 +1,27 @@
 #include "pass_bits/problem/optimisation_benchmark/styblinski_tang_function.hpp"
 
+namespace
+{
+/**
+ * The term of a coordinate, for any scalar type (see `pass::dual`).
+ */
+template <typename T>
+T styblinski_tang_term(const T &value)
+{
+  using std::pow;
+  return pow(value, 4.0) - 16.0 * pow(value, 2.0) + 5.0 * value;
+}
+} // namespace
+
 pass::styblinski_tang_function::styblinski_tang_function(const arma::uword dimension)
-    : problem(dimension, -5.0, 5.0, "Styblinski_Tang_Function") {}
+    : separable_function(dimension, -5.0, 5.0, "Styblinski_Tang_Function", 0.0, 0.5) {}
+
+double pass::styblinski_tang_function::term(const arma::uword, const double value) const
+{
+  return styblinski_tang_term(value);
+}
 
-double pass::styblinski_tang_function::evaluate(const arma::vec &agent) const
+double pass::styblinski_tang_function::term_derivative(const arma::uword, const double value) const
 {
-  assert(agent.n_elem == dimension() &&
-         "`agent` has incompatible dimension");
-  return 0.5 *
-         std::accumulate(agent.cbegin(), agent.cend(), 0.0,
-                         [](const double sum, const double element) {
-                           return sum + std::pow(element, 4) - 16 * std::pow(element, 2) + 5 * element;
-                         });
+  return pass::derivative([](const pass::dual<1> &x) { return styblinski_tang_term(x); }, value);
 }
@@ -1,19 +1,29 @@
 #include "pass_bits/problem/optimisation_benchmark/sum_of_different_powers_function.hpp"
 
+namespace
+{
+/**
+ * The term of a coordinate, for any scalar type (see `pass::dual`).
+ */
+template <typename T>
+T sum_of_different_powers_term(const arma::uword index, const T &value)
+{
+  using std::fabs;
+  using std::pow;
+  return pow(fabs(value), static_cast<double>(index + 2));
+}
+} // namespace
+
 pass::sum_of_different_powers_function::sum_of_different_powers_function(
     const arma::uword dimension)
-    : problem(dimension, -1.0, 1.0, "Sum_Of_Different_Powers_Function") {}
+    : separable_function(dimension, -1.0, 1.0, "Sum_Of_Different_Powers_Function", 0.0, 1.0) {}
 
-double pass::sum_of_different_powers_function::evaluate(
-    const arma::vec &agent) const
+double pass::sum_of_different_powers_function::term(const arma::uword index, const double value) const
 {
-  assert(agent.n_elem == dimension() &&
-         "`agent` has incompatible dimension");
+  return sum_of_different_powers_term(index, value);
+}
 
-  double sum = 0.0;
-  for (std::size_t n = 0; n < dimension(); ++n)
-  {
-    sum += std::pow(std::fabs(agent(n)), n + 2);
-  }
-  return sum;
+double pass::sum_of_different_powers_function::term_derivative(const arma::uword index, const double value) const
+{
+  return pass::derivative([index](const pass::dual<1> &x) { return sum_of_different_powers_term(index, x); }, value);
 }
@@ -1,6 +1,31 @@
 #include "pass_bits/problem/space_mission/gtoc1.hpp"
 #include "pass_bits/helper/astro_problems/astro_helpers.hpp"
+#include "pass_bits/helper/astro_problems/lambert_solver.hpp"
 #include "pass_bits/helper/astro_problems/vector3d_helpers.hpp"
+#include <algorithm> // std::copy
+#include <limits>    // std::numeric_limits
+
+namespace
+{
+/**
+ * Tabulates `ephemeris`, which returns a tuple (position, velocity) for a MJD2000,
+ * for all dates within the bounds of `problem`.
+ */
+template <typename T>
+pass::ephemeris_table tabulate(const pass::gtoc1 &problem, const T &ephemeris)
+{
+  // The latest date is reached if the launch and all legs are as late as possible.
+  const double end = problem.upper_bounds(0) + arma::accu(problem.upper_bounds.tail(7));
+
+  return pass::ephemeris_table(
+      [ephemeris](const double mjd2000, double *r, double *v) {
+        const auto result = ephemeris(mjd2000);
+        std::copy(result.first.begin(), result.first.end(), r);
+        std::copy(result.second.begin(), result.second.end(), v);
+      },
+      problem.lower_bounds(0), end);
+}
+} // namespace
 
 pass::gtoc1::gtoc1()
     : problem({3000, 14, 14, 14, 14, 100, 366, 300},
@@ -17,83 +42,140 @@ pass::gtoc1::gtoc1()
            0.0}),
       Isp(2500.0),
       mass(1500.0),
-      DVlaunch(2.5) {}
+      DVlaunch(2.5),
+      tabulated_destination(destination),
+      destination_ephemeris(tabulate(*this, [body = destination](const double mjd2000) {
+        return body.ephemeris(mjd2000 + 2451544.5);
+      }))
+{
+  for (const celestial_body *body : sequence)
+  {
+    if (planet_ephemerides.count(body) == 0)
+    {
+      planet_ephemerides.emplace(body, tabulate(*this, [body](const double mjd2000) {
+                                   return body->ephemeris(mjd2000);
+                                 }));
+    }
+  }
+}
 
 double pass::gtoc1::evaluate(const arma::vec &agent) const
 {
   assert(agent.n_elem == dimension() &&
          "`agent` has incompatible dimension");
 
-  std::array<double, 6> rp{};
-  std::array<double, 8> DV{};
   const int n = 8;
 
-  const double g = 9.80665 / 1000.0; // Gravity
-
   // r and  v in heliocentric coordinate system
-  // position
-  std::array<std::array<double, 3>, 8> r;
-  // velocity
-  std::array<std::array<double, 3>, 8> v;
+  states r;
+  states v;
+  std::array<double, n - 1> time_of_flight;
+  std::array<bool, n - 1> long_way;
+  legs(agent.memptr(), r, v, time_of_flight.data(), long_way.data());
+
+  // The legs only depend on the ephemerides, so all Lambert arcs are solved
+  // together, from flat arrays with 3 values per leg.
+  std::array<double, 3 * (n - 1)> departure_position;
+  std::array<double, 3 * (n - 1)> arrival_position;
+  for (int i = 0; i < n - 1; ++i)
+  {
+    std::copy(r[i].begin(), r[i].end(), departure_position.data() + 3 * i);
+    std::copy(r[i + 1].begin(), r[i + 1].end(), arrival_position.data() + 3 * i);
+  }
+
+  std::array<double, 3 * (n - 1)> departure_velocity;
+  std::array<double, 3 * (n - 1)> arrival_velocity;
+  std::array<lambert_error, n - 1> errors;
+  solve_lambert(departure_position.data(), arrival_position.data(), time_of_flight.data(),
+                long_way.data(), celestial_body::SUN.mu, n - 1, departure_velocity.data(),
+                arrival_velocity.data(), errors.data());
+
+  return objective(v, departure_velocity.data(), arrival_velocity.data(), errors.data());
+}
+
+void pass::gtoc1::legs(const double *agent, states &r, states &v,
+                       double *time_of_flight, bool *long_way) const
+{
+  const int n = 8;
 
+  double totalTime = 0;
+  for (size_t i = 0; i < 7; i++)
   {
-    double totalTime = 0;
-    for (size_t i = 0; i < 7; i++)
-    {
-      totalTime += agent[i];
-      auto result = sequence[i]->ephemeris(totalTime);
-      r[i] = result.first;
-      v[i] = result.second;
-    }
-    totalTime += agent[7];
-    auto result = destination.ephemeris(totalTime + 2451544.5);
-    r[7] = result.first;
-    v[7] = result.second;
+    totalTime += agent[i];
+    const auto table = planet_ephemerides.find(sequence[i]);
+    auto result = table != planet_ephemerides.end()
+                      ? table->second.ephemeris(totalTime)
+                      : sequence[i]->ephemeris(totalTime);
+    r[i] = result.first;
+    v[i] = result.second;
   }
+  totalTime += agent[7];
+  const bool is_tabulated = destination.keplerian == tabulated_destination.keplerian &&
+                            destination.epoch == tabulated_destination.epoch;
+  auto result = is_tabulated ? destination_ephemeris.ephemeris(totalTime)
+                             : destination.ephemeris(totalTime + 2451544.5);
+  r[7] = result.first;
+  v[7] = result.second;
 
-  std::array<double, 3> current_section_departure_velocity;
-  std::array<double, 3> current_section_arrival_velocity;
   for (size_t i = 0; i <= n - 2; i++)
   {
-    std::array<double, 3> last_section_arrival_velocity =
-        current_section_arrival_velocity;
+    time_of_flight[i] = agent[i + 1] * 24 * 60 * 60;
+    long_way[i] = pass::gtoc::cross_product(r[i], r[i + 1])[2] > 0
+                      ? rev_flag[i]
+                      : !rev_flag[i];
+  }
+}
 
-    bool longWay = pass::gtoc::cross_product(r[i], r[i + 1])[2] > 0
-                       ? rev_flag[i]
-                       : !rev_flag[i];
+double pass::gtoc1::objective(const states &v, const double *departure_velocity_values,
+                              const double *arrival_velocity_values,
+                              const lambert_error *errors) const
+{
+  std::array<double, 6> rp{};
+  std::array<double, 8> DV{};
+  const int n = 8;
 
-    const auto lambert_solution =
-        lambert(r[i], r[i + 1], agent[i + 1] * 24 * 60 * 60,
-                celestial_body::SUN.mu, longWay);
-    current_section_departure_velocity = lambert_solution.departure_velocity;
-    current_section_arrival_velocity = lambert_solution.arrival_velocity;
+  states departure_velocity;
+  states arrival_velocity;
+  for (int i = 0; i < n - 1; ++i)
+  {
+    std::copy(departure_velocity_values + 3 * i, departure_velocity_values + 3 * i + 3,
+              departure_velocity[i].begin());
+    std::copy(arrival_velocity_values + 3 * i, arrival_velocity_values + 3 * i + 3,
+              arrival_velocity[i].begin());
+  }
 
-    if (i == 0)
-    {
-      // Earth launch
-      DV[0] = pass::gtoc::norm(
-          pass::gtoc::sub(current_section_departure_velocity, v[0]));
-    }
-    else
+  const double g = 9.80665 / 1000.0; // Gravity
+
+  for (size_t i = 0; i <= n - 2; i++)
+  {
+    if (errors[i] != lambert_error::none)
     {
-      double Vin = pass::gtoc::norm(
-          pass::gtoc::sub(last_section_arrival_velocity, v[i]));
-      double Vout = pass::gtoc::norm(
-          pass::gtoc::sub(current_section_departure_velocity, v[i]));
-
-      // calculation of delta V at pericenter
-      const auto swing_by_solution = pow_swing_by_inv(
-          Vin, Vout,
-          acos(pass::gtoc::dot_product(
-                   pass::gtoc::sub(last_section_arrival_velocity, v[i]),
-                   pass::gtoc::sub(current_section_departure_velocity, v[i])) /
-               (Vin * Vout)));
-      DV[i] = swing_by_solution.first;
-      rp[i - 1] = swing_by_solution.second;
-      rp[i - 1] *= sequence[i]->mu;
+      return std::numeric_limits<double>::infinity();
     }
   }
 
+  // Earth launch
+  DV[0] = pass::gtoc::norm(pass::gtoc::sub(departure_velocity[0], v[0]));
+
+  for (size_t i = 1; i <= n - 2; i++)
+  {
+    double Vin = pass::gtoc::norm(
+        pass::gtoc::sub(arrival_velocity[i - 1], v[i]));
+    double Vout = pass::gtoc::norm(
+        pass::gtoc::sub(departure_velocity[i], v[i]));
+
+    // calculation of delta V at pericenter
+    const auto swing_by_solution = pow_swing_by_inv(
+        Vin, Vout,
+        acos(pass::gtoc::dot_product(
+                 pass::gtoc::sub(arrival_velocity[i - 1], v[i]),
+                 pass::gtoc::sub(departure_velocity[i], v[i])) /
+             (Vin * Vout)));
+    DV[i] = swing_by_solution.first;
+    rp[i - 1] = swing_by_solution.second;
+    rp[i - 1] *= sequence[i]->mu;
+  }
+
   double DVtot = std::accumulate<double *, double>(std::next(DV.begin()),
                                                    std::prev(DV.end()), 0);
 
@@ -113,9 +195,9 @@ double pass::gtoc1::evaluate(const arma::vec &agent) const
   double final_mass = mass * exp(-DVtot / (Isp * g));
 
   // arrival relative velocity at the asteroid;
-  auto arrival_velocity =
-      pass::gtoc::sub(v[n - 1], current_section_arrival_velocity);
+  auto relative_arrival_velocity =
+      pass::gtoc::sub(v[n - 1], arrival_velocity[n - 2]);
 
   return -final_mass *
-         fabs(pass::gtoc::dot_product(arrival_velocity, v[n - 1]));
+         fabs(pass::gtoc::dot_product(relative_arrival_velocity, v[n - 1]));
 }
@@ -0,0 +1,187 @@
+#include "pass_bits/problem/space_mission/mga_dsm_problem.hpp"
+#include <cstring>     // std::memcpy
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_trivially_copyable
+
+namespace
+{
+// A `mgadsmstate` is stored bytewise in the partial results of a delta state
+static_assert(std::is_trivially_copyable<mgadsmstate>::value, "`mgadsmstate` must be trivially copyable");
+const arma::uword state_size = (sizeof(mgadsmstate) + sizeof(double) - 1) / sizeof(double);
+
+void store_state(const mgadsmstate &mga_dsm_state, pass::problem::delta_state &state)
+{
+  state.partial_results.set_size(state_size);
+  std::memcpy(state.partial_results.memptr(), &mga_dsm_state, sizeof(mgadsmstate));
+}
+
+void load_state(const pass::problem::delta_state &state, mgadsmstate &mga_dsm_state)
+{
+  assert(state.partial_results.n_elem == state_size &&
+         "`state` wasn't initialised by an `mga_dsm_problem`");
+  std::memcpy(static_cast<void *>(&mga_dsm_state), state.partial_results.memptr(), sizeof(mgadsmstate));
+}
+} // namespace
+
+pass::mga_dsm_problem::mga_dsm_problem(const mission_description &mission)
+    : problem(mission.lower_bounds, mission.upper_bounds, mission.name),
+      mission(mission)
+{
+  const arma::uword n = mission.sequence.size();
+  if (n < 2 || dimension() != 4 * n - (mission.type == time2AUs ? 1 : 2))
+  {
+    throw std::invalid_argument("mga_dsm_problem: The bounds don't match the length of the fly-by sequence.");
+  }
+
+  mgadsmproblem mga_dsm;
+  mga_dsm.type = mission.type;
+  mga_dsm.sequence = mission.sequence;
+  mga_dsm.e = mission.e;
+  mga_dsm.rp = mission.rp;
+  mga_dsm.asteroid = mission.asteroid;
+  mga_dsm.AUdist = mission.AUdist;
+  mga_dsm.DVtotal = mission.DVtotal;
+  mga_dsm.DVonboard = mission.DVonboard;
+  mga_dsm.propagator = mission.propagator;
+
+  // The latest date is reached if the launch and all legs are as late as possible.
+  const double end = upper_bounds(0) + arma::accu(upper_bounds.subvec(4, n + 2));
+  mga_dsm.ephemerides = tabulate_ephemerides(mission, lower_bounds(0), end);
+
+  plan = compile_mga_dsm(mga_dsm);
+  low_fidelity_plan = plan;
+  low_fidelity_plan.fidelity = fidelity::low;
+}
+
+pass::mga_dsm_problem::mga_dsm_problem(const std::string &description)
+    : mga_dsm_problem(parse_mission_description(description))
+{
+}
+
+void pass::mga_dsm_problem::set_fidelity(const pass::fidelity level)
+{
+  plan.fidelity = level;
+}
+
+double pass::mga_dsm_problem::evaluate(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double obj = 0;
+
+  MGA_DSM(
+      /* INPUT values: */
+      agent.memptr(),
+      plan,
+
+      /* OUTPUT values: */
+      nullptr,
+      obj);
+
+  return obj;
+}
+
+double pass::mga_dsm_problem::evaluate(const arma::vec &agent, const double cutoff, bool &is_aborted) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double obj = 0;
+  is_aborted = MGA_DSM(agent.memptr(), plan, cutoff, obj) == 1;
+
+  return obj;
+}
+
+bool pass::mga_dsm_problem::has_delta_evaluation() const
+{
+  return true;
+}
+
+double pass::mga_dsm_problem::initialise_delta_state(const arma::vec &agent, delta_state &state) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  mgadsmstate mga_dsm_state;
+  double obj = 0;
+  MGA_DSM(agent.memptr(), plan, mga_dsm_state, obj);
+
+  state.agent = agent;
+  store_state(mga_dsm_state, state);
+  state.updates = 0;
+  state.fitness_value = obj;
+  return obj;
+}
+
+double pass::mga_dsm_problem::evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                             const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  arma::vec agent = state.agent;
+  agent.elem(changed_indices) = new_values;
+
+  // A copy, as `state` is shared between threads
+  mgadsmstate mga_dsm_state;
+  load_state(state, mga_dsm_state);
+  double obj = 0;
+  MGA_DSM(agent.memptr(), plan, mga_dsm_state, obj);
+
+  return obj;
+}
+
+void pass::mga_dsm_problem::update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                               const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  state.agent.elem(changed_indices) = new_values;
+
+  mgadsmstate mga_dsm_state;
+  load_state(state, mga_dsm_state);
+  double obj = 0;
+  MGA_DSM(state.agent.memptr(), plan, mga_dsm_state, obj);
+
+  store_state(mga_dsm_state, state);
+  state.fitness_value = obj;
+}
+
+bool pass::mga_dsm_problem::has_low_fidelity() const
+{
+  return true;
+}
+
+double pass::mga_dsm_problem::evaluate_low_fidelity(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double obj = 0;
+  MGA_DSM(agent.memptr(), low_fidelity_plan, nullptr, obj);
+
+  return obj;
+}
+
+bool pass::mga_dsm_problem::has_gradient() const
+{
+  return true;
+}
+
+arma::vec pass::mga_dsm_problem::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  forward_gradient(
+      [this](const gradient_dual *x) {
+        gradient_dual obj = 0.0;
+        MGA_DSM(x, plan, obj);
+        return obj;
+      },
+      agent.memptr(), dimension(), gradient.memptr());
+  return gradient;
+}
@@ -0,0 +1,207 @@
+#include "pass_bits/problem/space_mission/mga_problem.hpp"
+#include "pass_bits/helper/astro_problems/constants.hpp"
+#include <cstring>     // std::memcpy
+#include <stdexcept>   // std::invalid_argument
+#include <type_traits> // std::is_trivially_copyable
+
+namespace
+{
+// A `mgastate` is stored bytewise in the partial results of a delta state
+static_assert(std::is_trivially_copyable<mgastate>::value, "`mgastate` must be trivially copyable");
+const arma::uword state_size = (sizeof(mgastate) + sizeof(double) - 1) / sizeof(double);
+
+void store_state(const mgastate &mga_state, pass::problem::delta_state &state)
+{
+  state.partial_results.set_size(state_size);
+  std::memcpy(state.partial_results.memptr(), &mga_state, sizeof(mgastate));
+}
+
+void load_state(const pass::problem::delta_state &state, mgastate &mga_state)
+{
+  assert(state.partial_results.n_elem == state_size &&
+         "`state` wasn't initialised by an `mga_problem`");
+  std::memcpy(static_cast<void *>(&mga_state), state.partial_results.memptr(), sizeof(mgastate));
+}
+} // namespace
+
+pass::mga_problem::mga_problem(const mission_description &mission)
+    : problem(mission.lower_bounds, mission.upper_bounds, mission.name),
+      mission(mission)
+{
+  if (dimension() != mission.sequence.size())
+  {
+    throw std::invalid_argument("mga_problem: The bounds must contain the launch date and the duration of each leg.");
+  }
+
+  mgaproblem mga;
+  mga.type = mission.type;
+  mga.sequence = mission.sequence;
+  mga.rev_flag = mission.rev_flag;
+  mga.e = mission.e;
+  mga.rp = mission.rp;
+  mga.asteroid = mission.asteroid;
+  mga.Isp = mission.Isp;
+  mga.mass = mission.mass;
+  mga.DVlaunch = mission.DVlaunch;
+
+  // The latest date is reached if the launch and all legs are as late as possible.
+  const double end = upper_bounds(0) + arma::accu(upper_bounds.tail(dimension() - 1));
+  mga.ephemerides = tabulate_ephemerides(mission, lower_bounds(0), end);
+
+  plan = compile_mga(mga);
+  low_fidelity_plan = plan;
+  low_fidelity_plan.fidelity = fidelity::low;
+}
+
+pass::mga_problem::mga_problem(const std::string &description)
+    : mga_problem(parse_mission_description(description))
+{
+}
+
+double pass::mga_problem::evaluate(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double rp[max_sequence_length];
+  double Delta_V[max_sequence_length];
+  double obj = 0;
+
+  MGA(agent.memptr(), plan, rp, Delta_V, obj);
+
+  return obj;
+}
+
+double pass::mga_problem::evaluate(const arma::vec &agent, const double cutoff, bool &is_aborted) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double obj = 0;
+  is_aborted = MGA(agent.memptr(), plan, cutoff, obj) == 1;
+
+  return obj;
+}
+
+bool pass::mga_problem::has_delta_evaluation() const
+{
+  return true;
+}
+
+double pass::mga_problem::initialise_delta_state(const arma::vec &agent, delta_state &state) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  mgastate mga_state;
+  double obj = 0;
+  MGA(agent.memptr(), plan, mga_state, obj);
+
+  state.agent = agent;
+  store_state(mga_state, state);
+  state.updates = 0;
+  state.fitness_value = obj;
+  return obj;
+}
+
+double pass::mga_problem::evaluate_delta(const delta_state &state, const arma::uvec &changed_indices,
+                                         const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  arma::vec agent = state.agent;
+  agent.elem(changed_indices) = new_values;
+
+  // A copy, as `state` is shared between threads
+  mgastate mga_state;
+  load_state(state, mga_state);
+  double obj = 0;
+  MGA(agent.memptr(), plan, mga_state, obj);
+
+  return obj;
+}
+
+void pass::mga_problem::update_delta_state(delta_state &state, const arma::uvec &changed_indices,
+                                           const arma::vec &new_values) const
+{
+  assert(changed_indices.n_elem == new_values.n_elem &&
+         "`changed_indices` and `new_values` must have the same size");
+
+  state.agent.elem(changed_indices) = new_values;
+
+  mgastate mga_state;
+  load_state(state, mga_state);
+  double obj = 0;
+  MGA(state.agent.memptr(), plan, mga_state, obj);
+
+  store_state(mga_state, state);
+  state.fitness_value = obj;
+}
+
+bool pass::mga_problem::has_low_fidelity() const
+{
+  return true;
+}
+
+double pass::mga_problem::evaluate_low_fidelity(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  double rp[max_sequence_length];
+  double Delta_V[max_sequence_length];
+  double obj = 0;
+
+  MGA(agent.memptr(), low_fidelity_plan, rp, Delta_V, obj);
+
+  return obj;
+}
+
+bool pass::mga_problem::has_gradient() const
+{
+  return true;
+}
+
+arma::vec pass::mga_problem::gradient(const arma::vec &agent) const
+{
+  assert(agent.n_elem == dimension() &&
+         "`agent` has incompatible dimension");
+
+  arma::vec gradient(dimension());
+  forward_gradient(
+      [this](const gradient_dual *x) {
+        gradient_dual obj = 0.0;
+        MGA(x, plan, obj);
+        return obj;
+      },
+      agent.memptr(), dimension(), gradient.memptr());
+  return gradient;
+}
+
+void pass::mga_problem::set_fidelity(const pass::fidelity level)
+{
+  plan.fidelity = level;
+}
+
+void pass::mga_problem::use_porkchop_table(const std::size_t launch_points,
+                                           const std::size_t time_of_flight_points,
+                                           const std::string &cache_file)
+{
+  const mgaplan &compiled = plan;
+  plan.first_leg = std::make_shared<const porkchop_table>(
+      [&compiled](const double mjd2000, double *r, double *v) {
+        get_celobj_r_and_v(compiled, mjd2000, 0, r, v);
+      },
+      [&compiled](const double mjd2000, double *r, double *v) {
+        get_celobj_r_and_v(compiled, mjd2000, 1, r, v);
+      },
+      celestial_body::SUN.mu, lower_bounds(0), upper_bounds(0), lower_bounds(1), upper_bounds(1),
+      launch_points, time_of_flight_points, cache_file);
+  low_fidelity_plan.first_leg = plan.first_leg;
+}
+
+const mgaplan &pass::mga_problem::compiled_mission() const
+{
+  return plan;
+}